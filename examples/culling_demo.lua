@@ -0,0 +1,70 @@
+-- culling_demo.lua
+-- BVH frustum culling: only visible objects are copied into the instance batch.
+
+local screenWidth = 800
+local screenHeight = 450
+local camera = {
+    position = { x = 0.0, y = 8.0, z = 0.0 },
+    target = { x = 1.0, y = 8.0, z = 0.0 },
+    up = { x = 0.0, y = 1.0, z = 0.0 },
+    fovy = 60.0
+}
+
+local GRID = 100
+local objects = {}   -- id -> { x, y, z }
+local visible = {}   -- reused by rl.BvhCull
+local batch = nil
+
+local function setup()
+    batch = rl.LoadInstanceBatch(GRID * GRID)
+    local id = 1
+    for gx = 0, GRID - 1 do
+        for gz = 0, GRID - 1 do
+            local x = (gx - GRID / 2) * 2.0
+            local z = (gz - GRID / 2) * 2.0
+            objects[id] = { x = x, y = 0.5, z = z }
+            rl.BvhInsert(x - 0.5, 0.0, z - 0.5, x + 0.5, 1.0, z + 0.5, id)
+            id = id + 1
+        end
+    end
+end
+
+function draw()
+    if not batch then
+        setup()
+    end
+
+    local time = rl.GetTime()
+    camera.target.x = camera.position.x + math.cos(time * 0.3)
+    camera.target.z = camera.position.z + math.sin(time * 0.3)
+
+    local aspect = screenWidth / screenHeight
+    local proj = rl.MatrixPerspective(camera.fovy * (math.pi / 180.0), aspect, 0.1, 200.0)
+    local view = rl.MatrixLookAt(camera.position, camera.target, camera.up)
+
+    local count
+    visible, count = rl.BvhCull(view, proj, visible)
+    for i = 1, count do
+        local o = objects[visible[i]]
+        rl.SetInstance(batch, i, o.x, o.y, o.z, 1.0, 1.0, 1.0, 0.0, 80, 160, 220, 255)
+    end
+    rl.SetInstanceCount(batch, count)
+
+    local stats = rl.GetCullStats()
+    imgui.Begin("Culling")
+    imgui.Text(string.format("Objects: %d", stats.objects))
+    imgui.Text(string.format("Visible: %d  Culled: %d", stats.visible, stats.culled))
+    imgui.Text(string.format("Nodes tested: %d", stats.tested))
+    imgui.End()
+
+    rl.rlSetMatrixProjection(proj)
+    rl.rlSetMatrixModelview(view)
+    rl.DrawInstanceBatch(batch)
+end
+
+function cleanup()
+    if batch then
+        rl.UnloadInstanceBatch(batch)
+    end
+    rl.BvhClear()
+end
@@ -0,0 +1,30 @@
+-- frame_pacing.lua
+-- Switch pacing modes at runtime and compare the measured jitter.
+
+local modes = { "vsync", "novsync", "cap", "latelatch" }
+local capFps = 120.0
+
+function draw()
+    local current, fps = app.get_pacing()
+
+    imgui.Begin("Frame pacing")
+    for _, mode in ipairs(modes) do
+        if imgui.Button(mode) then
+            app.set_pacing(mode, capFps)
+        end
+    end
+    local newFps, changed = imgui.SliderFloat("Cap fps", capFps, 30.0, 240.0, "%.0f")
+    if changed then
+        capFps = newFps
+        if current == "cap" then
+            app.set_pacing("cap", capFps)
+        end
+    end
+
+    local stats = app.get_frame_stats()
+    imgui.Text(string.format("Mode: %s (%.0f fps cap)", current, fps))
+    imgui.Text(string.format("Frame: %.2f ms avg, %.2f min, %.2f max", stats.avgMs, stats.minMs, stats.maxMs))
+    imgui.Text(string.format("Jitter: %.3f ms  p99: %.2f ms", stats.jitterMs, stats.p99Ms))
+    imgui.Text(string.format("Latch to swap: %.2f ms", stats.latchMs))
+    imgui.End()
+end
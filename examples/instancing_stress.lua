@@ -0,0 +1,76 @@
+-- instancing_stress.lua
+-- 100k cubes drawn with one instanced draw call.
+-- run: ril examples/instancing_stress.lua
+
+local screenWidth = 800
+local screenHeight = 450
+local camera = {
+    position = { x = 120.0, y = 90.0, z = 120.0 },
+    target = { x = 0.0, y = 0.0, z = 0.0 },
+    up = { x = 0.0, y = 1.0, z = 0.0 },
+    fovy = 45.0
+}
+
+local GRID = 316 -- 316 * 316 ~= 100k cubes
+local SPACING = 0.6
+local batch = nil
+local visible = GRID * GRID
+local orbit = true
+local last_time = 0.0
+local frame_ms = 0.0
+
+local function build_grid()
+    batch = rl.LoadInstanceBatch(GRID * GRID)
+    local half = GRID * SPACING * 0.5
+    local i = 1
+    for gx = 0, GRID - 1 do
+        for gz = 0, GRID - 1 do
+            local x = gx * SPACING - half
+            local z = gz * SPACING - half
+            local h = 0.2 + 0.8 * (math.sin(gx * 0.1) * math.cos(gz * 0.1) * 0.5 + 0.5)
+            rl.SetInstance(batch, i, x, h * 0.5, z, 0.4, h, 0.4, (gx + gz) * 0.05,
+                (gx * 255) // GRID, 120, (gz * 255) // GRID, 255)
+            i = i + 1
+        end
+    end
+end
+
+function draw()
+    if not batch then
+        build_grid()
+    end
+
+    local time = rl.GetTime()
+    frame_ms = frame_ms * 0.9 + (time - last_time) * 1000.0 * 0.1
+    last_time = time
+
+    imgui.Begin("Instancing Stress")
+    imgui.Text(string.format("Frame: %.2f ms", frame_ms))
+    local count, capacity = rl.GetInstanceCount(batch)
+    imgui.Text(string.format("Instances: %d / %d", count, capacity))
+    local newVisible, changed = imgui.SliderFloat("Count", visible, 0, GRID * GRID, "%.0f")
+    if changed then
+        visible = math.floor(newVisible)
+        rl.SetInstanceCount(batch, visible)
+    end
+    if imgui.Button(orbit and "Stop orbit" or "Orbit") then
+        orbit = not orbit
+    end
+    imgui.End()
+
+    if orbit then
+        camera.position.x = math.cos(time * 0.2) * 170.0
+        camera.position.z = math.sin(time * 0.2) * 170.0
+    end
+
+    local aspect = screenWidth / screenHeight
+    rl.rlSetMatrixProjection(rl.MatrixPerspective(camera.fovy * (math.pi / 180.0), aspect, 0.1, 1000.0))
+    rl.rlSetMatrixModelview(rl.MatrixLookAt(camera.position, camera.target, camera.up))
+    rl.DrawInstanceBatch(batch)
+end
+
+function cleanup()
+    if batch then
+        rl.UnloadInstanceBatch(batch)
+    end
+end
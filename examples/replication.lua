@@ -0,0 +1,81 @@
+-- replication.lua
+-- Server and client world in one script, over loopback.
+-- Channel 0 carries deltas (unreliable), channel 1 the client's acks.
+local server, client = nil, nil
+local world, client_world = nil, nil
+local units = {}
+local events = {}
+local frame = 0
+local status = "Not started"
+
+local function define(w)
+    -- Same classes in the same order on both sides
+    return w:class({ { "x", "float", -512, 512, 16 }, { "y", "float", -512, 512, 16 }, { "hp", "u8" } })
+end
+
+function init()
+    enet.initialize()
+    server = enet.host_create({host = "127.0.0.1", port = 6790}, 8, 2, 0, 0)
+    client = enet.host_create(nil, 1, 2, 0, 0)
+    if not server or not client then
+        status = "Failed to create hosts"
+        return
+    end
+    world = repl.world(4096)
+    client_world = repl.world(4096)
+    local Unit = define(world)
+    define(client_world)
+    for i = 1, 1000 do
+        units[i] = world:spawn(Unit, { x = (i % 40) * 10 - 200, y = (i // 40) * 10 - 125, hp = 100 })
+    end
+
+    enet.host_set_handlers(server, {
+        connect = function(peer) world:add_peer(peer) end,     -- Worlds forget peers on disconnect
+        receive = function(peer, data, channel) world:ack(peer, tonumber(data)) end,
+    })
+    enet.host_set_handlers(client, {
+        connect = function(peer) status = "Connected" end,
+        receive = function(peer, view, channel)
+            local tick = client_world:apply(view, 1, events)
+            if tick then enet.peer_send(peer, 1, enet.packet_create(tostring(tick), 1)) end
+        end,
+        views = true,
+    })
+    enet.host_connect(client, {host = "127.0.0.1", port = 6790}, 2)
+    status = "Connecting..."
+end
+
+function draw()
+    imgui.Begin("Replication", nil, {})
+    imgui.Text(status)
+    if not server and imgui.Button("start") then
+        init()
+    end
+    if world then
+        -- A few units move each frame, the rest stay out of the deltas
+        frame = frame + 1
+        for i = 1, 20 do
+            local id = units[(frame * 20 + i) % #units + 1]
+            world:set(id, "x", world:get(id, "x") + 0.5)
+        end
+        if frame % 3 == 0 then world:tick(0) end
+
+        local s = world:stats()
+        imgui.Text(string.format("tick %d  objects %d  peers %d", s.tick, s.objects, s.peers))
+        imgui.Text(string.format("sent %d bytes, full snapshots %d bytes", s.sentBytes, s.fullBytes))
+        imgui.Text(string.format("client tick %d  updated %d", client_world:stats().tick, events.updated and events.updated.n or 0))
+    end
+    imgui.End()
+
+    if server then
+        enet.host_service_all(server)
+        enet.host_service_all(client)
+    end
+end
+
+function cleanup()
+    if client then enet.host_destroy(client) end
+    if server then enet.host_destroy(server) end
+    enet.deinitialize()
+    imgui.cleanup()
+end
@@ -0,0 +1,73 @@
+-- schema_bench.lua
+-- Messages/second of schema pack/unpack against string.pack/unpack for
+-- the same player state message.
+-- run: ril examples/schema_bench.lua  (or --headless --frames 1)
+
+local N = 200000
+
+local player = schema.compile({
+    { "id", "u16" },
+    { "x", "f32" },
+    { "y", "f32" },
+    { "z", "f32" },
+    { "yaw", "i16" },
+    { "health", "u8" },
+    { "alive", "bool" },
+    { "name", "lstring" },
+})
+local FORMAT = "<I2fffi2I1Bs1"
+
+local msg = { id = 42, x = 1.5, y = -3.25, z = 10.0, yaw = -900, health = 87, alive = true, name = "player42" }
+local results = nil
+
+local function rate(fn)
+    local start = os.clock()
+    fn()
+    local elapsed = os.clock() - start
+    return elapsed > 0 and N / elapsed or 0
+end
+
+local function run()
+    local packed = player:pack_string(msg)
+    local packed_string = string.pack(FORMAT, msg.id, msg.x, msg.y, msg.z, msg.yaw, msg.health,
+        msg.alive and 1 or 0, msg.name)
+    local out = {}
+
+    results = {
+        { "schema pack_string", rate(function()
+            for _ = 1, N do player:pack_string(msg) end
+        end) },
+        { "string.pack", rate(function()
+            for _ = 1, N do
+                string.pack(FORMAT, msg.id, msg.x, msg.y, msg.z, msg.yaw, msg.health, msg.alive and 1 or 0, msg.name)
+            end
+        end) },
+        { "schema unpack (reused table)", rate(function()
+            for _ = 1, N do player:unpack(packed, 1, out) end
+        end) },
+        { "string.unpack into table", rate(function()
+            for _ = 1, N do
+                out.id, out.x, out.y, out.z, out.yaw, out.health, out.alive, out.name = string.unpack(FORMAT, packed_string)
+                out.alive = out.alive ~= 0
+            end
+        end) },
+    }
+    if enet then
+        table.insert(results, { "schema pack (pooled packet)", rate(function()
+            for _ = 1, N do enet.packet_destroy(player:pack(msg)) end
+        end) })
+    end
+    for _, r in ipairs(results) do
+        print(string.format("%-30s %10.0f msg/s", r[1], r[2]))
+    end
+end
+
+function draw()
+    if not results then run() end
+    imgui.Begin("Schema benchmark", nil, {})
+    imgui.Text(string.format("%d messages, %d bytes each", N, #player:pack_string(msg)))
+    for _, r in ipairs(results) do
+        imgui.Text(string.format("%-30s %10.0f msg/s", r[1], r[2]))
+    end
+    imgui.End()
+end
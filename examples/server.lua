@@ -2,6 +2,7 @@
 -- just test connect test only
 -- disconnnect not working
 local server = nil
+local players = nil
 
 function init()
     enet.initialize()
@@ -11,6 +12,21 @@ function init()
         return
     end
     print("Server started on 127.0.0.1:6789")
+    players = enet.group_create()
+    enet.host_set_handlers(server, {
+        connect = function(peer)
+            print("Client connected")
+            enet.group_add(players, peer)
+        end,
+        disconnect = function(peer) print("Client disconnected") end, -- groups forget the peer themselves
+        receive = function(peer, data, channel)
+            print("Received: " .. data)
+            -- Relay to everyone else, one packet for the whole group
+            enet.group_send(players, channel, enet.packet_create(data, 1), peer)
+        end,
+    })
+    -- Acks and resends run on the network thread, draw() takes ready batches
+    enet.host_start_thread(server)
 end
 
 function draw()
@@ -22,17 +38,8 @@ function draw()
     imgui.End()
 
     if server then
-        local event = enet.host_service(server, 0)
-        if type(event) == "table" then
-            if event.type == enet.EVENT_TYPE_CONNECT then
-                print("Client connected")
-            elseif event.type == enet.EVENT_TYPE_DISCONNECT then
-                print("Client disconnected")
-            elseif event.type == enet.EVENT_TYPE_RECEIVE then
-                print("Received: " .. enet.packet_data(event.packet))
-                enet.packet_destroy(event.packet)
-            end
-        end
+        -- Everything that arrived since last frame, at most 2 ms of it
+        enet.host_service_all(server, { events = 1024, ms = 2 })
     end
 end
 
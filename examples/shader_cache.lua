@@ -0,0 +1,64 @@
+-- shader_cache.lua
+-- Two materials on one cached shader. Run twice: the second launch restores
+-- the program from shader_cache/ instead of compiling it.
+
+local vsCode = [[
+#version 330
+in vec3 vertexPosition;
+in vec4 vertexColor;
+uniform mat4 mvp;
+out vec4 fragColor;
+void main() {
+    fragColor = vertexColor;
+    gl_Position = mvp*vec4(vertexPosition, 1.0);
+}
+]]
+
+local fsCode = [[
+#version 330
+in vec4 fragColor;
+uniform vec4 tint;
+out vec4 finalColor;
+void main() {
+    finalColor = fragColor*tint;
+}
+]]
+
+local camera = rl.GetCamera()
+local shader = rl.LoadShaderCode(vsCode, fsCode)
+local shaderAgain = rl.LoadShaderCode(vsCode, fsCode) -- same program, counted as deduped
+local red = rl.Material(shader)
+red:SetFloat("tint", 1.0, 0.4, 0.4, 1.0)
+local blue = rl.Material(shaderAgain)
+blue:SetFloat("tint", 0.4, 0.4, 1.0, 1.0)
+
+local function quad(x)
+    rl.rlBegin(4) -- RL_TRIANGLES
+    rl.rlColor4ub(255, 255, 255, 255)
+    rl.rlVertex3f(x - 1, 0, -1); rl.rlVertex3f(x - 1, 0, 1); rl.rlVertex3f(x + 1, 0, 1)
+    rl.rlVertex3f(x + 1, 0, 1);  rl.rlVertex3f(x + 1, 0, -1); rl.rlVertex3f(x - 1, 0, -1)
+    rl.rlEnd()
+end
+
+function draw()
+    camera:Apply()
+    red:Begin()
+    quad(-1.5)
+    red:End()
+    blue:Begin()
+    quad(1.5)
+    blue:End()
+
+    local stats = rl.GetShaderCacheStats()
+    imgui.Begin("Shader cache")
+    imgui.Text(string.format("Programs: %d  Deduped: %d", stats.programs, stats.deduped))
+    imgui.Text(string.format("Compiled: %d (%.2f ms)", stats.compiled, stats.compileMs))
+    imgui.Text(string.format("From binary: %d (%.2f ms)  Rejected: %d", stats.binaryHits, stats.binaryMs, stats.binaryRejected))
+    imgui.Text(string.format("This shader from binary: %s", tostring(shader:IsFromBinary())))
+    imgui.End()
+end
+
+function cleanup()
+    shader:Unload()
+    shaderAgain:Unload()
+end
@@ -0,0 +1,16 @@
+// app_clock.h
+#ifndef APP_CLOCK_H
+#define APP_CLOCK_H
+
+#include <stdbool.h>
+
+// Frame clock read by main.c and rl.GetTime(). Real time by default; with a
+// fixed step every frame advances the clock by exactly that step, so runs
+// are reproducible (headless benchmarks).
+void app_clock_set_fixed(double step);  // step <= 0 = real time
+bool app_clock_is_fixed(void);
+double app_clock_now(void);
+void app_clock_advance(void);           // End of frame
+double app_clock_real(void);            // Always glfwGetTime()
+
+#endif
@@ -0,0 +1,47 @@
+// app_config.h
+#ifndef APP_CONFIG_H
+#define APP_CONFIG_H
+
+#include <stdbool.h>
+#include "frame_pacing.h"
+
+// Startup options from the command line: ril [options] [script.lua]
+typedef struct AppConfig {
+    const char *script;     // Lua script path
+    int batchBuffers;       // rlgl render batch buffer count (multi-buffering)
+    int batchElements;      // Quads per batch buffer
+    bool showOverlay;       // Perf overlay visible at start (F3 toggles)
+    bool profile;           // CPU profiler + its window at start (F4 toggles)
+    const char *shaderCache; // Program binary directory, NULL = disabled
+    const char *fontCache;  // Glyph table directory, NULL = disabled
+    const char *font;       // Default UI font file, NULL = built-in
+    double fontSize;
+    int imageBudget;        // imgui.Image texture cache in MB (LRU)
+    PacingMode pacing;      // vsync, novsync, cap, latelatch
+    double fpsCap;          // Target rate for the cap mode
+    bool idle;              // Event driven rendering when nothing changes
+    double idleTimeout;     // Longest idle wait in seconds
+    bool uiCache;           // Keep ImGui in a texture, redraw only on change
+    bool imguiGl3;          // Stock ImGui OpenGL3 renderer instead of the rlgl one
+    double uiRate;          // Max UI redraws per second, 0 = every change
+    int pipelineDepth;      // Frames in flight on the render thread, 0 = serial
+    double dynres;          // 3D pass frame time target in ms, 0 = fixed full resolution
+    int msaa;               // MSAA samples (window, or the top of the dynres ladder)
+    double minScale;        // Lowest dynres render scale
+    int width;              // Window / offscreen target size
+    int height;
+
+    // Headless benchmark run
+    bool headless;          // Hidden or surfaceless context, render into an FBO
+    int frames;             // Frames to run before exiting
+    double fixedStep;       // Simulated seconds per frame
+    const char *dumpDir;    // PNG output directory, NULL = no dumps
+    int dumpEvery;          // Dump every Nth frame
+    const char *reportPath; // JSON report file, NULL or "-" = stdout
+} AppConfig;
+
+void app_config_defaults(AppConfig *config);
+bool app_config_parse(AppConfig *config, int argc, char **argv);
+void app_config_print_usage(const char *exe);
+
+#endif
@@ -0,0 +1,43 @@
+// frame_pacing.h
+#ifndef FRAME_PACING_H
+#define FRAME_PACING_H
+
+#include <stdbool.h>
+
+typedef enum {
+    PACING_VSYNC = 0,       // Swap interval 1
+    PACING_NO_VSYNC,        // Swap interval 0, as fast as possible
+    PACING_CAP,             // Swap interval 0, hybrid sleep + spin to a target rate
+    PACING_LATE_LATCH       // Vsync, input poll + draw() delayed until just before the predicted swap
+} PacingMode;
+
+// Frame-to-frame timings over the last PACING_HISTORY frames
+typedef struct PacingStats {
+    int samples;
+    double avgMs;
+    double jitterMs;        // Standard deviation of the frame time
+    double minMs;
+    double maxMs;
+    double p99Ms;
+    double latchMs;         // Input latch to swap (average)
+} PacingStats;
+
+#define PACING_HISTORY 240
+
+void pacing_setup(double refreshHz);            // Monitor refresh rate, context current
+void pacing_cleanup(void);
+void pacing_set_mode(PacingMode mode, double fps);  // fps only used by PACING_CAP (<= 0 keeps current)
+PacingMode pacing_get_mode(void);
+double pacing_get_fps(void);
+int pacing_get_swap_interval(void);    // For the mode, 1 = vsync
+const char *pacing_mode_name(PacingMode mode);
+bool pacing_mode_from_name(const char *name, PacingMode *mode);
+
+void pacing_wait(void);         // Top of the frame, before input is polled
+void pacing_before_swap(void);
+void pacing_after_swap(void);
+void pacing_mark_idle(void);    // Frame started after an idle wait, keep it out of the stats
+void pacing_sleep(double seconds);  // Hybrid sleep + spin
+PacingStats pacing_get_stats(void);
+
+#endif
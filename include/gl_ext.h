@@ -0,0 +1,200 @@
+// gl_ext.h
+// OpenGL entry points rlgl does not expose, loaded once through the same
+// proc loader rlgl uses (glfwGetProcAddress). Missing functions stay NULL.
+#ifndef GL_EXT_H
+#define GL_EXT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(_WIN32)
+    #define GLEXT_CALL __stdcall
+#else
+    #define GLEXT_CALL
+#endif
+
+#ifndef GL_LINK_STATUS
+    #define GL_LINK_STATUS                  0x8B82
+#endif
+#ifndef GL_INFO_LOG_LENGTH
+    #define GL_INFO_LOG_LENGTH              0x8B84
+#endif
+#ifndef GL_VERTEX_SHADER
+    #define GL_VERTEX_SHADER                0x8B31
+#endif
+#ifndef GL_FRAGMENT_SHADER
+    #define GL_FRAGMENT_SHADER              0x8B30
+#endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+    #define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+    #define GL_PROGRAM_BINARY_LENGTH        0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+    #define GL_NUM_PROGRAM_BINARY_FORMATS   0x87FE
+#endif
+#ifndef GL_VENDOR
+    #define GL_VENDOR                       0x1F00
+#endif
+#ifndef GL_RENDERER
+    #define GL_RENDERER                     0x1F01
+#endif
+#ifndef GL_VERSION
+    #define GL_VERSION                      0x1F02
+#endif
+#ifndef GL_FRAMEBUFFER_BINDING
+    #define GL_FRAMEBUFFER_BINDING          0x8CA6
+#endif
+#ifndef GL_COLOR
+    #define GL_COLOR                        0x1800
+#endif
+#ifndef GL_READ_FRAMEBUFFER
+    #define GL_READ_FRAMEBUFFER             0x8CA8
+#endif
+#ifndef GL_DRAW_FRAMEBUFFER
+    #define GL_DRAW_FRAMEBUFFER             0x8CA9
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+    #define GL_COLOR_ATTACHMENT0            0x8CE0
+#endif
+#ifndef GL_FRAMEBUFFER
+    #define GL_FRAMEBUFFER                  0x8D40
+#endif
+#ifndef GL_RENDERBUFFER
+    #define GL_RENDERBUFFER                 0x8D41
+#endif
+#ifndef GL_DEPTH_ATTACHMENT
+    #define GL_DEPTH_ATTACHMENT             0x8D00
+#endif
+#ifndef GL_RGBA8
+    #define GL_RGBA8                        0x8058
+#endif
+#ifndef GL_DEPTH_COMPONENT24
+    #define GL_DEPTH_COMPONENT24            0x81A6
+#endif
+#ifndef GL_MAX_SAMPLES
+    #define GL_MAX_SAMPLES                  0x8D57
+#endif
+#ifndef GL_TEXTURE_2D
+    #define GL_TEXTURE_2D                   0x0DE1
+#endif
+#ifndef GL_COLOR_BUFFER_BIT
+    #define GL_COLOR_BUFFER_BIT             0x00004000
+#endif
+#ifndef GL_NEAREST
+    #define GL_NEAREST                      0x2600
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+    #define GL_SYNC_GPU_COMMANDS_COMPLETE   0x9117
+#endif
+#ifndef GL_TIMEOUT_IGNORED
+    #define GL_TIMEOUT_IGNORED              0xFFFFFFFFFFFFFFFFull
+#endif
+#ifndef GL_TIME_ELAPSED
+    #define GL_TIME_ELAPSED                 0x88BF
+#endif
+#ifndef GL_QUERY_RESULT
+    #define GL_QUERY_RESULT                 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+    #define GL_QUERY_RESULT_AVAILABLE       0x8867
+#endif
+#ifndef GL_ARRAY_BUFFER
+    #define GL_ARRAY_BUFFER                 0x8892
+#endif
+#ifndef GL_ELEMENT_ARRAY_BUFFER
+    #define GL_ELEMENT_ARRAY_BUFFER         0x8893
+#endif
+#ifndef GL_STREAM_DRAW
+    #define GL_STREAM_DRAW                  0x88E0
+#endif
+#ifndef GL_MAP_WRITE_BIT
+    #define GL_MAP_WRITE_BIT                0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_RANGE_BIT
+    #define GL_MAP_INVALIDATE_RANGE_BIT     0x0004
+#endif
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+    #define GL_MAP_UNSYNCHRONIZED_BIT       0x0020
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+    #define GL_PIXEL_UNPACK_BUFFER          0x88EC
+#endif
+#ifndef GL_MAP_INVALIDATE_BUFFER_BIT
+    #define GL_MAP_INVALIDATE_BUFFER_BIT    0x0008
+#endif
+#ifndef GL_TRIANGLES
+    #define GL_TRIANGLES                    0x0004
+#endif
+#ifndef GL_UNSIGNED_SHORT
+    #define GL_UNSIGNED_SHORT               0x1403
+#endif
+#ifndef GL_UNSIGNED_INT
+    #define GL_UNSIGNED_INT                 0x1405
+#endif
+
+typedef void *(*GlExtLoadProc)(const char *name);
+
+typedef struct GlExt {
+    // Programs
+    unsigned int (GLEXT_CALL *CreateProgram)(void);
+    void (GLEXT_CALL *DeleteProgram)(unsigned int program);
+    void (GLEXT_CALL *AttachShader)(unsigned int program, unsigned int shader);
+    void (GLEXT_CALL *DetachShader)(unsigned int program, unsigned int shader);
+    void (GLEXT_CALL *DeleteShader)(unsigned int shader);
+    void (GLEXT_CALL *BindAttribLocation)(unsigned int program, unsigned int index, const char *name);
+    void (GLEXT_CALL *LinkProgram)(unsigned int program);
+    void (GLEXT_CALL *GetProgramiv)(unsigned int program, unsigned int pname, int *params);
+    void (GLEXT_CALL *GetProgramInfoLog)(unsigned int program, int bufSize, int *length, char *infoLog);
+    void (GLEXT_CALL *ProgramParameteri)(unsigned int program, unsigned int pname, int value);
+    void (GLEXT_CALL *GetProgramBinary)(unsigned int program, int bufSize, int *length, unsigned int *binaryFormat, void *binary);
+    void (GLEXT_CALL *ProgramBinary)(unsigned int program, unsigned int binaryFormat, const void *binary, int length);
+
+    // State
+    void (GLEXT_CALL *GetIntegerv)(unsigned int pname, int *data);
+    const unsigned char *(GLEXT_CALL *GetString)(unsigned int name);
+    void (GLEXT_CALL *Finish)(void);
+    void (GLEXT_CALL *Flush)(void);
+
+    // Framebuffers
+    void (GLEXT_CALL *ClearBufferfv)(unsigned int buffer, int drawbuffer, const float *value);
+    void (GLEXT_CALL *GenFramebuffers)(int n, unsigned int *framebuffers);
+    void (GLEXT_CALL *DeleteFramebuffers)(int n, const unsigned int *framebuffers);
+    void (GLEXT_CALL *BindFramebuffer)(unsigned int target, unsigned int framebuffer);
+    void (GLEXT_CALL *FramebufferTexture2D)(unsigned int target, unsigned int attachment, unsigned int textarget, unsigned int texture, int level);
+    void (GLEXT_CALL *BlitFramebuffer)(int srcX0, int srcY0, int srcX1, int srcY1, int dstX0, int dstY0, int dstX1, int dstY1, unsigned int mask, unsigned int filter);
+    void (GLEXT_CALL *GenRenderbuffers)(int n, unsigned int *renderbuffers);
+    void (GLEXT_CALL *DeleteRenderbuffers)(int n, const unsigned int *renderbuffers);
+    void (GLEXT_CALL *BindRenderbuffer)(unsigned int target, unsigned int renderbuffer);
+    void (GLEXT_CALL *RenderbufferStorageMultisample)(unsigned int target, int samples, unsigned int internalformat, int width, int height);
+    void (GLEXT_CALL *FramebufferRenderbuffer)(unsigned int target, unsigned int attachment, unsigned int renderbuffertarget, unsigned int renderbuffer);
+
+    // Sync objects (GLsync), shared between contexts
+    void *(GLEXT_CALL *FenceSync)(unsigned int condition, unsigned int flags);
+    void (GLEXT_CALL *WaitSync)(void *sync, unsigned int flags, unsigned long long timeout);
+    void (GLEXT_CALL *DeleteSync)(void *sync);
+
+    // Buffers and draws
+    void (GLEXT_CALL *BindBuffer)(unsigned int target, unsigned int buffer);
+    void (GLEXT_CALL *BufferData)(unsigned int target, ptrdiff_t size, const void *data, unsigned int usage);
+    void *(GLEXT_CALL *MapBufferRange)(unsigned int target, ptrdiff_t offset, ptrdiff_t length, unsigned int access);
+    unsigned char (GLEXT_CALL *UnmapBuffer)(unsigned int target);
+    void (GLEXT_CALL *DrawElementsBaseVertex)(unsigned int mode, int count, unsigned int type, const void *indices, int basevertex);
+
+    // Queries (GL_TIME_ELAPSED needs GL 3.3 / ARB_timer_query)
+    void (GLEXT_CALL *GenQueries)(int n, unsigned int *ids);
+    void (GLEXT_CALL *DeleteQueries)(int n, const unsigned int *ids);
+    void (GLEXT_CALL *BeginQuery)(unsigned int target, unsigned int id);
+    void (GLEXT_CALL *EndQuery)(unsigned int target);
+    void (GLEXT_CALL *GetQueryObjectiv)(unsigned int id, unsigned int pname, int *params);
+    void (GLEXT_CALL *GetQueryObjectui64v)(unsigned int id, unsigned int pname, unsigned long long *params);
+} GlExt;
+
+extern GlExt glext;
+
+bool gl_ext_load(GlExtLoadProc load);   // After the context is current
+bool gl_ext_has_program_binary(void);   // Entry points present and at least one format
+const char *gl_ext_driver_string(void); // "vendor | renderer | version"
+
+#endif
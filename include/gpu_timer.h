@@ -0,0 +1,43 @@
+// gpu_timer.h
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <stdbool.h>
+
+// GL_TIME_ELAPSED queries around the passes of a frame. Every pass has
+// GPU_TIMER_BUFFERS query objects used round robin; results are collected
+// when GL_QUERY_RESULT_AVAILABLE says so, never waited for. A frame whose
+// queries are still in flight is simply not timed.
+typedef enum {
+    GPU_PASS_CLEAR = 0,
+    GPU_PASS_SCENE,         // 3D pass: default scene + batched Lua draws, up to the batch flush
+    GPU_PASS_UI,            // ImGui backend (or the cached UI layer)
+    GPU_PASS_SWAP,          // Work the driver queues for the present
+    GPU_PASS_COUNT
+} GpuPass;
+
+#define GPU_TIMER_BUFFERS 2
+#define GPU_TIMER_HISTORY 240
+
+typedef struct GpuPassStats {
+    int samples;
+    double lastMs;
+    double avgMs;
+    double p95Ms;
+    double maxMs;
+} GpuPassStats;
+
+bool gpu_timer_setup(void);         // After gl_ext_load, false = no timer queries
+bool gpu_timer_is_available(void);
+void gpu_timer_set_enabled(bool enabled);
+bool gpu_timer_is_enabled(void);
+void gpu_timer_begin_frame(void);   // Collects finished results, picks this frame's queries
+void gpu_timer_begin(GpuPass pass); // Passes must not overlap (one TIME_ELAPSED query at a time)
+void gpu_timer_end(GpuPass pass);
+const char *gpu_timer_pass_name(GpuPass pass);
+GpuPassStats gpu_timer_get_stats(GpuPass pass);
+const float *gpu_timer_get_history(GpuPass pass, int *count, int *offset);  // Ring in ms, offset = oldest
+int gpu_timer_get_skipped(void);    // Frames not timed because results were pending
+void gpu_timer_cleanup(void);       // Before rlglClose
+
+#endif
@@ -0,0 +1,40 @@
+// hash.h
+#ifndef HASH_H
+#define HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define HASH_FNV1A64_BASIS 0xcbf29ce484222325ULL
+
+// 64-bit FNV-1a, pass a previous result as seed to chain buffers
+static inline uint64_t hash_fnv1a64(const void *data, size_t size, uint64_t seed) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Word-at-a-time hash for large buffers (vertex data), much faster than
+// byte-wise FNV
+static inline uint64_t hash_mix64(const void *data, size_t size, uint64_t seed) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    uint64_t hash = seed ^ (size*0x9e3779b97f4a7c15ULL);
+    while (size >= 8) {
+        uint64_t k;
+        memcpy(&k, bytes, 8);
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        hash = (hash ^ k)*0x9e3779b97f4a7c15ULL;
+        hash ^= hash >> 29;
+        bytes += 8;
+        size -= 8;
+    }
+    return hash_fnv1a64(bytes, size, hash);
+}
+
+#endif
@@ -0,0 +1,16 @@
+// headless.h
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <stdbool.h>
+#include "app_config.h"
+
+// Offscreen benchmark run: render into an FBO on a hidden (or surfaceless)
+// context with a fixed clock, optionally dump PNGs, report timings as JSON.
+bool headless_begin(const AppConfig *config, int width, int height);   // After rlglInit
+bool headless_is_active(void);
+void headless_begin_frame(void);    // Binds the offscreen target
+bool headless_end_frame(void);      // Returns false once all frames ran
+void headless_end(void);            // Writes the report, frees the target
+
+#endif
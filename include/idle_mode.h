@@ -0,0 +1,26 @@
+// idle_mode.h
+#ifndef IDLE_MODE_H
+#define IDLE_MODE_H
+
+#include <stdbool.h>
+
+// Event driven rendering: when enabled the loop blocks in
+// glfwWaitEventsTimeout() until input arrives, a redraw is requested, an
+// animation deadline is pending or ImGui is busy (active item, text caret).
+typedef struct IdleStats {
+    bool enabled;
+    double timeout;     // Longest wait, scripts still get draw() at this rate
+    int waits;          // Frames that started with a blocking wait
+    int frames;         // Frames rendered
+} IdleStats;
+
+void idle_set_enabled(bool enabled, double timeout);    // timeout <= 0 keeps current
+bool idle_is_enabled(void);
+void idle_notify_input(void);           // From GLFW callbacks
+void idle_request_redraw(void);         // Render one more frame (any thread)
+void idle_animate_for(double seconds);  // Keep rendering until now + seconds
+bool idle_poll_events(void);            // Replaces glfwPollEvents(), true when it waited
+void idle_end_frame(void);              // After igRender(), reads ImGui activity
+IdleStats idle_get_stats(void);
+
+#endif
@@ -0,0 +1,32 @@
+// imgui_rlgl.h
+#ifndef IMGUI_RLGL_H
+#define IMGUI_RLGL_H
+
+#include <stdbool.h>
+#include "cimgui.h"
+
+// ImGui renderer on top of rlgl, replacing ImGui_ImplOpenGL3. Vertices and
+// indices stream into one persistent VBO/EBO pair: each frame appends at a
+// cursor with an unsynchronized mapping, and the buffer is orphaned only
+// when it wraps. Draws use a base vertex so lists share the buffers, the
+// texture is rebound only when it changes, and state is set once per
+// frame and handed back to rlgl's defaults afterwards.
+typedef struct ImguiRlglStats {
+    int drawCalls;          // Last frame
+    int textureBinds;       // Last frame
+    int orphans;            // Buffer orphans since start (wrap or growth)
+    int vertexBytes;        // Streamed last frame
+    int indexBytes;
+} ImguiRlglStats;
+
+bool imgui_rlgl_init(void);         // Instead of ImGui_ImplOpenGL3_Init, after shader_cache_setup
+bool imgui_rlgl_is_active(void);
+void imgui_rlgl_render(ImDrawData *drawData);
+ImguiRlglStats imgui_rlgl_get_stats(void);
+void imgui_rlgl_shutdown(void);     // Before shader_cleanup / rlglClose
+
+// Whichever renderer was initialized (rlgl or the OpenGL3 backend)
+void imgui_renderer_new_frame(void);
+void imgui_renderer_render(ImDrawData *drawData);
+
+#endif
@@ -0,0 +1,11 @@
+// module_app.h
+#ifndef MODULE_APP_H
+#define MODULE_APP_H
+
+#include <lua.h>
+
+// Global 'app' table: main loop settings (frame pacing, idle rendering)
+void app_init(void);
+void app_cleanup(void);
+
+#endif
@@ -0,0 +1,28 @@
+// module_batch.h
+#ifndef MODULE_BATCH_H
+#define MODULE_BATCH_H
+
+#include <lua.h>
+
+// Per-frame render batch counters
+typedef struct BatchStats {
+    int flushes;            // All batch submissions (explicit + internal)
+    int internalFlushes;    // Mid-frame flushes rlgl did itself: buffer full or state change
+    int vertices;           // Vertices submitted (internal flushes count what was pending at last sample)
+    int drawCalls;          // Draw calls issued by the batch
+} BatchStats;
+
+void batch_load(int bufferCount, int bufferElements);   // After rlglInit
+void batch_init(void);                                  // Lua bindings
+void batch_cleanup(void);
+
+void batch_begin_frame(void);
+void batch_end_frame(void);
+void batch_sample(void);    // Call after rlgl geometry to catch internal flushes
+void batch_flush(void);     // rlDrawRenderBatchActive() with accounting
+
+BatchStats batch_get_stats(void);   // Last completed frame
+int batch_get_buffer_count(void);
+int batch_get_buffer_elements(void);
+
+#endif
@@ -0,0 +1,54 @@
+// module_camera.h
+#ifndef MODULE_CAMERA_H
+#define MODULE_CAMERA_H
+
+#include <stdbool.h>
+#include <lua.h>
+#include "raymath.h"
+#include "module_culling.h"
+
+// Perspective camera with cached matrices. Setters only mark it dirty,
+// getters rebuild view/projection/view-projection once after a change.
+typedef struct CachedCamera {
+    Vector3 position;
+    Vector3 target;
+    Vector3 up;
+    float fovy;             // Degrees
+    float aspect;
+    float nearPlane;
+    float farPlane;
+    int viewportWidth;
+    int viewportHeight;
+
+    Matrix view;
+    Matrix projection;
+    Matrix viewProjection;  // MatrixMultiply(view, projection)
+    Matrix invViewProjection;
+    Frustum frustum;
+    unsigned int version;   // Bumped whenever the matrices are rebuilt
+    bool viewDirty;
+    bool projectionDirty;
+} CachedCamera;
+
+void camera_init(void);
+void camera_cleanup(void);
+
+void camera_setup(CachedCamera *camera, Vector3 position, Vector3 target, Vector3 up, float fovy);
+void camera_set_position(CachedCamera *camera, Vector3 position);
+void camera_set_target(CachedCamera *camera, Vector3 target);
+void camera_set_up(CachedCamera *camera, Vector3 up);
+void camera_set_fovy(CachedCamera *camera, float fovy);
+void camera_set_clip(CachedCamera *camera, float nearPlane, float farPlane);
+void camera_set_viewport(CachedCamera *camera, int width, int height);
+void camera_update(CachedCamera *camera);
+void camera_apply(CachedCamera *camera);     // rlSetMatrixProjection + rlSetMatrixModelview(view)
+void camera_screen_ray(CachedCamera *camera, float screenX, float screenY, Vector3 *origin, Vector3 *direction);
+
+// Camera owned by main.c, shared with Lua through rl.GetCamera()
+CachedCamera *camera_get_main(void);
+
+// Lua helpers for other modules: test returns NULL when the value is not a camera
+CachedCamera *camera_test_lua(lua_State *L, int index);
+CachedCamera *camera_check_lua(lua_State *L, int index);
+
+#endif
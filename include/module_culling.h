@@ -0,0 +1,54 @@
+// module_culling.h
+#ifndef MODULE_CULLING_H
+#define MODULE_CULLING_H
+
+#include <stdbool.h>
+#include <lua.h>
+#include "raymath.h"
+
+// Axis aligned bounding box
+typedef struct CullAABB {
+    Vector3 min;
+    Vector3 max;
+} CullAABB;
+
+// Six planes (a, b, c, d) with normals pointing inside: left, right, bottom, top, near, far
+typedef struct Frustum {
+    Vector4 planes[6];
+} Frustum;
+
+typedef enum {
+    FRUSTUM_OUTSIDE = 0,
+    FRUSTUM_INTERSECT,
+    FRUSTUM_INSIDE
+} FrustumResult;
+
+// Counters from the last cull pass plus tree maintenance totals
+typedef struct CullStats {
+    int objects;    // Objects in the BVH
+    int tested;     // Node boxes tested against the frustum
+    int culled;     // Objects rejected
+    int visible;    // Objects sent to the draw queue
+    int refits;     // Incremental refits since start
+    int reinserts;  // Leaf reinserts since start
+} CullStats;
+
+void culling_init(void);
+void culling_cleanup(void);
+
+Frustum frustum_from_matrix(Matrix viewProj);
+FrustumResult frustum_classify_aabb(const Frustum *frustum, CullAABB box);
+
+// Objects are addressed by handles (>= 1) that carry a generation, so a handle
+// kept after culling_remove is ignored instead of reaching a reused node.
+// userId is what lands in the visible list (0 = use the handle)
+int culling_insert(CullAABB box, int userId);
+void culling_move(int handle, CullAABB box);
+void culling_remove(int handle);
+void culling_clear(void);   // Removes every object, earlier handles stay invalid
+int culling_cull(const Frustum *frustum, const int **visible);
+// Closest userId hit by the ray (0 on a miss), direction must be normalized
+int culling_raycast(Vector3 origin, Vector3 direction, float maxDistance, float *distance);
+CullStats culling_get_stats(void);
+
+#endif
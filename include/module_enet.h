@@ -3,9 +3,27 @@
 #define MODULE_ENET_H
 
 #include <lua.h>
+#include <stddef.h>
+
+#define ENET_PACKET_MT "ENetPacket"
+#define ENET_VIEW_MT "ENetPacketView"
+
+typedef struct _ENetPacket ENetPacket;
+typedef struct _ENetPeer ENetPeer;
+
+// Borrowed bytes of a received packet, handed to receive handlers
+typedef struct PacketView {
+    const unsigned char *data;      // NULL once the handler returned
+    size_t length;
+} PacketView;
 
 void enet_init(void);
 void enet_update(void);//???
 void enet_cleanup(void);
 
-#endif
\ No newline at end of file
+// For other modules reading and producing packets (module_schema, module_replication)
+const unsigned char *enet_check_packet_bytes(lua_State *L, int idx, size_t *length);  // Packet or view, errors otherwise
+void enet_push_packet(lua_State *L, ENetPacket *packet);   // Lua owns it (__gc destroys)
+ENetPeer *enet_check_peer(lua_State *L, int idx);
+
+#endif
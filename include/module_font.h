@@ -0,0 +1,47 @@
+// module_font.h
+#ifndef MODULE_FONT_H
+#define MODULE_FONT_H
+
+#include <stdbool.h>
+#include "cimgui.h"
+
+// Font files are read and hashed on a worker thread and added to the ImGui
+// atlas between frames once they are in memory, so startup never waits on
+// disk. ImGui 1.92 rasterises glyphs on first use, which is what used to
+// hitch the first frames of a multilingual UI: the glyphs each font baked
+// per size are written to a table keyed by the font file hashes and the
+// ImGui version, and on the next launch those glyphs are baked ahead of use
+// within a small per-frame budget.
+#define FONT_MAX_FONTS 32
+#define FONT_MAX_SIZES 8            // Sizes remembered per font for the glyph table
+#define FONT_PREWARM_BUDGET_MS 1.0  // Glyph baking per frame
+
+// Totals since start
+typedef struct FontCacheStats {
+    int fonts;          // Added to the atlas
+    int pending;        // Still being read by the worker
+    int failed;
+    int tableHits;      // Glyph tables found on disk
+    int tablesSaved;
+    int prewarmed;      // Glyphs baked ahead of use
+    int prewarmLeft;
+    double loadMs;      // Worker time reading + hashing files
+    double prewarmMs;
+} FontCacheStats;
+
+// directory NULL disables the glyph tables, fonts still load in the background
+void font_cache_setup(const char *directory);
+
+// Queue a TTF/OTF file, returns an id (-1 when full). merge adds the glyphs
+// to the previously added font instead of creating a new one.
+int font_cache_load(const char *path, float size, bool merge);
+void font_cache_set_default(int id);        // io.FontDefault once loaded
+ImFont *font_cache_get(int id);             // NULL until loaded
+void font_cache_note_size(int id, float size);
+void font_cache_update(void);               // Between igRender and the next igNewFrame
+FontCacheStats font_cache_get_stats(void);
+
+void font_init(void);       // Lua bindings (imgui.LoadFont, imgui.PushFont, ...)
+void font_cleanup(void);    // Saves glyph tables, before cimgui_cleanup
+
+#endif
@@ -0,0 +1,43 @@
+// module_image.h
+#ifndef MODULE_IMAGE_H
+#define MODULE_IMAGE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Asynchronous textures for imgui.Image. Worker threads decode image files;
+// the main thread uploads the pixels a few rows at a time through a pixel
+// unpack buffer within a per-frame budget, so a large image never costs a
+// frame. Textures are kept in an LRU cache under a VRAM budget: the least
+// recently drawn images are unloaded first and decoded again on next use.
+#define IMAGE_WORKERS 2
+#define IMAGE_PBO_BYTES (2*1024*1024)       // Upload staging, also the per-frame byte cap
+#define IMAGE_UPLOAD_BUDGET_MS 1.0
+#define IMAGE_EVICT_MIN_FRAMES 8            // Not drawn for this long before it can go (frames in flight)
+
+typedef struct ImageCacheStats {
+    int images;             // Known handles
+    int ready;              // Resident textures
+    int pending;            // Queued, decoding or uploading
+    int failed;
+    int evictions;          // Since start
+    size_t vramBytes;
+    size_t budgetBytes;
+    int uploadedBytes;      // Last frame
+    double uploadMs;        // Last frame
+    double decodeMs;        // Worker total since start
+} ImageCacheStats;
+
+void image_cache_setup(size_t budgetBytes);     // After gl_ext_load
+void image_cache_set_budget(size_t budgetBytes);
+
+// Handles start at 1, the same path returns the same handle
+int image_cache_load(const char *path);
+unsigned int image_cache_use(int handle, int *width, int *height);   // Texture id, 0 until uploaded; marks it used
+void image_cache_update(void);      // Main thread, once per frame: uploads + eviction
+ImageCacheStats image_cache_get_stats(void);
+
+void image_init(void);      // Lua bindings (imgui.LoadImage, imgui.Image, ...)
+void image_cleanup(void);   // Before rlglClose, after the render thread stopped
+
+#endif
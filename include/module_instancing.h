@@ -0,0 +1,34 @@
+// module_instancing.h
+#ifndef MODULE_INSTANCING_H
+#define MODULE_INSTANCING_H
+
+#include <stdbool.h>
+#include <lua.h>
+
+// Per-instance data uploaded to the GPU (column-major transform + RGBA8 color)
+typedef struct InstanceData {
+    float transform[16];
+    unsigned char color[4];
+} InstanceData;
+
+typedef struct InstanceBatch {
+    unsigned int vaoId;         // VAO binding cube mesh + instance buffer
+    unsigned int instanceVboId; // Per-instance VBO (dynamic)
+    InstanceData *instances;    // CPU copy of instance data
+    int capacity;               // Max instances
+    int count;                  // Instances drawn
+    int dirtyMin;               // First instance needing upload (-1 = clean)
+    int dirtyMax;               // Last instance needing upload
+} InstanceBatch;
+
+void instancing_init(void);
+void instancing_cleanup(void);
+
+InstanceBatch *instancing_batch_create(int capacity);
+void instancing_batch_destroy(InstanceBatch *batch);
+void instancing_batch_set(InstanceBatch *batch, int index, float x, float y, float z,
+                          float width, float height, float length, float rotationY,
+                          unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+void instancing_batch_draw(InstanceBatch *batch);
+
+#endif
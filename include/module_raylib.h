@@ -3,8 +3,15 @@
 #define MODULE_RAYLIB_H
 
 #include <lua.h>
+#include "raymath.h"
 
 void raylib_init(void);
 int luaopen_raylib(lua_State *L);
 
+// Shared Lua <-> raymath helpers (tables with x/y/z and m0..m15 fields)
+void push_vector3(lua_State *L, Vector3 v);
+Vector3 get_vector3(lua_State *L, int index);
+void push_matrix(lua_State *L, Matrix m);
+Matrix get_matrix(lua_State *L, int index);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+// module_replication.h
+#ifndef MODULE_REPLICATION_H
+#define MODULE_REPLICATION_H
+
+#include <lua.h>
+
+// Delta-compressed state replication. A world holds replicated objects of
+// script-defined classes (typed, optionally quantised fields). Scripts only
+// set values; a value that changes after quantisation stamps its field with
+// the tick that will carry it. Every tick each peer gets one packet with the
+// objects created, destroyed or changed since the last tick that peer
+// acknowledged: a field bitmask per object plus the current values. Values
+// are absolute, so a delta applies to any client state at or after its
+// baseline, and lost packets only make the next deltas larger.
+//
+// Wire format, little-endian: varint tick, varint baseline (0 = none), then
+// records of varint (slot << 2 | kind). A create record carries the class
+// id, the spawn tick's age, the change tick minus the spawn tick and every
+// field; an update carries the change tick's age, a varint field mask and
+// the masked fields; a destroy carries nothing. Destroys are only sent for
+// objects spawned at or before the baseline, the client drops newer objects
+// that got no create record. Quantised floats use (bits + 7) / 8 bytes.
+#define REPL_MAX_FIELDS 32
+#define REPL_MAX_CLASSES 64
+#define REPL_NAME_MAX 32
+#define REPL_DEFAULT_OBJECTS 1024
+#define REPL_MAX_OBJECTS (1 << 20)
+
+typedef struct _ENetHost ENetHost;
+typedef struct _ENetPeer ENetPeer;
+
+void replication_forget_peer(ENetPeer *peer);   // Disconnect events, from module_enet
+void replication_forget_host(ENetHost *host);
+
+void replication_init(void);    // After enet_init
+void replication_cleanup(void);
+
+#endif
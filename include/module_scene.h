@@ -0,0 +1,26 @@
+// module_scene.h
+#ifndef MODULE_SCENE_H
+#define MODULE_SCENE_H
+
+#include <stdbool.h>
+#include <lua.h>
+#include "raymath.h"
+#include "module_culling.h"
+
+// Scene nodes are addressed by integer handles (>= 1), 0 = no node / root level.
+// Handles carry a generation, one kept after destroy no longer resolves.
+void scene_init(void);
+void scene_cleanup(void);
+
+int scene_create_node(int parent);
+void scene_destroy_node(int node);
+bool scene_set_parent(int node, int parent);
+void scene_set_position(int node, Vector3 position);
+void scene_set_rotation(int node, Vector3 rotation);   // Euler angles in radians
+void scene_set_scale(int node, Vector3 scale);
+int scene_set_bounds(int node, CullAABB localBounds, int userId);  // Returns BVH handle
+void scene_forget_bounds(void);                         // After culling_clear()
+int scene_update(void);                                 // Returns nodes recomputed
+const Matrix *scene_get_world(int node);
+
+#endif
@@ -0,0 +1,18 @@
+// module_schema.h
+#ifndef MODULE_SCHEMA_H
+#define MODULE_SCHEMA_H
+
+#include <lua.h>
+
+// Compiled message layouts. schema.compile() turns a Lua list of
+// { name, type } pairs into a C field descriptor once; pack/unpack then walk
+// the descriptor in C between Lua tables and packet bytes (little-endian,
+// the same encoding as the enet packet readers and writers).
+#define SCHEMA_MAX_FIELDS 64
+#define SCHEMA_NAME_MAX 32
+#define SCHEMA_PACK_RESERVE 64      // Extra room over the fixed size before growing
+
+void schema_init(void);     // After enet_init
+void schema_cleanup(void);
+
+#endif
@@ -0,0 +1,32 @@
+// module_shader.h
+#ifndef MODULE_SHADER_H
+#define MODULE_SHADER_H
+
+#include <stdbool.h>
+#include <lua.h>
+
+// Totals since start
+typedef struct ShaderCacheStats {
+    int programs;       // Live programs
+    int deduped;        // Loads served by an already linked program
+    int compiled;       // Programs compiled from source
+    int binaryHits;     // Programs restored from a cached binary
+    int binaryRejected; // Cached binaries the driver refused
+    int binarySaved;    // Binaries written to disk
+    double compileMs;   // Time spent compiling + linking
+    double binaryMs;    // Time spent restoring binaries
+} ShaderCacheStats;
+
+// directory NULL disables the on-disk binary cache (call after gl_ext_load)
+void shader_cache_setup(const char *directory);
+
+// Program ids are reference counted, the same sources return the same program
+unsigned int shader_cache_load(const char *vsCode, const char *fsCode);
+void shader_cache_release(unsigned int id);
+int *shader_cache_get_locs(unsigned int id);    // rlgl shader locations for rlSetShader()
+ShaderCacheStats shader_cache_get_stats(void);
+
+void shader_init(void);     // Lua bindings
+void shader_cleanup(void);  // Deletes whatever is still loaded
+
+#endif
@@ -0,0 +1,61 @@
+// net_thread.h
+#ifndef NET_THREAD_H
+#define NET_THREAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Dedicated network thread per ENet host. The thread owns the host: it runs
+// enet_host_service on its own cadence so acks, pings and resends go out on
+// time whatever the frame rate, and hands events to the main thread through
+// a lock-free queue. Sends and disconnects travel the other way through a
+// second queue. Received packets change owner with the event; the main
+// thread destroys them after use.
+//
+// Once a host is threaded the main thread must not call into ENet for it
+// (connect first, then start the thread).
+#define NET_THREAD_MAX_HOSTS 4
+#define NET_THREAD_EVENTS 4096          // Network -> main queue
+#define NET_THREAD_COMMANDS 4096        // Main -> network queue
+#define NET_THREAD_INTERVAL_MS 1        // Default enet_host_service timeout
+
+typedef struct _ENetHost ENetHost;
+typedef struct _ENetPeer ENetPeer;
+typedef struct _ENetPacket ENetPacket;
+typedef struct _ENetEvent ENetEvent;
+
+typedef struct NetThreadStats {
+    bool running;
+    int queuedEvents;
+    int queuedCommands;
+    int eventStalls;        // Times the event queue was full, the thread waited for the main thread
+    int sendsRejected;      // net_thread_send() calls that found the command queue full
+    int64_t loops;          // Service iterations since start
+} NetThreadStats;
+
+bool net_thread_start(ENetHost *host, int intervalMs);
+bool net_thread_is_running(ENetHost *host);
+bool net_thread_poll(ENetHost *host, ENetEvent *event);     // Main thread, false when empty
+
+// A send meant for one connection. The slot of a disconnected peer can be
+// reused by the network thread before the main thread sees the disconnect,
+// so targeted sends are dropped there when connectID no longer matches.
+typedef struct NetThreadTarget {
+    ENetPeer *peer;
+    uint32_t connectID;     // peer->connectID when the connection was made
+} NetThreadTarget;
+
+// Main thread, false when the queue is full (the caller keeps the packet)
+bool net_thread_send(ENetPeer *peer, uint8_t channelID, ENetPacket *packet);
+bool net_thread_send_to(NetThreadTarget target, uint8_t channelID, ENetPacket *packet);
+bool net_thread_disconnect(ENetPeer *peer, uint32_t data);
+bool net_thread_broadcast(ENetHost *host, uint8_t channelID, ENetPacket *packet);
+// One packet to many peers of the host; targets is a packet_pool_alloc()
+// array, taken over with the packet on success
+bool net_thread_fanout(ENetHost *host, uint8_t channelID, ENetPacket *packet, NetThreadTarget *targets, int count);
+
+void net_thread_stop(ENetHost *host);   // Joins, then frees undelivered packets
+NetThreadStats net_thread_get_stats(ENetHost *host);
+void net_thread_stop_all(void);         // Before enet_deinitialize
+
+#endif
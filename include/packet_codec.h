@@ -0,0 +1,58 @@
+// packet_codec.h
+#ifndef PACKET_CODEC_H
+#define PACKET_CODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Wire primitives shared by the packet readers/writers and schemas:
+// little-endian fixed size integers, unsigned LEB128 varints (at most 10
+// bytes) and zigzag for signed varints.
+#define PACKET_VARINT_MAX 10
+
+static inline uint64_t packet_load_le(const unsigned char *p, int size) {
+    uint64_t value = 0;
+    for (int i = size - 1; i >= 0; --i) value = (value << 8) | p[i];
+    return value;
+}
+
+static inline void packet_store_le(unsigned char *p, uint64_t value, int size) {
+    for (int i = 0; i < size; ++i, value >>= 8) p[i] = (unsigned char)value;
+}
+
+// Bytes written to p (room for PACKET_VARINT_MAX)
+static inline int packet_store_varint(unsigned char *p, uint64_t value) {
+    int count = 0;
+    do {
+        p[count] = (unsigned char)(value & 0x7f);
+        value >>= 7;
+        if (value) p[count] |= 0x80;
+        count++;
+    } while (value);
+    return count;
+}
+
+// Advances *at, false when truncated or too long
+static inline bool packet_load_varint(const unsigned char *data, size_t length, size_t *at, uint64_t *value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 7*PACKET_VARINT_MAX && *at < length; shift += 7) {
+        unsigned char byte = data[(*at)++];
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline uint64_t packet_zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t packet_unzigzag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+#endif
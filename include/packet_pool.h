@@ -0,0 +1,44 @@
+// packet_pool.h
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Size-class memory pool for ENet. packet_pool_install() routes ENet's
+// allocator callbacks here, so packets, payloads, commands and
+// acknowledgements come from free lists of 32 B .. 64 KB blocks (x2 steps)
+// instead of the system allocator; larger blocks (host peer arrays) go
+// straight to malloc. packet_pool_packet() wraps a pooled buffer in an
+// ENetPacket without a copy (ENET_PACKET_FLAG_NO_ALLOCATE) and returns it
+// to its free list when ENet destroys the packet. ENet allocates on the
+// network thread too, so the pool is locked.
+#define PACKET_POOL_CLASSES 12
+#define PACKET_POOL_MIN_BLOCK 32
+#define PACKET_POOL_MAX_FREE 256        // Cached blocks per class
+
+typedef struct _ENetPacket ENetPacket;
+
+typedef struct PacketPoolStats {
+    int64_t allocs;
+    int64_t frees;
+    int64_t reused;         // Allocs served from a free list
+    int64_t oversize;       // Allocs above the largest class, plain malloc
+    int outstanding;        // Blocks not returned yet (writers, packets in flight, ENet state)
+    size_t cachedBytes;     // Free list blocks
+} PacketPoolStats;
+
+bool packet_pool_install(void);     // ENet allocator callbacks, before enet_initialize
+
+void *packet_pool_alloc(size_t size, size_t *capacity);
+void *packet_pool_grow(void *data, size_t used, size_t size, size_t *capacity);    // Keeps data[0..used)
+void packet_pool_free(void *data);
+
+// Hands data over to a new packet; NULL on failure, data stays with the caller
+ENetPacket *packet_pool_packet(void *data, size_t length, uint32_t flags);
+
+PacketPoolStats packet_pool_get_stats(void);
+void packet_pool_cleanup(void);     // Frees the free lists, after Lua close (packet __gc)
+
+#endif
@@ -0,0 +1,50 @@
+// peer_group.h
+#ifndef PEER_GROUP_H
+#define PEER_GROUP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Peer groups for fan-out sends. A send queues one refcounted packet on
+// every member in C. Members subscribe to channels 0..31 through a mask;
+// sends on channel 32 and up reach every member.
+//
+// ENet packet refcounts are not atomic, so a packet is only shared by
+// peers serviced on the same thread. Members on hosts running their own
+// network thread get one copy per thread, queued to it in one command.
+// Groups forget peers on disconnect and when their host is destroyed; until
+// a threaded host's disconnect reaches the main thread, its thread drops
+// sends whose slot now holds another connection.
+#define PEER_GROUP_ALL_CHANNELS 0xffffffffu
+
+typedef struct _ENetHost ENetHost;
+typedef struct _ENetPeer ENetPeer;
+typedef struct _ENetPacket ENetPacket;
+
+typedef struct PeerGroupMember {
+    ENetPeer *peer;
+    uint32_t channels;      // Bit n = channel n
+    uint32_t connectID;     // Connection the peer held when added
+} PeerGroupMember;
+
+typedef struct PeerGroup {
+    PeerGroupMember *members;
+    int count;
+    int capacity;
+    struct PeerGroup *prev;     // Live groups, for peer_group_forget_*
+    struct PeerGroup *next;
+} PeerGroup;
+
+void peer_group_init(PeerGroup *group);
+void peer_group_free(PeerGroup *group);
+bool peer_group_add(PeerGroup *group, ENetPeer *peer, uint32_t channels);  // Updates the mask when present
+bool peer_group_remove(PeerGroup *group, ENetPeer *peer);
+void peer_group_clear(PeerGroup *group);
+
+// Takes the packet in every case, returns the number of peers it was queued for
+int peer_group_send(PeerGroup *group, uint8_t channelID, ENetPacket *packet, ENetPeer *except);
+
+void peer_group_forget_peer(ENetPeer *peer);
+void peer_group_forget_host(ENetHost *host);
+
+#endif
@@ -0,0 +1,12 @@
+// perf_overlay.h
+#ifndef PERF_OVERLAY_H
+#define PERF_OVERLAY_H
+
+#include <stdbool.h>
+
+void perf_overlay_set_visible(bool visible);
+void perf_overlay_toggle(void);
+bool perf_overlay_is_visible(void);
+void perf_overlay_draw(void);   // Call between igNewFrame() and igRender()
+
+#endif
@@ -0,0 +1,61 @@
+// profiler.h
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+
+// CPU profiler for the phases of the main loop plus custom C/Lua scopes.
+// A scope can be entered several times per frame, its times add up; at
+// profiler_frame() every scope hit this frame pushes one sample into its
+// ring of PROFILER_HISTORY frames. Disabled, PROFILE_BEGIN/END cost one
+// branch on a global.
+//
+//     static int scope = -1;
+//     if (scope < 0) scope = profiler_register("my system");
+//     PROFILE_BEGIN(scope);
+//     ...
+//     PROFILE_END(scope);
+#define PROFILER_MAX_SCOPES 32
+#define PROFILER_HISTORY 240
+
+// Built-in phases, registered by profiler_setup() in this order
+typedef enum {
+    PROF_EVENTS = 0,        // Poll / idle wait
+    PROF_NEW_FRAME,         // ImGui_Impl*_NewFrame + igNewFrame
+    PROF_DRAW,              // Lua draw() or the default UI
+    PROF_IMGUI_RENDER,      // igRender
+    PROF_SCENE,             // Camera / matrix setup and default 3D
+    PROF_FLUSH,             // batch_flush (rlDrawRenderBatchActive)
+    PROF_UI_RENDER,         // ImGui GL render (UI layer or pipeline hand-off)
+    PROF_SWAP,
+    PROF_BUILTIN_COUNT
+} ProfilerPhase;
+
+typedef struct ProfilerStats {
+    const char *name;
+    int samples;
+    double lastMs;
+    double avgMs;
+    double p50Ms;
+    double p95Ms;
+    double p99Ms;
+    double maxMs;
+} ProfilerStats;
+
+extern bool profiler_enabled;
+
+#define PROFILE_BEGIN(id) do { if (profiler_enabled) profiler_begin(id); } while (0)
+#define PROFILE_END(id)   do { if (profiler_enabled) profiler_end(id); } while (0)
+
+void profiler_setup(void);
+void profiler_set_enabled(bool enabled);
+int profiler_register(const char *name);    // Same name = same id, -1 when full
+int profiler_find(const char *name);        // -1 if unknown
+int profiler_get_scope_count(void);
+void profiler_begin(int id);
+void profiler_end(int id);
+void profiler_frame(void);                  // End of the loop iteration
+ProfilerStats profiler_get_stats(int id);
+const float *profiler_get_frame_history(int *count, int *offset);  // Frame times (ms), ring
+
+#endif
@@ -0,0 +1,46 @@
+// render_pipeline.h
+#ifndef RENDER_PIPELINE_H
+#define RENDER_PIPELINE_H
+
+#include <stdbool.h>
+#include "cimgui.h"
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+// Two stage frame pipeline. The main thread polls input, runs Lua draw()
+// and ImGui and renders the 3D pass into one of `depth` offscreen slots,
+// on a hidden context sharing objects with the window. A render thread
+// owning the window context presents a finished slot (blit, ImGui from a
+// copied ImDrawData, swap) while the main thread builds the next frame.
+//
+// Frame latency (input poll to swap return) is measured in both modes.
+#define PIPELINE_MAX_DEPTH 4
+#define PIPELINE_HISTORY 240
+
+typedef struct PipelineStats {
+    bool active;
+    int depth;              // Frames in flight, 0 = serial loop
+    int samples;
+    double latencyMs;       // Input poll to swap return, average
+    double latencyP99Ms;
+    double latencyMaxMs;
+    double buildMs;         // Main thread, slot acquired to submitted (smoothed)
+    double stallMs;         // Main thread waiting for a free slot (smoothed)
+    double presentMs;       // Render thread, slot taken to swap return (smoothed)
+} PipelineStats;
+
+// Before rlglInit, window context current. On success the build context is
+// current and the render thread waits; on failure nothing changed
+bool pipeline_setup(GLFWwindow *window, int depth);
+void pipeline_start(void);                  // After ImGui init, lets frames through to the render thread
+bool pipeline_is_active(void);
+void pipeline_acquire(void);                // Top of the frame, waits for a free slot
+void pipeline_mark_input(void);             // After events are polled
+void pipeline_begin_frame(int width, int height);   // Binds the slot's 3D target
+void pipeline_submit(ImDrawData *drawData); // Texture uploads + copy, hands the slot over
+void pipeline_mark_presented(void);         // Serial loop, after the swap
+PipelineStats pipeline_get_stats(void);
+void pipeline_stop(void);                   // Presents queued frames, joins the thread
+void pipeline_cleanup(void);                // After rlglClose, destroys the build context
+
+#endif
@@ -0,0 +1,46 @@
+// scene_scale.h
+#ifndef SCENE_SCALE_H
+#define SCENE_SCALE_H
+
+#include <stdbool.h>
+
+// Dynamic resolution for the 3D pass. With a target frame time set, the
+// scene renders into an offscreen target whose MSAA level and resolution
+// follow a quality ladder: samples are dropped first (4x, 2x, off at full
+// size), then the resolution in 10% steps down to the minimum scale. The
+// target is resolved and stretched over the output with linear filtering
+// before ImGui draws on top at native resolution.
+//
+// The controller reads the GPU time of the 3D pass (gpu_timer) or, when
+// timer queries are off, the CPU time from scene_scale_pass_begin to
+// scene_scale_end. Both cover only work the resolution can shrink: no ImGui
+// build, draw() logic or vsync/pacing waits. It steps down when the smoothed
+// time is over the target and back up once it is below 75% of it, at most
+// once every SCENE_SCALE_COOLDOWN frames.
+#define SCENE_SCALE_MAX_LEVELS 16
+#define SCENE_SCALE_COOLDOWN 30
+#define SCENE_SCALE_HEADROOM 0.75
+
+typedef struct SceneScaleStats {
+    bool enabled;
+    float scale;            // 3D target size / output size
+    int samples;            // MSAA samples of the 3D target (1 = off)
+    int width;              // 3D target size
+    int height;
+    int level;              // 0 = full quality
+    int levels;
+    double targetMs;
+    double measuredMs;      // Smoothed controller input
+    int changes;            // Level changes since start
+} SceneScaleStats;
+
+void scene_scale_setup(int maxSamples, float minScale);    // After gl_ext_load
+void scene_scale_set_target(double targetMs);   // <= 0 = off, the 3D pass renders into the output
+double scene_scale_get_target(void);
+void scene_scale_begin(int width, int height);  // Before the clear, binds the scaled target
+void scene_scale_pass_begin(void);              // Start of the 3D pass, for the CPU fallback timing
+void scene_scale_end(void);                     // After the 3D flush, composites into the output
+SceneScaleStats scene_scale_get_stats(void);
+void scene_scale_cleanup(void);                 // Before rlglClose
+
+#endif
@@ -0,0 +1,65 @@
+// spsc_queue.h
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Bounded lock-free ring for exactly one producer and one consumer thread.
+// Items are copied in and out by value; capacity is a power of two. Head
+// and tail sit on separate cache lines so the two sides don't false share.
+typedef struct SpscQueue {
+    _Alignas(64) atomic_size_t head;    // Next slot to pop, written by the consumer
+    _Alignas(64) atomic_size_t tail;    // Next slot to push, written by the producer
+    _Alignas(64) size_t mask;
+    size_t itemSize;
+    unsigned char *items;
+} SpscQueue;
+
+static inline bool spsc_init(SpscQueue *queue, size_t capacity, size_t itemSize) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    queue->items = (unsigned char *)malloc(size*itemSize);
+    if (!queue->items) return false;
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+    queue->mask = size - 1;
+    queue->itemSize = itemSize;
+    return true;
+}
+
+static inline void spsc_free(SpscQueue *queue) {
+    free(queue->items);
+    queue->items = NULL;
+}
+
+// Producer side, false when full
+static inline bool spsc_push(SpscQueue *queue, const void *item) {
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (tail - head > queue->mask) return false;
+    memcpy(queue->items + (tail & queue->mask)*queue->itemSize, item, queue->itemSize);
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+// Consumer side, false when empty
+static inline bool spsc_pop(SpscQueue *queue, void *item) {
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head == tail) return false;
+    memcpy(item, queue->items + (head & queue->mask)*queue->itemSize, queue->itemSize);
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return true;
+}
+
+// Either side, approximate while the other one runs
+static inline size_t spsc_size(SpscQueue *queue) {
+    return atomic_load_explicit(&queue->tail, memory_order_acquire) -
+           atomic_load_explicit(&queue->head, memory_order_acquire);
+}
+
+#endif
@@ -0,0 +1,32 @@
+// ui_layer.h
+#ifndef UI_LAYER_H
+#define UI_LAYER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "cimgui.h"
+
+// ImGui output cached in a texture. The draw data is fingerprinted every
+// frame; only a changed fingerprint re-renders ImGui into the texture,
+// otherwise last frame's texture is composited over the 3D scene.
+// With a refresh rate set, changes are also held back until 1/rate seconds
+// passed since the last redraw; the 3D pass still runs every frame.
+typedef struct UiLayerStats {
+    int frames;         // Frames composited
+    int redraws;        // Frames ImGui was rendered into the cache
+    int deferred;       // Changed frames held back by the refresh rate
+    bool cached;        // Last frame reused the cache
+    double hashMs;      // Fingerprint time, last frame
+} UiLayerStats;
+
+void ui_layer_set_enabled(bool enabled);    // Disabled = render ImGui directly
+bool ui_layer_is_enabled(void);
+void ui_layer_set_rate(double hz);          // <= 0 = redraw on every change
+double ui_layer_get_rate(void);
+void ui_layer_invalidate(void);             // Force a redraw (dynamic textures shown in ImGui)
+uint64_t ui_layer_fingerprint(ImDrawData *drawData);
+void ui_layer_render(ImDrawData *drawData, int width, int height);  // Replaces ImGui_ImplOpenGL3_RenderDrawData
+UiLayerStats ui_layer_get_stats(void);
+void ui_layer_cleanup(void);                // Before rlglClose
+
+#endif
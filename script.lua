@@ -4,15 +4,19 @@
 -- Global variables (mirroring C code)
 local screenWidth = 800
 local screenHeight = 450
-local camera = {
-    position = { x = 5.0, y = 5.0, z = 5.0 },
-    target = { x = 0.0, y = 0.0, z = 0.0 },
-    up = { x = 0.0, y = 1.0, z = 0.0 },
-    fovy = 45.0
-}
+-- Main camera, view/projection are cached in C and rebuilt only on change
+local camera = rl.GetCamera()
+camera:SetPosition(5.0, 5.0, 5.0)
+camera:SetTarget(0.0, 0.0, 0.0)
+camera:SetFovy(45.0)
 local cubePosition = { x = 0.0, y = 0.0, z = 0.0 }
 local rotation = 0.0
 
+-- Scene node for the cube, world matrix is only rebuilt when it changes
+local cubeNode = rl.SceneCreateNode()
+rl.SceneSetPosition(cubeNode, cubePosition.x, cubePosition.y, cubePosition.z)
+local origin = { x = 0.0, y = 0.0, z = 0.0 }
+
 -- Cube data (translated from drawcube.c)
 local RL_TRIANGLES = 4 -- RL_TRIANGLES mode from rlgl.h
 local cubeVertices = {
@@ -82,18 +86,11 @@ function render()
     --     rotation = math.fmod(time * 30.0, 360.0)
     -- end
 
-    local aspect = screenWidth / screenHeight
-    local proj = rl.MatrixPerspective(camera.fovy * (math.pi / 180.0), aspect, 0.1, 1000.0)
-    rl.rlSetMatrixProjection(proj)
-
-    local view = rl.MatrixLookAt(camera.position, camera.target, camera.up)
-    local rot = rl.MatrixRotateY(rotation * (math.pi / 180.0))
-    local trans = rl.MatrixTranslate(cubePosition.x, cubePosition.y, cubePosition.z)
-    local model = rl.MatrixMultiply(rot, trans)
-    local modelView = rl.MatrixMultiply(model, view)
-    rl.rlSetMatrixModelview(modelView)
+    camera:Apply()
+    rl.SceneUpdate()
+    rl.SceneApply(cubeNode, camera)
 
-    DrawCube(cubePosition) -- Call Lua DrawCube
+    DrawCube(origin) -- Node already holds the position
 end
 
 -- Draw function for ImGui
@@ -106,6 +103,7 @@ function draw()
     local newRotation, changed = imgui.SliderFloat("Cube Y Rotation", rotation, 0.0, 360.0, "%.0f degrees")
     if changed then
         rotation = newRotation
+        rl.SceneSetRotation(cubeNode, 0.0, rotation * (math.pi / 180.0), 0.0)
         print(newRotation)
     end
     imgui.End()
@@ -0,0 +1,28 @@
+// app_clock.c
+#include "app_clock.h"
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+static double g_step = 0.0;
+static double g_time = 0.0;
+
+void app_clock_set_fixed(double step) {
+    g_step = (step > 0.0) ? step : 0.0;
+    g_time = 0.0;
+}
+
+bool app_clock_is_fixed(void) {
+    return g_step > 0.0;
+}
+
+double app_clock_now(void) {
+    return (g_step > 0.0) ? g_time : glfwGetTime();
+}
+
+void app_clock_advance(void) {
+    if (g_step > 0.0) g_time += g_step;
+}
+
+double app_clock_real(void) {
+    return glfwGetTime();
+}
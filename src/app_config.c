@@ -0,0 +1,202 @@
+// app_config.c
+#include "app_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void app_config_defaults(AppConfig *config) {
+    memset(config, 0, sizeof(AppConfig));
+    config->script = "script.lua";
+    config->batchBuffers = 3;
+    config->batchElements = 8192;
+    config->showOverlay = false;
+    config->profile = false;
+    config->shaderCache = "shader_cache";
+    config->fontCache = "font_cache";
+    config->font = NULL;
+    config->fontSize = 16.0;
+    config->imageBudget = 256;
+    config->pacing = PACING_VSYNC;
+    config->fpsCap = 60.0;
+    config->idle = false;
+    config->idleTimeout = 0.25;
+    config->uiCache = true;
+    config->imguiGl3 = false;
+    config->uiRate = 0.0;
+    config->pipelineDepth = 0;
+    config->dynres = 0.0;
+    config->msaa = 4;
+    config->minScale = 0.5;
+    config->width = 800;
+    config->height = 450;
+    config->headless = false;
+    config->frames = 300;
+    config->fixedStep = 1.0/60.0;
+    config->dumpDir = NULL;
+    config->dumpEvery = 1;
+    config->reportPath = "headless_report.json";  // Not stdout, module logs go there
+}
+
+void app_config_print_usage(const char *exe) {
+    printf("Usage: %s [options] [script.lua]\n", exe);
+    printf("  --batch-buffers N     rlgl render batch buffers (default 3)\n");
+    printf("  --batch-elements N    quads per batch buffer (default 8192)\n");
+    printf("  --overlay             show perf overlay at start (F3 toggles)\n");
+    printf("  --profile             CPU profiler window at start (F4 toggles)\n");
+    printf("  --shader-cache DIR    program binary cache directory (default shader_cache)\n");
+    printf("  --no-shader-cache     always compile shaders from source\n");
+    printf("  --font FILE           default UI font, loaded in the background (TTF/OTF)\n");
+    printf("  --font-size PX        size for --font (default 16)\n");
+    printf("  --font-cache DIR      glyph table directory (default font_cache)\n");
+    printf("  --no-font-cache       bake glyphs only when first drawn\n");
+    printf("  --image-budget MB     texture memory for imgui.Image, least recently drawn go first (default 256)\n");
+    printf("  --pacing MODE         vsync, novsync, cap or latelatch (default vsync)\n");
+    printf("  --fps N               frame rate for --pacing cap (default 60, implies cap)\n");
+    printf("  --idle                only render on input, animation or script request\n");
+    printf("  --idle-timeout S      longest idle wait in seconds (default 0.25)\n");
+    printf("  --imgui-gl3           use the stock ImGui OpenGL3 renderer instead of rlgl\n");
+    printf("  --no-ui-cache         submit ImGui draw data every frame\n");
+    printf("  --ui-rate HZ          max UI redraws per second, 3D keeps full rate (default 0 = every change)\n");
+    printf("  --pipeline N          submit on a render thread with N frames in flight (2-4, default off)\n");
+    printf("  --dynres MS           scale 3D resolution / MSAA to hold MS per frame (default off)\n");
+    printf("  --msaa N              MSAA samples for the 3D pass (default 4)\n");
+    printf("  --min-scale F         lowest 3D render scale for --dynres (default 0.5)\n");
+    printf("  --size WxH            window / offscreen size (default 800x450)\n");
+    printf("  --headless            render offscreen without a visible window, then exit\n");
+    printf("  --frames N            frames to run in headless mode (default 300)\n");
+    printf("  --step SECONDS        simulated time per headless frame (default 1/60)\n");
+    printf("  --dump-frames DIR     write headless frames as PNG into DIR\n");
+    printf("  --dump-every N        only dump every Nth frame (default 1)\n");
+    printf("  --report FILE         write the headless JSON report to FILE, - for stdout (default headless_report.json)\n");
+    printf("  --help                show this help\n");
+}
+
+// Read the value following an option, returns false when missing
+static bool read_string(int argc, char **argv, int *i, const char **out) {
+    if (*i + 1 >= argc) {
+        printf("Missing value for %s\n", argv[*i]);
+        return false;
+    }
+    *out = argv[++(*i)];
+    return true;
+}
+
+static bool read_int(int argc, char **argv, int *i, int *out) {
+    const char *value = NULL;
+    if (!read_string(argc, argv, i, &value)) return false;
+    *out = atoi(value);
+    return true;
+}
+
+static bool read_double(int argc, char **argv, int *i, double *out) {
+    const char *value = NULL;
+    if (!read_string(argc, argv, i, &value)) return false;
+    *out = atof(value);
+    return true;
+}
+
+bool app_config_parse(AppConfig *config, int argc, char **argv) {
+    bool pacingSet = false;
+    bool fpsSet = false;
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--batch-buffers") == 0) {
+            if (!read_int(argc, argv, &i, &config->batchBuffers)) return false;
+        } else if (strcmp(arg, "--batch-elements") == 0) {
+            if (!read_int(argc, argv, &i, &config->batchElements)) return false;
+        } else if (strcmp(arg, "--overlay") == 0) {
+            config->showOverlay = true;
+        } else if (strcmp(arg, "--profile") == 0) {
+            config->profile = true;
+        } else if (strcmp(arg, "--shader-cache") == 0) {
+            if (!read_string(argc, argv, &i, &config->shaderCache)) return false;
+        } else if (strcmp(arg, "--no-shader-cache") == 0) {
+            config->shaderCache = NULL;
+        } else if (strcmp(arg, "--font") == 0) {
+            if (!read_string(argc, argv, &i, &config->font)) return false;
+        } else if (strcmp(arg, "--font-size") == 0) {
+            if (!read_double(argc, argv, &i, &config->fontSize)) return false;
+        } else if (strcmp(arg, "--font-cache") == 0) {
+            if (!read_string(argc, argv, &i, &config->fontCache)) return false;
+        } else if (strcmp(arg, "--no-font-cache") == 0) {
+            config->fontCache = NULL;
+        } else if (strcmp(arg, "--image-budget") == 0) {
+            if (!read_int(argc, argv, &i, &config->imageBudget)) return false;
+        } else if (strcmp(arg, "--pacing") == 0) {
+            const char *value = NULL;
+            if (!read_string(argc, argv, &i, &value)) return false;
+            if (!pacing_mode_from_name(value, &config->pacing)) {
+                printf("Unknown pacing mode: %s\n", value);
+                return false;
+            }
+            pacingSet = true;
+        } else if (strcmp(arg, "--fps") == 0) {
+            if (!read_double(argc, argv, &i, &config->fpsCap)) return false;
+            fpsSet = true;
+        } else if (strcmp(arg, "--idle") == 0) {
+            config->idle = true;
+        } else if (strcmp(arg, "--idle-timeout") == 0) {
+            if (!read_double(argc, argv, &i, &config->idleTimeout)) return false;
+        } else if (strcmp(arg, "--imgui-gl3") == 0) {
+            config->imguiGl3 = true;
+        } else if (strcmp(arg, "--no-ui-cache") == 0) {
+            config->uiCache = false;
+        } else if (strcmp(arg, "--ui-rate") == 0) {
+            if (!read_double(argc, argv, &i, &config->uiRate)) return false;
+        } else if (strcmp(arg, "--pipeline") == 0) {
+            if (!read_int(argc, argv, &i, &config->pipelineDepth)) return false;
+        } else if (strcmp(arg, "--dynres") == 0) {
+            if (!read_double(argc, argv, &i, &config->dynres)) return false;
+        } else if (strcmp(arg, "--msaa") == 0) {
+            if (!read_int(argc, argv, &i, &config->msaa)) return false;
+        } else if (strcmp(arg, "--min-scale") == 0) {
+            if (!read_double(argc, argv, &i, &config->minScale)) return false;
+        } else if (strcmp(arg, "--size") == 0) {
+            const char *value = NULL;
+            if (!read_string(argc, argv, &i, &value)) return false;
+            if (sscanf(value, "%dx%d", &config->width, &config->height) != 2) {
+                printf("Invalid size: %s (expected WxH)\n", value);
+                return false;
+            }
+        } else if (strcmp(arg, "--headless") == 0) {
+            config->headless = true;
+        } else if (strcmp(arg, "--frames") == 0) {
+            if (!read_int(argc, argv, &i, &config->frames)) return false;
+        } else if (strcmp(arg, "--step") == 0) {
+            if (!read_double(argc, argv, &i, &config->fixedStep)) return false;
+        } else if (strcmp(arg, "--dump-frames") == 0) {
+            if (!read_string(argc, argv, &i, &config->dumpDir)) return false;
+        } else if (strcmp(arg, "--dump-every") == 0) {
+            if (!read_int(argc, argv, &i, &config->dumpEvery)) return false;
+        } else if (strcmp(arg, "--report") == 0) {
+            if (!read_string(argc, argv, &i, &config->reportPath)) return false;
+        } else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            app_config_print_usage(argv[0]);
+            return false;
+        } else if (strncmp(arg, "--", 2) == 0) {
+            printf("Unknown option: %s\n", arg);
+            app_config_print_usage(argv[0]);
+            return false;
+        } else {
+            config->script = arg;
+            printf("Using Lua script from arg: %s\n", arg);
+        }
+    }
+
+    if (config->batchBuffers < 1) config->batchBuffers = 1;
+    if (config->batchElements < 256) config->batchElements = 256;
+    if (fpsSet && !pacingSet) config->pacing = PACING_CAP;
+    if (config->fpsCap < 1.0) config->fpsCap = 1.0;
+    if (config->idleTimeout <= 0.0) config->idleTimeout = 0.25;
+    if (config->imageBudget < 0) config->imageBudget = 0;      // Would wrap to a huge size_t
+    // Sample counts GL accepts: 0 (off) or a power of two up to 16
+    if (config->msaa < 0) config->msaa = 0;
+    if (config->msaa > 16) config->msaa = 16;
+    while (config->msaa & (config->msaa - 1)) config->msaa &= config->msaa - 1;
+    if (config->width < 1) config->width = 1;
+    if (config->height < 1) config->height = 1;
+    if (config->frames < 1) config->frames = 1;
+    if (config->fixedStep <= 0.0) config->fixedStep = 1.0/60.0;
+    if (config->dumpEvery < 1) config->dumpEvery = 1;
+    return true;
+}
@@ -0,0 +1,202 @@
+// frame_pacing.c
+// Frame pacing modes. All waits are hybrid: the OS sleep covers most of
+// the wait, the last PACING_SPIN_SECONDS spin on the clock because sleep
+// wake-ups are late by up to a scheduler tick.
+//
+// Late latch predicts the next vblank from the last swap and the refresh
+// period, then starts the frame (poll input, Lua draw, submit) only
+// work-estimate + margin before it. The estimate decays slowly towards the
+// measured latch-to-swap time so one slow frame pushes the latch earlier
+// right away.
+#include "frame_pacing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+    #include <mmsystem.h>           // timeBeginPeriod()
+    #define PACING_SPIN_SECONDS 0.002
+#else
+    #include <time.h>
+    #define PACING_SPIN_SECONDS 0.001
+#endif
+
+#define PACING_LATCH_MARGIN 0.0015  // Safety before the predicted vblank
+
+static PacingMode g_mode = PACING_VSYNC;
+static double g_fps = 60.0;             // Cap target
+static double g_refresh_period = 1.0/60.0;
+static double g_frame_start = 0.0;      // Cap: start of the current frame
+static double g_last_swap = 0.0;        // Return of the previous swap
+static double g_latch = 0.0;            // Input poll time of the current frame
+static double g_work_estimate = 0.004;  // Late latch: latch to swap call
+static bool g_skip_sample = false;      // Idle wait this frame
+
+static double g_history[PACING_HISTORY];    // Frame times (seconds)
+static double g_latch_history[PACING_HISTORY];
+static int g_history_count = 0;
+static int g_history_next = 0;
+
+static const char *g_mode_names[] = { "vsync", "novsync", "cap", "latelatch" };
+
+const char *pacing_mode_name(PacingMode mode) {
+    return ((int)mode >= 0 && (int)mode < 4) ? g_mode_names[mode] : "unknown";
+}
+
+bool pacing_mode_from_name(const char *name, PacingMode *mode) {
+    for (int i = 0; i < 4; ++i) {
+        if (strcmp(name, g_mode_names[i]) == 0) {
+            *mode = (PacingMode)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void pacing_sleep(double seconds) {
+    double end = glfwGetTime() + seconds;
+    double coarse = seconds - PACING_SPIN_SECONDS;
+    if (coarse > 0.0) {
+#if defined(_WIN32)
+        Sleep((DWORD)(coarse*1000.0));
+#else
+        struct timespec ts;
+        ts.tv_sec = (time_t)coarse;
+        ts.tv_nsec = (long)((coarse - (double)ts.tv_sec)*1e9);
+        nanosleep(&ts, NULL);
+#endif
+    }
+    while (glfwGetTime() < end) {
+        // Spin the remainder
+    }
+}
+
+int pacing_get_swap_interval(void) {
+    return (g_mode == PACING_VSYNC || g_mode == PACING_LATE_LATCH) ? 1 : 0;
+}
+
+static void apply_swap_interval(void) {
+    glfwSwapInterval(pacing_get_swap_interval());
+}
+
+void pacing_setup(double refreshHz) {
+    g_refresh_period = (refreshHz > 0.0) ? 1.0/refreshHz : 1.0/60.0;
+#if defined(_WIN32)
+    timeBeginPeriod(1);     // 1 ms Sleep() granularity, raylib's InitWindow() does the same
+#endif
+    apply_swap_interval();
+    g_last_swap = g_frame_start = glfwGetTime();
+}
+
+void pacing_cleanup(void) {
+#if defined(_WIN32)
+    timeEndPeriod(1);
+#endif
+}
+
+void pacing_set_mode(PacingMode mode, double fps) {
+    if (fps > 0.0) g_fps = fps;
+    if (mode != g_mode) {
+        g_mode = mode;
+        g_history_count = 0;
+        g_history_next = 0;
+        printf("Frame pacing: %s", pacing_mode_name(mode));
+        if (mode == PACING_CAP) printf(" (%.0f fps)", g_fps);
+        printf("\n");
+    }
+    apply_swap_interval();
+}
+
+PacingMode pacing_get_mode(void) {
+    return g_mode;
+}
+
+double pacing_get_fps(void) {
+    return g_fps;
+}
+
+void pacing_wait(void) {
+    double now = glfwGetTime();
+    if (g_mode == PACING_CAP) {
+        double target = g_frame_start + 1.0/g_fps;
+        if (target > now) {
+            pacing_sleep(target - now);
+            g_frame_start = target;
+        } else {
+            g_frame_start = now;    // Running late, don't try to catch up
+        }
+    } else if (g_mode == PACING_LATE_LATCH) {
+        double vblank = g_last_swap + g_refresh_period;
+        while (vblank < now) vblank += g_refresh_period;
+        double latch = vblank - g_work_estimate - PACING_LATCH_MARGIN;
+        if (latch > now) pacing_sleep(latch - now);
+    }
+    g_latch = glfwGetTime();
+}
+
+void pacing_before_swap(void) {
+    double work = glfwGetTime() - g_latch;
+    if (work > g_work_estimate) {
+        g_work_estimate = work;
+    } else {
+        g_work_estimate = g_work_estimate*0.95 + work*0.05;
+    }
+}
+
+void pacing_mark_idle(void) {
+    g_skip_sample = true;
+}
+
+void pacing_after_swap(void) {
+    double now = glfwGetTime();
+    if (g_skip_sample) {
+        g_skip_sample = false;
+        g_last_swap = now;
+        return;
+    }
+    g_history[g_history_next] = now - g_last_swap;
+    g_latch_history[g_history_next] = now - g_latch;
+    g_history_next = (g_history_next + 1) % PACING_HISTORY;
+    if (g_history_count < PACING_HISTORY) g_history_count++;
+    g_last_swap = now;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+PacingStats pacing_get_stats(void) {
+    PacingStats stats = { 0 };
+    int count = g_history_count;
+    if (count == 0) return stats;
+
+    double sorted[PACING_HISTORY];
+    double sum = 0.0, latchSum = 0.0;
+    for (int i = 0; i < count; ++i) {
+        sorted[i] = g_history[i];
+        sum += g_history[i];
+        latchSum += g_latch_history[i];
+    }
+    double mean = sum/count;
+    double variance = 0.0;
+    for (int i = 0; i < count; ++i) {
+        double d = g_history[i] - mean;
+        variance += d*d;
+    }
+    qsort(sorted, (size_t)count, sizeof(double), compare_double);
+
+    stats.samples = count;
+    stats.avgMs = mean*1000.0;
+    stats.jitterMs = sqrt(variance/count)*1000.0;
+    stats.minMs = sorted[0]*1000.0;
+    stats.maxMs = sorted[count - 1]*1000.0;
+    stats.p99Ms = sorted[(count - 1)*99/100]*1000.0;
+    stats.latchMs = latchSum/count*1000.0;
+    return stats;
+}
@@ -0,0 +1,79 @@
+// gl_ext.c
+#include "gl_ext.h"
+#include <stdio.h>
+#include <string.h>
+
+GlExt glext = { 0 };
+
+static char g_driver[256] = { 0 };
+
+#define GLEXT_LOAD(name) *(void **)(&glext.name) = load("gl" #name)
+
+bool gl_ext_load(GlExtLoadProc load) {
+    if (!load) return false;
+
+    GLEXT_LOAD(CreateProgram);
+    GLEXT_LOAD(DeleteProgram);
+    GLEXT_LOAD(AttachShader);
+    GLEXT_LOAD(DetachShader);
+    GLEXT_LOAD(DeleteShader);
+    GLEXT_LOAD(BindAttribLocation);
+    GLEXT_LOAD(LinkProgram);
+    GLEXT_LOAD(GetProgramiv);
+    GLEXT_LOAD(GetProgramInfoLog);
+    GLEXT_LOAD(ProgramParameteri);
+    GLEXT_LOAD(GetProgramBinary);
+    GLEXT_LOAD(ProgramBinary);
+    GLEXT_LOAD(GetIntegerv);
+    GLEXT_LOAD(GetString);
+    GLEXT_LOAD(Finish);
+    GLEXT_LOAD(Flush);
+    GLEXT_LOAD(ClearBufferfv);
+    GLEXT_LOAD(GenFramebuffers);
+    GLEXT_LOAD(DeleteFramebuffers);
+    GLEXT_LOAD(BindFramebuffer);
+    GLEXT_LOAD(FramebufferTexture2D);
+    GLEXT_LOAD(BlitFramebuffer);
+    GLEXT_LOAD(GenRenderbuffers);
+    GLEXT_LOAD(DeleteRenderbuffers);
+    GLEXT_LOAD(BindRenderbuffer);
+    GLEXT_LOAD(RenderbufferStorageMultisample);
+    GLEXT_LOAD(FramebufferRenderbuffer);
+    GLEXT_LOAD(FenceSync);
+    GLEXT_LOAD(WaitSync);
+    GLEXT_LOAD(DeleteSync);
+    GLEXT_LOAD(BindBuffer);
+    GLEXT_LOAD(BufferData);
+    GLEXT_LOAD(MapBufferRange);
+    GLEXT_LOAD(UnmapBuffer);
+    GLEXT_LOAD(DrawElementsBaseVertex);
+    GLEXT_LOAD(GenQueries);
+    GLEXT_LOAD(DeleteQueries);
+    GLEXT_LOAD(BeginQuery);
+    GLEXT_LOAD(EndQuery);
+    GLEXT_LOAD(GetQueryObjectiv);
+    GLEXT_LOAD(GetQueryObjectui64v);
+
+    if (glext.GetString) {
+        const char *vendor = (const char *)glext.GetString(GL_VENDOR);
+        const char *renderer = (const char *)glext.GetString(GL_RENDERER);
+        const char *version = (const char *)glext.GetString(GL_VERSION);
+        snprintf(g_driver, sizeof(g_driver), "%s | %s | %s",
+                 vendor ? vendor : "?", renderer ? renderer : "?", version ? version : "?");
+    }
+
+    bool ok = glext.CreateProgram && glext.LinkProgram && glext.GetProgramiv && glext.GetIntegerv;
+    if (!ok) printf("Warning: missing OpenGL entry points\n");
+    return ok;
+}
+
+bool gl_ext_has_program_binary(void) {
+    if (!glext.GetProgramBinary || !glext.ProgramBinary || !glext.ProgramParameteri) return false;
+    int formats = 0;
+    glext.GetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+const char *gl_ext_driver_string(void) {
+    return g_driver;
+}
@@ -0,0 +1,149 @@
+// gpu_timer.c
+#include "gpu_timer.h"
+#include "gl_ext.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct PassHistory {
+    float ms[GPU_TIMER_HISTORY];
+    int count;
+    int next;
+    double last;
+} PassHistory;
+
+static unsigned int g_queries[GPU_TIMER_BUFFERS][GPU_PASS_COUNT];
+static bool g_issued[GPU_TIMER_BUFFERS][GPU_PASS_COUNT];
+static PassHistory g_history[GPU_PASS_COUNT];
+static bool g_available = false;
+static bool g_enabled = true;
+static bool g_frameActive = false;
+static int g_slot = 0;
+static int g_open = -1;             // Pass with a running query
+static unsigned int g_frame = 0;
+static int g_skipped = 0;
+
+static const char *g_pass_names[GPU_PASS_COUNT] = { "clear", "scene", "ui", "swap" };
+
+bool gpu_timer_setup(void) {
+    g_available = glext.GenQueries && glext.DeleteQueries && glext.BeginQuery && glext.EndQuery &&
+                  glext.GetQueryObjectiv && glext.GetQueryObjectui64v;
+    if (!g_available) {
+        printf("GPU timers: timer queries not supported\n");
+        return false;
+    }
+    glext.GenQueries(GPU_TIMER_BUFFERS*GPU_PASS_COUNT, &g_queries[0][0]);
+    memset(g_issued, 0, sizeof(g_issued));
+    memset(g_history, 0, sizeof(g_history));
+    return true;
+}
+
+bool gpu_timer_is_available(void) {
+    return g_available;
+}
+
+void gpu_timer_set_enabled(bool enabled) {
+    g_enabled = enabled;
+}
+
+bool gpu_timer_is_enabled(void) {
+    return g_enabled && g_available;
+}
+
+const char *gpu_timer_pass_name(GpuPass pass) {
+    return ((int)pass >= 0 && pass < GPU_PASS_COUNT) ? g_pass_names[pass] : "unknown";
+}
+
+static void push_sample(GpuPass pass, double ms) {
+    PassHistory *h = &g_history[pass];
+    h->ms[h->next] = (float)ms;
+    h->next = (h->next + 1) % GPU_TIMER_HISTORY;
+    if (h->count < GPU_TIMER_HISTORY) h->count++;
+    h->last = ms;
+}
+
+static void collect(void) {
+    for (int b = 0; b < GPU_TIMER_BUFFERS; ++b) {
+        for (int p = 0; p < GPU_PASS_COUNT; ++p) {
+            if (!g_issued[b][p]) continue;
+            int ready = 0;
+            glext.GetQueryObjectiv(g_queries[b][p], GL_QUERY_RESULT_AVAILABLE, &ready);
+            if (!ready) continue;
+            unsigned long long ns = 0;
+            glext.GetQueryObjectui64v(g_queries[b][p], GL_QUERY_RESULT, &ns);
+            push_sample((GpuPass)p, (double)ns/1e6);
+            g_issued[b][p] = false;
+        }
+    }
+}
+
+void gpu_timer_begin_frame(void) {
+    g_frameActive = false;
+    g_open = -1;
+    if (!g_enabled || !g_available) return;
+    collect();
+
+    g_slot = (int)(g_frame++ % GPU_TIMER_BUFFERS);
+    for (int p = 0; p < GPU_PASS_COUNT; ++p) {
+        if (g_issued[g_slot][p]) {
+            g_skipped++;        // Reusing the query now would stall
+            return;
+        }
+    }
+    g_frameActive = true;
+}
+
+void gpu_timer_begin(GpuPass pass) {
+    if (!g_frameActive || g_open >= 0) return;
+    glext.BeginQuery(GL_TIME_ELAPSED, g_queries[g_slot][pass]);
+    g_open = pass;
+}
+
+void gpu_timer_end(GpuPass pass) {
+    if (!g_frameActive || g_open != (int)pass) return;
+    glext.EndQuery(GL_TIME_ELAPSED);
+    g_issued[g_slot][pass] = true;
+    g_open = -1;
+}
+
+static int compare_float(const void *a, const void *b) {
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+GpuPassStats gpu_timer_get_stats(GpuPass pass) {
+    GpuPassStats stats = { 0 };
+    if ((int)pass < 0 || pass >= GPU_PASS_COUNT) return stats;
+    const PassHistory *h = &g_history[pass];
+    if (h->count == 0) return stats;
+
+    float sorted[GPU_TIMER_HISTORY];
+    double sum = 0.0;
+    for (int i = 0; i < h->count; ++i) {
+        sorted[i] = h->ms[i];
+        sum += h->ms[i];
+    }
+    qsort(sorted, (size_t)h->count, sizeof(float), compare_float);
+    stats.samples = h->count;
+    stats.lastMs = h->last;
+    stats.avgMs = sum/h->count;
+    stats.p95Ms = sorted[(h->count - 1)*95/100];
+    stats.maxMs = sorted[h->count - 1];
+    return stats;
+}
+
+const float *gpu_timer_get_history(GpuPass pass, int *count, int *offset) {
+    const PassHistory *h = &g_history[pass];
+    *count = h->count;
+    *offset = (h->count == GPU_TIMER_HISTORY) ? h->next : 0;
+    return h->ms;
+}
+
+int gpu_timer_get_skipped(void) {
+    return g_skipped;
+}
+
+void gpu_timer_cleanup(void) {
+    if (g_available) glext.DeleteQueries(GPU_TIMER_BUFFERS*GPU_PASS_COUNT, &g_queries[0][0]);
+    g_available = false;
+}
@@ -0,0 +1,193 @@
+// headless.c
+// Frame timing: cpuMs ends when the frame is submitted, frameMs after
+// glFinish() so software rasterizers (llvmpipe) are measured honestly.
+#include "headless.h"
+#include "app_clock.h"
+#include "gl_ext.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rlgl.h"
+#include "raylib.h"             // Image, ExportImage(), MakeDirectory()
+
+typedef struct HeadlessRun {
+    bool active;
+    int width;
+    int height;
+    int frames;
+    int frame;
+    int dumpEvery;
+    const char *dumpDir;
+    const char *reportPath;
+    double step;
+
+    unsigned int fbo;
+    unsigned int colorTexture;
+    unsigned int depthBuffer;
+
+    double runStart;
+    double frameStart;
+    double *cpuMs;
+    double *frameMs;
+} HeadlessRun;
+
+static HeadlessRun g_run = { 0 };
+
+typedef struct TimingSummary {
+    double avg, min, max, p50, p95, p99;
+} TimingSummary;
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static TimingSummary summarize(double *values, int count) {
+    TimingSummary s = { 0 };
+    if (count <= 0) return s;
+    double sum = 0.0;
+    for (int i = 0; i < count; ++i) sum += values[i];
+    qsort(values, (size_t)count, sizeof(double), compare_double);
+    s.avg = sum/count;
+    s.min = values[0];
+    s.max = values[count - 1];
+    s.p50 = values[(count - 1)*50/100];
+    s.p95 = values[(count - 1)*95/100];
+    s.p99 = values[(count - 1)*99/100];
+    return s;
+}
+
+static void write_summary(FILE *out, const char *name, TimingSummary s, bool last) {
+    fprintf(out, "  \"%s\": { \"avg\": %.4f, \"min\": %.4f, \"max\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f }%s\n",
+            name, s.avg, s.min, s.max, s.p50, s.p95, s.p99, last ? "" : ",");
+}
+
+static void write_json_string(FILE *out, const char *text) {
+    fputc('"', out);
+    for (const char *c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') fputc('\\', out);
+        if ((unsigned char)*c >= 0x20) fputc(*c, out);
+    }
+    fputc('"', out);
+}
+
+bool headless_begin(const AppConfig *config, int width, int height) {
+    memset(&g_run, 0, sizeof(g_run));
+    g_run.width = width;
+    g_run.height = height;
+    g_run.frames = config->frames;
+    g_run.dumpDir = config->dumpDir;
+    g_run.dumpEvery = config->dumpEvery;
+    g_run.reportPath = config->reportPath;
+    g_run.step = config->fixedStep;
+
+    g_run.fbo = rlLoadFramebuffer();
+    g_run.colorTexture = rlLoadTexture(NULL, width, height, RL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+    g_run.depthBuffer = rlLoadTextureDepth(width, height, true);
+    rlFramebufferAttach(g_run.fbo, g_run.colorTexture, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+    rlFramebufferAttach(g_run.fbo, g_run.depthBuffer, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
+    if (!rlFramebufferComplete(g_run.fbo)) {
+        printf("Error: headless framebuffer incomplete\n");
+        headless_end();
+        return false;
+    }
+
+    g_run.cpuMs = (double*)calloc((size_t)g_run.frames, sizeof(double));
+    g_run.frameMs = (double*)calloc((size_t)g_run.frames, sizeof(double));
+    if (!g_run.cpuMs || !g_run.frameMs) {
+        headless_end();
+        return false;
+    }
+
+    if (g_run.dumpDir && g_run.dumpEvery > 0) MakeDirectory(g_run.dumpDir);
+
+    app_clock_set_fixed(g_run.step);
+    g_run.active = true;
+    g_run.runStart = app_clock_real();
+    printf("Headless: %d frames at %dx%d, step %.4f s\n", g_run.frames, width, height, g_run.step);
+    return true;
+}
+
+bool headless_is_active(void) {
+    return g_run.active;
+}
+
+void headless_begin_frame(void) {
+    g_run.frameStart = app_clock_real();
+    rlEnableFramebuffer(g_run.fbo);
+    rlViewport(0, 0, g_run.width, g_run.height);
+}
+
+static void dump_frame(int frame) {
+    unsigned char *pixels = rlReadScreenPixels(g_run.width, g_run.height);   // Reads the bound FBO
+    if (!pixels) return;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%05d.png", g_run.dumpDir, frame);
+    Image image = { pixels, g_run.width, g_run.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    if (!ExportImage(image, path)) printf("Headless: failed to write %s\n", path);
+    free(pixels);
+}
+
+bool headless_end_frame(void) {
+    if (!g_run.active) return false;
+    int frame = g_run.frame;
+
+    g_run.cpuMs[frame] = (app_clock_real() - g_run.frameStart)*1000.0;
+    if (glext.Finish) glext.Finish();
+    g_run.frameMs[frame] = (app_clock_real() - g_run.frameStart)*1000.0;
+
+    if (g_run.dumpDir && g_run.dumpEvery > 0 && frame % g_run.dumpEvery == 0) {
+        dump_frame(frame);
+    }
+    rlDisableFramebuffer();
+
+    app_clock_advance();
+    g_run.frame++;
+    return g_run.frame < g_run.frames;
+}
+
+static void write_report(void) {
+    FILE *out = stdout;
+    if (g_run.reportPath && strcmp(g_run.reportPath, "-") != 0) {
+        out = fopen(g_run.reportPath, "w");
+        if (!out) {
+            printf("Headless: cannot write %s, using stdout\n", g_run.reportPath);
+            out = stdout;
+        }
+    }
+
+    int frames = g_run.frame;
+    double wallSeconds = app_clock_real() - g_run.runStart;
+    TimingSummary cpu = summarize(g_run.cpuMs, frames);
+    TimingSummary total = summarize(g_run.frameMs, frames);
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"frames\": %d,\n", frames);
+    fprintf(out, "  \"width\": %d,\n", g_run.width);
+    fprintf(out, "  \"height\": %d,\n", g_run.height);
+    fprintf(out, "  \"step\": %.6f,\n", g_run.step);
+    fprintf(out, "  \"simulatedSeconds\": %.4f,\n", frames*g_run.step);
+    fprintf(out, "  \"wallSeconds\": %.4f,\n", wallSeconds);
+    fprintf(out, "  \"fps\": %.2f,\n", (wallSeconds > 0.0) ? frames/wallSeconds : 0.0);
+    fprintf(out, "  \"driver\": ");
+    write_json_string(out, gl_ext_driver_string());
+    fprintf(out, ",\n");
+    write_summary(out, "cpuMs", cpu, false);
+    write_summary(out, "frameMs", total, true);
+    fprintf(out, "}\n");
+
+    if (out != stdout) {
+        fclose(out);
+        printf("Headless: report written to %s\n", g_run.reportPath);
+    }
+}
+
+void headless_end(void) {
+    if (g_run.active) write_report();
+    if (g_run.fbo) rlUnloadFramebuffer(g_run.fbo);     // Also deletes the depth renderbuffer
+    if (g_run.colorTexture) rlUnloadTexture(g_run.colorTexture);
+    free(g_run.cpuMs);
+    free(g_run.frameMs);
+    memset(&g_run, 0, sizeof(g_run));
+    app_clock_set_fixed(0.0);
+}
@@ -0,0 +1,78 @@
+// idle_mode.c
+// A frame that saw input keeps the loop awake for IDLE_SETTLE_FRAMES more
+// frames: ImGui reacts to input one frame late (hover, open/close, layout).
+#include "idle_mode.h"
+#include "cimgui.h"
+#include <stdatomic.h>
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#define igGetIO igGetIO_Nil
+
+#define IDLE_SETTLE_FRAMES 3
+#define IDLE_CARET_BLINK 0.5   // Wake up for the text cursor blink
+
+static bool g_enabled = false;
+static double g_timeout = 0.25;
+static int g_settle = IDLE_SETTLE_FRAMES;   // Frames still to render
+static double g_deadline = 0.0;             // Animation deadline (glfwGetTime)
+static bool g_text_input = false;
+static atomic_bool g_redraw = false;
+static IdleStats g_stats = { 0 };
+
+void idle_set_enabled(bool enabled, double timeout) {
+    g_enabled = enabled;
+    if (timeout > 0.0) g_timeout = timeout;
+    g_settle = IDLE_SETTLE_FRAMES;
+}
+
+bool idle_is_enabled(void) {
+    return g_enabled;
+}
+
+void idle_notify_input(void) {
+    g_settle = IDLE_SETTLE_FRAMES;
+}
+
+void idle_request_redraw(void) {
+    atomic_store(&g_redraw, true);
+    glfwPostEmptyEvent();   // Wakes a pending wait, safe from any thread
+}
+
+void idle_animate_for(double seconds) {
+    double deadline = glfwGetTime() + seconds;
+    if (deadline > g_deadline) g_deadline = deadline;
+}
+
+bool idle_poll_events(void) {
+    bool busy = !g_enabled || g_settle > 0 || glfwGetTime() < g_deadline ||
+                atomic_exchange(&g_redraw, false);
+    if (busy) {
+        glfwPollEvents();
+        return false;
+    }
+
+    double timeout = g_text_input ? IDLE_CARET_BLINK : g_timeout;
+    if (timeout > g_timeout) timeout = g_timeout;
+    glfwWaitEventsTimeout(timeout);
+    atomic_store(&g_redraw, false);     // This frame renders anyway
+    g_stats.waits++;
+    return true;
+}
+
+void idle_end_frame(void) {
+    g_stats.frames++;
+    if (g_settle > 0) g_settle--;
+
+    // ImGui still working: dragging, typing, holding a button
+    ImGuiIO *io = igGetIO();
+    g_text_input = io->WantTextInput;
+    if (igIsAnyItemActive()) g_settle = IDLE_SETTLE_FRAMES;
+}
+
+IdleStats idle_get_stats(void) {
+    IdleStats stats = g_stats;
+    stats.enabled = g_enabled;
+    stats.timeout = g_timeout;
+    return stats;
+}
@@ -0,0 +1,287 @@
+// imgui_rlgl.c
+#include "imgui_rlgl.h"
+#include "module_batch.h"
+#include "module_shader.h"
+#include "gl_ext.h"
+#include "cimgui_impl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rlgl.h"
+#include "raymath.h"
+
+#define igGetIO igGetIO_Nil
+
+#ifndef ImTextureID_Invalid
+    #define ImTextureID_Invalid ((ImTextureID)0)
+#endif
+#ifndef ImDrawCallback_ResetRenderState
+    #define ImDrawCallback_ResetRenderState (ImDrawCallback)(-8)
+#endif
+
+#define IMGUI_RLGL_VERTEX_BYTES (1 << 20)   // Initial ring sizes, grown when a frame doesn't fit
+#define IMGUI_RLGL_INDEX_BYTES  (1 << 19)
+
+typedef struct StreamBuffer {
+    unsigned int id;
+    unsigned int target;    // GL_ARRAY_BUFFER / GL_ELEMENT_ARRAY_BUFFER
+    int capacity;
+    int cursor;
+} StreamBuffer;
+
+static bool g_active = false;
+static unsigned int g_shader = 0;
+static int g_projLoc = -1;
+static int g_textureLoc = -1;
+static unsigned int g_vao = 0;
+static StreamBuffer g_vertices = { 0 };
+static StreamBuffer g_indices = { 0 };
+static ImguiRlglStats g_stats = { 0 };
+
+static const char *g_vs =
+    "#version 330\n"
+    "in vec2 vertexPosition;\n"
+    "in vec2 vertexTexCoord;\n"
+    "in vec4 vertexColor;\n"
+    "uniform mat4 mvp;\n"
+    "out vec2 fragTexCoord;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    fragTexCoord = vertexTexCoord;\n"
+    "    fragColor = vertexColor;\n"
+    "    gl_Position = mvp*vec4(vertexPosition, 0.0, 1.0);\n"
+    "}\n";
+
+static const char *g_fs =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    finalColor = fragColor*texture(texture0, fragTexCoord);\n"
+    "}\n";
+
+bool imgui_rlgl_init(void) {
+    if (!glext.MapBufferRange || !glext.UnmapBuffer || !glext.BufferData || !glext.BindBuffer || !glext.DrawElementsBaseVertex) {
+        printf("ImGui rlgl: buffer mapping or base vertex draws missing\n");
+        return false;
+    }
+    g_shader = shader_cache_load(g_vs, g_fs);
+    if (!g_shader) return false;
+    g_projLoc = rlGetLocationUniform(g_shader, "mvp");
+    g_textureLoc = rlGetLocationUniform(g_shader, "texture0");
+
+    g_vao = rlLoadVertexArray();    // Also binds it
+    g_vertices = (StreamBuffer){ rlLoadVertexBuffer(NULL, IMGUI_RLGL_VERTEX_BYTES, true), GL_ARRAY_BUFFER, IMGUI_RLGL_VERTEX_BYTES, 0 };
+    g_indices = (StreamBuffer){ rlLoadVertexBufferElement(NULL, IMGUI_RLGL_INDEX_BYTES, true), GL_ELEMENT_ARRAY_BUFFER, IMGUI_RLGL_INDEX_BYTES, 0 };
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 2, RL_FLOAT, false, sizeof(ImDrawVert), 0);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, RL_FLOAT, false, sizeof(ImDrawVert), 8);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 4, RL_UNSIGNED_BYTE, true, sizeof(ImDrawVert), 16);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR);
+    rlDisableVertexArray();
+
+    ImGuiIO *io = igGetIO();
+    io->BackendRendererName = "imgui_impl_rlgl";
+    io->BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset | ImGuiBackendFlags_RendererHasTextures;
+    g_active = true;
+    return true;
+}
+
+bool imgui_rlgl_is_active(void) {
+    return g_active;
+}
+
+// Font atlas and user textures (ImGui 1.92 texture protocol), RGBA32 only
+static void update_texture(ImTextureData *tex) {
+    if (tex->Status == ImTextureStatus_WantCreate) {
+        unsigned int id = rlLoadTexture(tex->Pixels, tex->Width, tex->Height, RL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+        rlTextureParameters(id, RL_TEXTURE_MIN_FILTER, RL_TEXTURE_FILTER_LINEAR);
+        rlTextureParameters(id, RL_TEXTURE_MAG_FILTER, RL_TEXTURE_FILTER_LINEAR);
+        ImTextureData_SetTexID(tex, (ImTextureID)id);
+        ImTextureData_SetStatus(tex, ImTextureStatus_OK);
+    } else if (tex->Status == ImTextureStatus_WantUpdates) {
+        // glTexSubImage2D without UNPACK_ROW_LENGTH needs tightly packed rows
+        int x = tex->UpdateRect.x, y = tex->UpdateRect.y, w = tex->UpdateRect.w, h = tex->UpdateRect.h;
+        int pitch = w*tex->BytesPerPixel;
+        unsigned char *rows = (unsigned char *)malloc((size_t)pitch*h);
+        if (rows) {
+            for (int row = 0; row < h; ++row) {
+                memcpy(rows + (size_t)row*pitch, ImTextureData_GetPixelsAt(tex, x, y + row), (size_t)pitch);
+            }
+            rlUpdateTexture((unsigned int)tex->TexID, x, y, w, h, RL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, rows);
+            free(rows);
+        }
+        ImTextureData_SetStatus(tex, ImTextureStatus_OK);
+    } else if (tex->Status == ImTextureStatus_WantDestroy && tex->UnusedFrames > 0) {
+        rlUnloadTexture((unsigned int)tex->TexID);
+        ImTextureData_SetTexID(tex, ImTextureID_Invalid);
+        ImTextureData_SetStatus(tex, ImTextureStatus_Destroyed);
+    }
+}
+
+// Appends `bytes` at the cursor, orphaning the storage when it would wrap.
+// Returns the byte offset of the data in the buffer.
+static int stream_write(StreamBuffer *buffer, ImDrawData *drawData, bool vertices, int bytes) {
+    glext.BindBuffer(buffer->target, buffer->id);
+    if (bytes > buffer->capacity || buffer->cursor + bytes > buffer->capacity) {
+        if (bytes > buffer->capacity) buffer->capacity = bytes*2;
+        glext.BufferData(buffer->target, buffer->capacity, NULL, GL_STREAM_DRAW);  // Fresh storage, the GPU keeps the old one
+        buffer->cursor = 0;
+        g_stats.orphans++;
+    }
+    int offset = buffer->cursor;
+    unsigned char *dst = (unsigned char *)glext.MapBufferRange(buffer->target, offset, bytes,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (dst) {
+        for (int n = 0; n < drawData->CmdListsCount; ++n) {
+            const ImDrawList *list = drawData->CmdLists.Data[n];
+            size_t size = vertices ? (size_t)list->VtxBuffer.Size*sizeof(ImDrawVert) : (size_t)list->IdxBuffer.Size*sizeof(ImDrawIdx);
+            memcpy(dst, vertices ? (const void *)list->VtxBuffer.Data : (const void *)list->IdxBuffer.Data, size);
+            dst += size;
+        }
+        glext.UnmapBuffer(buffer->target);
+    }
+    buffer->cursor += bytes;
+    return offset;
+}
+
+static void setup_render_state(ImDrawData *drawData, int fbWidth, int fbHeight) {
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+    rlSetBlendMode(RL_BLEND_CUSTOM_SEPARATE);
+    rlDisableDepthTest();
+    rlDisableBackfaceCulling();
+    rlEnableScissorTest();
+    rlViewport(0, 0, fbWidth, fbHeight);
+
+    float left = drawData->DisplayPos.x;
+    float top = drawData->DisplayPos.y;
+    Matrix projection = MatrixOrtho(left, left + drawData->DisplaySize.x, top + drawData->DisplaySize.y, top, -1.0, 1.0);
+    rlEnableShader(g_shader);
+    rlSetUniformMatrix(g_projLoc, projection);
+    int slot = 0;
+    rlSetUniform(g_textureLoc, &slot, RL_SHADER_UNIFORM_SAMPLER2D, 1);
+    rlActiveTextureSlot(0);
+    rlEnableVertexArray(g_vao);
+}
+
+// Back to what rlgl's batch and main.c expect
+static void restore_render_state(void) {
+    rlDisableVertexArray();
+    rlDisableTexture();
+    rlDisableShader();
+    rlDisableScissorTest();
+    rlEnableBackfaceCulling();
+    rlEnableDepthTest();
+    rlSetBlendMode(RL_BLEND_ALPHA);
+}
+
+void imgui_rlgl_render(ImDrawData *drawData) {
+    int fbWidth = (int)(drawData->DisplaySize.x*drawData->FramebufferScale.x);
+    int fbHeight = (int)(drawData->DisplaySize.y*drawData->FramebufferScale.y);
+    if (fbWidth <= 0 || fbHeight <= 0) return;
+
+    if (drawData->Textures) {
+        for (int i = 0; i < drawData->Textures->Size; ++i) {
+            ImTextureData *tex = drawData->Textures->Data[i];
+            if (tex->Status != ImTextureStatus_OK) update_texture(tex);
+        }
+    }
+    g_stats.drawCalls = g_stats.textureBinds = 0;
+    g_stats.vertexBytes = drawData->TotalVtxCount*(int)sizeof(ImDrawVert);
+    g_stats.indexBytes = drawData->TotalIdxCount*(int)sizeof(ImDrawIdx);
+    if (drawData->CmdListsCount == 0 || drawData->TotalIdxCount == 0) return;
+
+    batch_flush();      // Pending rlgl geometry goes first
+    setup_render_state(drawData, fbWidth, fbHeight);
+
+    // Cursors only advance by whole vertices, so offsets convert to a base vertex
+    int vertexOffset = stream_write(&g_vertices, drawData, true, g_stats.vertexBytes);
+    int indexOffset = stream_write(&g_indices, drawData, false, g_stats.indexBytes);
+    int baseVertex = vertexOffset/(int)sizeof(ImDrawVert);
+    int baseIndex = indexOffset/(int)sizeof(ImDrawIdx);
+
+    ImVec2 clipOffset = drawData->DisplayPos;
+    ImVec2 clipScale = drawData->FramebufferScale;
+    ImTextureID bound = ImTextureID_Invalid;
+    unsigned int indexType = sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+    for (int n = 0; n < drawData->CmdListsCount; ++n) {
+        const ImDrawList *list = drawData->CmdLists.Data[n];
+        for (int i = 0; i < list->CmdBuffer.Size; ++i) {
+            const ImDrawCmd *cmd = &list->CmdBuffer.Data[i];
+            if (cmd->UserCallback) {
+                if (cmd->UserCallback == ImDrawCallback_ResetRenderState) {
+                    setup_render_state(drawData, fbWidth, fbHeight);
+                    bound = ImTextureID_Invalid;
+                } else {
+                    cmd->UserCallback(list, cmd);
+                }
+                continue;
+            }
+
+            float minX = (cmd->ClipRect.x - clipOffset.x)*clipScale.x;
+            float minY = (cmd->ClipRect.y - clipOffset.y)*clipScale.y;
+            float maxX = (cmd->ClipRect.z - clipOffset.x)*clipScale.x;
+            float maxY = (cmd->ClipRect.w - clipOffset.y)*clipScale.y;
+            if (maxX <= minX || maxY <= minY) continue;
+            rlScissor((int)minX, (int)((float)fbHeight - maxY), (int)(maxX - minX), (int)(maxY - minY));
+
+            ImTextureID texId = cmd->TexRef._TexData ? cmd->TexRef._TexData->TexID : cmd->TexRef._TexID;
+            if (texId != bound) {
+                rlEnableTexture((unsigned int)texId);
+                bound = texId;
+                g_stats.textureBinds++;
+            }
+
+            size_t first = (size_t)(baseIndex + (int)cmd->IdxOffset)*sizeof(ImDrawIdx);
+            glext.DrawElementsBaseVertex(GL_TRIANGLES, (int)cmd->ElemCount, indexType, (const void *)first,
+                                         baseVertex + (int)cmd->VtxOffset);
+            g_stats.drawCalls++;
+        }
+        baseVertex += list->VtxBuffer.Size;
+        baseIndex += list->IdxBuffer.Size;
+    }
+
+    restore_render_state();
+}
+
+ImguiRlglStats imgui_rlgl_get_stats(void) {
+    return g_stats;
+}
+
+void imgui_rlgl_shutdown(void) {
+    if (!g_active) return;
+    ImGuiPlatformIO *platform = igGetPlatformIO_Nil();
+    for (int i = 0; i < platform->Textures.Size; ++i) {
+        ImTextureData *tex = platform->Textures.Data[i];
+        if (tex->RefCount == 1 && tex->TexID != ImTextureID_Invalid) {
+            rlUnloadTexture((unsigned int)tex->TexID);
+            ImTextureData_SetTexID(tex, ImTextureID_Invalid);
+            ImTextureData_SetStatus(tex, ImTextureStatus_Destroyed);
+        }
+    }
+    rlUnloadVertexBuffer(g_vertices.id);
+    rlUnloadVertexBuffer(g_indices.id);
+    rlUnloadVertexArray(g_vao);
+    shader_cache_release(g_shader);
+
+    ImGuiIO *io = igGetIO();
+    io->BackendRendererName = NULL;
+    io->BackendFlags &= ~(ImGuiBackendFlags_RendererHasVtxOffset | ImGuiBackendFlags_RendererHasTextures);
+    g_active = false;
+}
+
+void imgui_renderer_new_frame(void) {
+    if (!g_active) ImGui_ImplOpenGL3_NewFrame();
+}
+
+void imgui_renderer_render(ImDrawData *drawData) {
+    if (g_active) {
+        imgui_rlgl_render(drawData);
+    } else {
+        ImGui_ImplOpenGL3_RenderDrawData(drawData);
+    }
+}
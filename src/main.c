@@ -22,7 +22,32 @@
 #include "module_lua.h"
 #include "module_cimgui.h"
 #include "module_enet.h"
+#include "module_schema.h"
+#include "module_replication.h"
+#include "packet_pool.h"
 #include "module_raylib.h"
+#include "module_instancing.h"
+#include "module_culling.h"
+#include "module_scene.h"
+#include "module_camera.h"
+#include "module_batch.h"
+#include "module_shader.h"
+#include "module_font.h"
+#include "module_image.h"
+#include "scene_scale.h"
+#include "gl_ext.h"
+#include "app_clock.h"
+#include "headless.h"
+#include "frame_pacing.h"
+#include "module_app.h"
+#include "idle_mode.h"
+#include "app_config.h"
+#include "perf_overlay.h"
+#include "ui_layer.h"
+#include "render_pipeline.h"
+#include "gpu_timer.h"
+#include "profiler.h"
+#include "imgui_rlgl.h"
 
 // #include "drawcube.h"
 
@@ -58,6 +83,12 @@
 static void ErrorCallback(int error, const char *description);
 static void KeyCallback(GLFWwindow *window, int key, int scancode, int action, int mods);
 static void FramebufferSizeCallback(GLFWwindow* window, int width, int height);  // For resize
+static GLFWwindow *CreateAppWindow(const AppConfig *config, int width, int height);
+static void CursorPosCallback(GLFWwindow *window, double x, double y);
+static void MouseButtonCallback(GLFWwindow *window, int button, int action, int mods);
+static void ScrollCallback(GLFWwindow *window, double x, double y);
+static void CharCallback(GLFWwindow *window, unsigned int codepoint);
+static void WindowRefreshCallback(GLFWwindow *window);
 
 // Function to draw a simple colored cube (faces with different colors)
 // static void DrawCube(Vector3 position) {
@@ -138,24 +169,38 @@ static void FramebufferSizeCallback(GLFWwindow* window, int width, int height);
 static int file_exists(const char* filename);
 
 int main(int argc, char** argv) {
-    int screenWidth = 800;
-    int screenHeight = 450;
+    AppConfig config;
+    app_config_defaults(&config);
+    if (!app_config_parse(&config, argc, argv)) {
+        return 1;
+    }
+    perf_overlay_set_visible(config.showOverlay);
+    profiler_setup();
+
+    int screenWidth = config.width;
+    int screenHeight = config.height;
     const char *glsl_version = "#version 130";
 
     // Initialize GLFW
-    if (!glfwInit()) {
+    bool glfwReady = glfwInit();
+    if (!glfwReady && config.headless) {
+        // No display server: GLFW's null platform renders through OSMesa
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        glfwReady = glfwInit();
+    }
+    if (!glfwReady) {
         printf("Failed to initialize GLFW\n");
         return -1;
     }
 
-    glfwWindowHint(GLFW_SAMPLES, 4);
-    glfwWindowHint(GLFW_DEPTH_BITS, 16);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
     // Create a window
-    GLFWwindow* window = glfwCreateWindow(screenWidth, screenHeight, "rlgl + ImGui + 3D Cube", NULL, NULL);
+    GLFWwindow* window = CreateAppWindow(&config, screenWidth, screenHeight);
+    if (!window && config.headless && glfwGetPlatform() != GLFW_PLATFORM_NULL) {
+        // Display exists but has no usable GL, retry surfaceless
+        glfwTerminate();
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        if (glfwInit()) window = CreateAppWindow(&config, screenWidth, screenHeight);
+    }
     if (!window) {
         printf("Failed to create GLFW window\n");
         glfwTerminate();
@@ -165,10 +210,27 @@ int main(int argc, char** argv) {
     glfwSetWindowPos(window, 200, 200);
     glfwSetKeyCallback(window, KeyCallback);
     glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);  // Handle resize
+    // Input wakes the idle loop, ImGui chains these when it installs its own
+    glfwSetCursorPosCallback(window, CursorPosCallback);
+    glfwSetMouseButtonCallback(window, MouseButtonCallback);
+    glfwSetScrollCallback(window, ScrollCallback);
+    glfwSetCharCallback(window, CharCallback);
+    glfwSetWindowRefreshCallback(window, WindowRefreshCallback);
 
     // Make the OpenGL context current
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);  // Enable VSync for smoothness
+    bool pipelined = false;
+    if (config.headless) {
+        glfwSwapInterval(0);
+    } else {
+        // Swap interval and waits follow the pacing mode (vsync by default)
+        const GLFWvidmode *videoMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        pacing_set_mode(config.pacing, config.fpsCap);
+        pacing_setup(videoMode ? videoMode->refreshRate : 60.0);
+        idle_set_enabled(config.idle, config.idleTimeout);
+        // Render thread takes the window context, the main thread builds on a shared one
+        if (config.pipelineDepth > 0) pipelined = pipeline_setup(window, config.pipelineDepth);
+    }
 
     // Load OpenGL 3.3 supported extensions
     rlLoadExtensions(glfwGetProcAddress);
@@ -176,18 +238,34 @@ int main(int argc, char** argv) {
     // Initialize OpenGL context (states and resources)
     rlglInit(screenWidth, screenHeight);
 
+    // Entry points rlgl does not expose (program binaries, ...)
+    gl_ext_load((GlExtLoadProc)glfwGetProcAddress);
+    shader_cache_setup(config.shaderCache);
+    font_cache_setup(config.fontCache);
+    image_cache_setup((size_t)config.imageBudget*1024*1024);
+    scene_scale_setup(config.msaa, (float)config.minScale);
+    scene_scale_set_target(config.dynres);
+    gpu_timer_setup();
+
+    // Replace the default render batch with the configured one
+    batch_load(config.batchBuffers, config.batchElements);
+    ui_layer_set_enabled(config.uiCache);
+    ui_layer_set_rate(config.uiRate);
+
     // Set clear color (do this after rlglInit)
     rlClearColor(245, 245, 200, 255);  // Light yellow background
 
     // Enable depth test for 3D
     rlEnableDepthTest();
 
-    // Camera setup
-    Camera camera = { 0 };
-    camera.position = (Vector3){ 5.0f, 5.0f, 5.0f };    // Camera position
-    camera.target = (Vector3){ 0.0f, 0.0f, 0.0f };      // Camera looking at point (cube)
-    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };          // Camera up vector
-    camera.fovy = 45.0f;                                // Field of view Y
+    // Camera setup, matrices are cached and shared with Lua through rl.GetCamera()
+    CachedCamera *camera = camera_get_main();
+    camera_setup(camera,
+                 (Vector3){ 5.0f, 5.0f, 5.0f },    // Camera position
+                 (Vector3){ 0.0f, 0.0f, 0.0f },    // Camera looking at point (cube)
+                 (Vector3){ 0.0f, 1.0f, 0.0f },    // Camera up vector
+                 45.0f);                           // Field of view Y
+    camera_set_viewport(camera, screenWidth, screenHeight);
 
     Vector3 cubePosition = { 0.0f, 0.0f, 0.0f };        // Cube at center
     float rotation = 0.0f;  // For animation (updated by slider or auto)
@@ -203,21 +281,42 @@ int main(int argc, char** argv) {
 
     ImGuiStyle* style = igGetStyle();
     ImGui_ImplGlfw_InitForOpenGL(window, true);
-    ImGui_ImplOpenGL3_Init(glsl_version);
+    // rlgl renderer unless asked for the stock one; the render thread can't use rlgl
+    if (config.imguiGl3 || pipelined || !imgui_rlgl_init()) {
+        ImGui_ImplOpenGL3_Init(glsl_version);
+    }
     igStyleColorsDark(NULL);
 
     // Initialize cimgui this goes here since we need imgui else error.
     cimgui_init(); // init lua cimgui module
     enet_init(); // init network lua module
+    schema_init();
+    replication_init();
     raylib_init();
+    instancing_init();
+    culling_init();
+    scene_init();
+    camera_init();
+    batch_init();
+    shader_init();
+    font_init();
+    image_init();
+    app_init();
+    pipeline_start();
+    profiler_set_enabled(config.profile);
+    if (config.font) font_cache_set_default(font_cache_load(config.font, config.fontSize, false));
+
+    // Headless: offscreen target + fixed clock, set before the script sees rl.GetTime()
+    bool use_lua = false;
+    int exitCode = 0;
+    if (config.headless && !headless_begin(&config, screenWidth, screenHeight)) {
+        printf("Failed to start headless run\n");
+        exitCode = -1;
+        goto cleanup;   // Same teardown as a normal exit
+    }
 
     // Load Lua and check script
-    const char* lua_script = "script.lua";
-    if (argc > 1) {
-        lua_script = argv[1];
-        printf("Using Lua script from arg: %s\n", lua_script);
-    }
-    bool use_lua = false;
+    const char* lua_script = config.script;
     if (file_exists(lua_script)) {
         use_lua = lua_load_script(lua_script);
         if (!use_lua) {
@@ -229,37 +328,68 @@ int main(int argc, char** argv) {
 
     // Main loop
     while (!glfwWindowShouldClose(window)) {
-        float time = (float)glfwGetTime();
+        if (!headless_is_active()) pacing_wait();  // Cap / late latch wait before input is polled
+        pipeline_acquire();     // Wait for a free slot before polling, keeps input fresh
+        float time = (float)app_clock_now();
         
-        // Auto-rotate cube
-        if (!use_lua || igIsItemActive() == false) {
+        // Auto-rotate cube, held still in idle mode so it doesn't keep every frame awake
+        if (!idle_is_enabled() && (!use_lua || igIsItemActive() == false)) {
             // rotation = fmodf(time * 30.0f, 360.0f);
             rotation = fmodf(time * 90.0f, 360.0f);
         }
 
-        glfwPollEvents();
-        glfwGetFramebufferSize(window, &screenWidth, &screenHeight);
+        PROFILE_BEGIN(PROF_EVENTS);
+        if (headless_is_active()) {
+            glfwPollEvents();
+        } else if (idle_poll_events()) {
+            pacing_mark_idle();     // Blocked until input/timeout, not a paced frame
+        }
+        PROFILE_END(PROF_EVENTS);
+        pipeline_mark_input();
+        batch_begin_frame();
+        if (headless_is_active()) {
+            headless_begin_frame();     // Fixed size offscreen target
+        } else {
+            glfwGetFramebufferSize(window, &screenWidth, &screenHeight);
+            pipeline_begin_frame(screenWidth, screenHeight);   // No-op unless pipelined
+        }
+        camera_set_viewport(camera, screenWidth, screenHeight);   // No-op unless resized
+        gpu_timer_begin_frame();
+        scene_scale_begin(screenWidth, screenHeight);   // 3D into the scaled target when enabled
+        gpu_timer_begin(GPU_PASS_CLEAR);
         rlClearScreenBuffers();
+        gpu_timer_end(GPU_PASS_CLEAR);
 
         // ImGui frame start
-        ImGui_ImplOpenGL3_NewFrame();
+        PROFILE_BEGIN(PROF_NEW_FRAME);
+        imgui_renderer_new_frame();
         ImGui_ImplGlfw_NewFrame();
+        if (app_clock_is_fixed()) ioptr->DeltaTime = (float)config.fixedStep;
 
         bool showDemoWindow = true;
         
         if (use_lua) {
             // For Lua: Call cimgui_call_draw if implemented, then draw
             igNewFrame();
+            PROFILE_END(PROF_NEW_FRAME);
+            PROFILE_BEGIN(PROF_DRAW);
             cimgui_call_draw();  // Call script's draw()
             // enet_update(); // Add network processing // better to single loop from cimgui_call_draw()
 
             //show demo for refs.
             if (showDemoWindow)
                 igShowDemoWindow(&showDemoWindow);
+            perf_overlay_draw();
+            PROFILE_END(PROF_DRAW);
+            PROFILE_BEGIN(PROF_IMGUI_RENDER);
             igRender();
+            PROFILE_END(PROF_IMGUI_RENDER);
+            idle_end_frame();
         } else {
             // Default UI
             igNewFrame();
+            PROFILE_END(PROF_NEW_FRAME);
+            PROFILE_BEGIN(PROF_DRAW);
             igBegin("Hello, world!", NULL, 0);
             igText("This is some useful text.");
             igText("3D Cube should now rotate below!");
@@ -268,15 +398,26 @@ int main(int argc, char** argv) {
                 // Slider changed
             }
             igEnd();
+            perf_overlay_draw();
+            PROFILE_END(PROF_DRAW);
+            PROFILE_BEGIN(PROF_IMGUI_RENDER);
             igRender();
+            PROFILE_END(PROF_IMGUI_RENDER);
+            idle_end_frame();
         }
-
-        // 3D Rendering (unchanged)
-        float aspect = (float)screenWidth / (float)screenHeight;
-        Matrix proj = MatrixPerspective(camera.fovy * DEG2RAD, aspect, 0.1f, 1000.0f);
-        rlSetMatrixProjection(proj);
-
-        Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+        font_cache_update();    // Outside the frame: add loaded fonts, prewarm cached glyphs
+        image_cache_update();   // Budgeted texture uploads, shown from the next frame
+
+        // 3D Rendering, view/projection come from the camera cache
+        PROFILE_BEGIN(PROF_SCENE);
+        // GPU scene time starts here: before, the GPU only waits on the CPU
+        // building ImGui and running draw() (its rl calls are batched until the flush)
+        gpu_timer_begin(GPU_PASS_SCENE);
+        scene_scale_pass_begin();
+        camera_update(camera);
+        rlSetMatrixProjection(camera->projection);
+
+        Matrix view = camera->view;
         Matrix rot = MatrixRotateY(rotation * DEG2RAD);
         Matrix trans = MatrixTranslate(cubePosition.x, cubePosition.y, cubePosition.z);
         Matrix model = MatrixMultiply(rot, trans);
@@ -288,17 +429,49 @@ int main(int argc, char** argv) {
 
         // raylib works
         DrawCube(cubePosition, 0.1f, 0.1f, 0.5f, RED); // Use raylib's DrawCube for default UI
-
-
-        rlDrawRenderBatchActive();
-
-        // Reset state for ImGui ???
-        // glUseProgram(0);
-        ImGui_ImplOpenGL3_RenderDrawData(igGetDrawData());
-        glfwSwapBuffers(window);
+        PROFILE_END(PROF_SCENE);
+
+        PROFILE_BEGIN(PROF_FLUSH);
+        batch_flush();
+        scene_scale_end();      // Resolve + upscale, ImGui then draws at native size
+        batch_end_frame();
+        PROFILE_END(PROF_FLUSH);
+        gpu_timer_end(GPU_PASS_SCENE);
+
+        if (pipeline_is_active()) {
+            // Render thread blits the 3D target, draws ImGui and swaps
+            pacing_before_swap();
+            PROFILE_BEGIN(PROF_UI_RENDER);
+            pipeline_submit(igGetDrawData());
+            PROFILE_END(PROF_UI_RENDER);
+            pacing_after_swap();
+        } else if (headless_is_active()) {
+            PROFILE_BEGIN(PROF_UI_RENDER);
+            gpu_timer_begin(GPU_PASS_UI);
+            ui_layer_render(igGetDrawData(), screenWidth, screenHeight);
+            gpu_timer_end(GPU_PASS_UI);
+            PROFILE_END(PROF_UI_RENDER);
+            if (!headless_end_frame()) break;
+        } else {
+            // ImGui is redrawn only when its draw data changed, else the cached layer is composited
+            PROFILE_BEGIN(PROF_UI_RENDER);
+            gpu_timer_begin(GPU_PASS_UI);
+            ui_layer_render(igGetDrawData(), screenWidth, screenHeight);
+            gpu_timer_end(GPU_PASS_UI);
+            PROFILE_END(PROF_UI_RENDER);
+            pacing_before_swap();
+            PROFILE_BEGIN(PROF_SWAP);
+            gpu_timer_begin(GPU_PASS_SWAP);
+            glfwSwapBuffers(window);
+            gpu_timer_end(GPU_PASS_SWAP);
+            PROFILE_END(PROF_SWAP);
+            pacing_after_swap();
+            pipeline_mark_presented();
+        }
+        profiler_frame();
     }
 
-    // Cleanup
+cleanup:
     if (use_lua) {
         lua_State* L = lua_get_state();
         if (L) {
@@ -310,10 +483,30 @@ int main(int argc, char** argv) {
             lua_settop(L, 0);
         }
     }
+    pipeline_stop();     // Presents queued frames, the render thread is gone after this
+    imgui_rlgl_shutdown(); // While the ImGui context still exists
+    font_cleanup();        // Saves glyph tables, needs the atlas
+    image_cleanup();       // Textures may be drawn by the render thread until pipeline_stop
     enet_cleanup();      // Call before Lua close
+    schema_cleanup();
+    replication_cleanup();
     cimgui_cleanup();    // Call before Lua close
     lua_cleanup();       // Now safe to close Lua state
+    packet_pool_cleanup(); // After Lua close so packet __gc ran first
+    instancing_cleanup(); // After Lua close so batch __gc ran first
+    shader_cleanup();     // After everything that releases cached programs
+    scene_cleanup();
+    camera_cleanup();
+    culling_cleanup();
+    batch_cleanup();
+    headless_end();       // Prints the JSON report
+    pacing_cleanup();
+    app_cleanup();
+    ui_layer_cleanup();
+    scene_scale_cleanup();
+    gpu_timer_cleanup();
     rlglClose();
+    pipeline_cleanup();
     glfwDestroyWindow(window);
     glfwTerminate();
 
@@ -335,7 +528,7 @@ int main(int argc, char** argv) {
     // rlglClose();
     // glfwDestroyWindow(window);
     // glfwTerminate();
-    return 0;
+    return exitCode;
 }
 
 // Add the file_exists function from module_raylib_lua.c to main file or include the header
@@ -357,12 +550,56 @@ static void ErrorCallback(int error, const char *description) {
 }
 
 static void KeyCallback(GLFWwindow *window, int key, int scancode, int action, int mods) {
+    idle_notify_input();
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, GL_TRUE);
     }
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS) {
+        perf_overlay_toggle();
+    }
+    if (key == GLFW_KEY_F4 && action == GLFW_PRESS) {
+        profiler_set_enabled(!profiler_enabled);
+    }
+}
+
+// Window + GL 3.3 core context, hidden for headless runs
+static GLFWwindow *CreateAppWindow(const AppConfig *config, int width, int height) {
+    // With dynamic resolution the 3D target carries the MSAA, the window needs none.
+    // Pipelined frames are blitted from single-sample slots, which GL refuses
+    // into a multisampled default framebuffer
+    bool ownTarget = config->headless || config->dynres > 0.0 || config->pipelineDepth > 0;
+    glfwWindowHint(GLFW_SAMPLES, ownTarget ? 0 : config->msaa);
+    glfwWindowHint(GLFW_DEPTH_BITS, 16);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (config->headless) glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    return glfwCreateWindow(width, height, "rlgl + ImGui + 3D Cube", NULL, NULL);
+}
+
+static void CursorPosCallback(GLFWwindow *window, double x, double y) {
+    idle_notify_input();
+}
+
+static void MouseButtonCallback(GLFWwindow *window, int button, int action, int mods) {
+    idle_notify_input();
+}
+
+static void ScrollCallback(GLFWwindow *window, double x, double y) {
+    idle_notify_input();
+}
+
+static void CharCallback(GLFWwindow *window, unsigned int codepoint) {
+    idle_notify_input();
+}
+
+// Exposed/damaged window needs a frame even when nothing changed
+static void WindowRefreshCallback(GLFWwindow *window) {
+    idle_notify_input();
 }
 
 // Resize callback: Update viewport
 static void FramebufferSizeCallback(GLFWwindow* window, int width, int height) {
+    idle_notify_input();
     rlViewport(0, 0, width, height);
 }
\ No newline at end of file
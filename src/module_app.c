@@ -0,0 +1,264 @@
+// module_app.c
+// Lua 'app' table for main loop settings.
+#include "module_app.h"
+#include "module_lua.h"
+#include "frame_pacing.h"
+#include "idle_mode.h"
+#include "ui_layer.h"
+#include "render_pipeline.h"
+#include "gpu_timer.h"
+#include "profiler.h"
+#include "scene_scale.h"
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+#include <stdio.h>
+
+// app.set_pacing(mode, [fps]) - mode: "vsync", "novsync", "cap", "latelatch"
+static int l_app_set_pacing(lua_State *L) {
+    const char *name = luaL_checkstring(L, 1);
+    PacingMode mode;
+    if (!pacing_mode_from_name(name, &mode)) {
+        return luaL_error(L, "unknown pacing mode '%s'", name);
+    }
+    pacing_set_mode(mode, luaL_optnumber(L, 2, 0.0));
+    return 0;
+}
+
+// app.get_pacing() -> mode, fps
+static int l_app_get_pacing(lua_State *L) {
+    lua_pushstring(L, pacing_mode_name(pacing_get_mode()));
+    lua_pushnumber(L, pacing_get_fps());
+    return 2;
+}
+
+// app.get_frame_stats() -> { samples, avgMs, jitterMs, minMs, maxMs, p99Ms, latchMs }
+static int l_app_get_frame_stats(lua_State *L) {
+    PacingStats stats = pacing_get_stats();
+    lua_createtable(L, 0, 7);
+    lua_pushinteger(L, stats.samples);  lua_setfield(L, -2, "samples");
+    lua_pushnumber(L, stats.avgMs);     lua_setfield(L, -2, "avgMs");
+    lua_pushnumber(L, stats.jitterMs);  lua_setfield(L, -2, "jitterMs");
+    lua_pushnumber(L, stats.minMs);     lua_setfield(L, -2, "minMs");
+    lua_pushnumber(L, stats.maxMs);     lua_setfield(L, -2, "maxMs");
+    lua_pushnumber(L, stats.p99Ms);     lua_setfield(L, -2, "p99Ms");
+    lua_pushnumber(L, stats.latchMs);   lua_setfield(L, -2, "latchMs");
+    return 1;
+}
+
+// app.set_idle(enabled, [timeout]) - only render on input, animation or request
+static int l_app_set_idle(lua_State *L) {
+    idle_set_enabled(lua_toboolean(L, 1), luaL_optnumber(L, 2, 0.0));
+    return 0;
+}
+
+// app.request_redraw() - render at least one more frame
+static int l_app_request_redraw(lua_State *L) {
+    idle_request_redraw();
+    return 0;
+}
+
+// app.animate_for(seconds) - keep rendering every frame until the deadline
+static int l_app_animate_for(lua_State *L) {
+    idle_animate_for(luaL_checknumber(L, 1));
+    return 0;
+}
+
+// app.get_idle_stats() -> { enabled, timeout, waits, frames }
+static int l_app_get_idle_stats(lua_State *L) {
+    IdleStats stats = idle_get_stats();
+    lua_createtable(L, 0, 4);
+    lua_pushboolean(L, stats.enabled);  lua_setfield(L, -2, "enabled");
+    lua_pushnumber(L, stats.timeout);   lua_setfield(L, -2, "timeout");
+    lua_pushinteger(L, stats.waits);    lua_setfield(L, -2, "waits");
+    lua_pushinteger(L, stats.frames);   lua_setfield(L, -2, "frames");
+    return 1;
+}
+
+// app.invalidate_ui() - redraw the cached ImGui layer next frame
+static int l_app_invalidate_ui(lua_State *L) {
+    ui_layer_invalidate();
+    return 0;
+}
+
+// app.set_ui_rate(hz) - max UI redraws per second, 0 = every change
+static int l_app_set_ui_rate(lua_State *L) {
+    ui_layer_set_rate(luaL_checknumber(L, 1));
+    return 0;
+}
+
+// app.get_ui_rate() -> hz
+static int l_app_get_ui_rate(lua_State *L) {
+    lua_pushnumber(L, ui_layer_get_rate());
+    return 1;
+}
+
+// app.get_ui_stats() -> { enabled, frames, redraws, deferred, cached, hashMs }
+static int l_app_get_ui_stats(lua_State *L) {
+    UiLayerStats stats = ui_layer_get_stats();
+    lua_createtable(L, 0, 6);
+    lua_pushboolean(L, ui_layer_is_enabled()); lua_setfield(L, -2, "enabled");
+    lua_pushinteger(L, stats.frames);   lua_setfield(L, -2, "frames");
+    lua_pushinteger(L, stats.redraws);  lua_setfield(L, -2, "redraws");
+    lua_pushinteger(L, stats.deferred); lua_setfield(L, -2, "deferred");
+    lua_pushboolean(L, stats.cached);   lua_setfield(L, -2, "cached");
+    lua_pushnumber(L, stats.hashMs);    lua_setfield(L, -2, "hashMs");
+    return 1;
+}
+
+// app.get_pipeline_stats() -> { active, depth, samples, latencyMs, latencyP99Ms, latencyMaxMs, buildMs, stallMs, presentMs }
+static int l_app_get_pipeline_stats(lua_State *L) {
+    PipelineStats stats = pipeline_get_stats();
+    lua_createtable(L, 0, 9);
+    lua_pushboolean(L, stats.active);       lua_setfield(L, -2, "active");
+    lua_pushinteger(L, stats.depth);        lua_setfield(L, -2, "depth");
+    lua_pushinteger(L, stats.samples);      lua_setfield(L, -2, "samples");
+    lua_pushnumber(L, stats.latencyMs);     lua_setfield(L, -2, "latencyMs");
+    lua_pushnumber(L, stats.latencyP99Ms);  lua_setfield(L, -2, "latencyP99Ms");
+    lua_pushnumber(L, stats.latencyMaxMs);  lua_setfield(L, -2, "latencyMaxMs");
+    lua_pushnumber(L, stats.buildMs);       lua_setfield(L, -2, "buildMs");
+    lua_pushnumber(L, stats.stallMs);       lua_setfield(L, -2, "stallMs");
+    lua_pushnumber(L, stats.presentMs);     lua_setfield(L, -2, "presentMs");
+    return 1;
+}
+
+// app.set_dynres(targetMs) - 3D pass resolution/MSAA follow the target, 0 = off
+static int l_app_set_dynres(lua_State *L) {
+    scene_scale_set_target(luaL_checknumber(L, 1));
+    return 0;
+}
+
+// app.get_dynres_stats() -> { enabled, scale, samples, width, height, level, levels, targetMs, measuredMs, changes }
+static int l_app_get_dynres_stats(lua_State *L) {
+    SceneScaleStats stats = scene_scale_get_stats();
+    lua_createtable(L, 0, 10);
+    lua_pushboolean(L, stats.enabled);      lua_setfield(L, -2, "enabled");
+    lua_pushnumber(L, stats.scale);         lua_setfield(L, -2, "scale");
+    lua_pushinteger(L, stats.samples);      lua_setfield(L, -2, "samples");
+    lua_pushinteger(L, stats.width);        lua_setfield(L, -2, "width");
+    lua_pushinteger(L, stats.height);       lua_setfield(L, -2, "height");
+    lua_pushinteger(L, stats.level);        lua_setfield(L, -2, "level");
+    lua_pushinteger(L, stats.levels);       lua_setfield(L, -2, "levels");
+    lua_pushnumber(L, stats.targetMs);      lua_setfield(L, -2, "targetMs");
+    lua_pushnumber(L, stats.measuredMs);    lua_setfield(L, -2, "measuredMs");
+    lua_pushinteger(L, stats.changes);      lua_setfield(L, -2, "changes");
+    return 1;
+}
+
+// app.set_gpu_timers(enabled)
+static int l_app_set_gpu_timers(lua_State *L) {
+    gpu_timer_set_enabled(lua_toboolean(L, 1));
+    return 0;
+}
+
+// app.get_gpu_times([history]) -> { clear = { samples, lastMs, avgMs, p95Ms, maxMs, [history] }, scene, ui, swap, skipped }
+static int l_app_get_gpu_times(lua_State *L) {
+    bool withHistory = lua_toboolean(L, 1);
+    lua_createtable(L, 0, GPU_PASS_COUNT + 2);
+    for (int p = 0; p < GPU_PASS_COUNT; ++p) {
+        GpuPassStats stats = gpu_timer_get_stats((GpuPass)p);
+        lua_createtable(L, 0, 6);
+        lua_pushinteger(L, stats.samples);  lua_setfield(L, -2, "samples");
+        lua_pushnumber(L, stats.lastMs);    lua_setfield(L, -2, "lastMs");
+        lua_pushnumber(L, stats.avgMs);     lua_setfield(L, -2, "avgMs");
+        lua_pushnumber(L, stats.p95Ms);     lua_setfield(L, -2, "p95Ms");
+        lua_pushnumber(L, stats.maxMs);     lua_setfield(L, -2, "maxMs");
+        if (withHistory) {
+            int count = 0, offset = 0;
+            const float *ms = gpu_timer_get_history((GpuPass)p, &count, &offset);
+            lua_createtable(L, count, 0);
+            for (int i = 0; i < count; ++i) {
+                lua_pushnumber(L, ms[(offset + i) % GPU_TIMER_HISTORY]);
+                lua_rawseti(L, -2, i + 1);
+            }
+            lua_setfield(L, -2, "history");     // Oldest first
+        }
+        lua_setfield(L, -2, gpu_timer_pass_name((GpuPass)p));
+    }
+    lua_pushinteger(L, gpu_timer_get_skipped());    lua_setfield(L, -2, "skipped");
+    lua_pushboolean(L, gpu_timer_is_enabled());     lua_setfield(L, -2, "enabled");
+    return 1;
+}
+
+// app.set_profiler(enabled)
+static int l_app_set_profiler(lua_State *L) {
+    profiler_set_enabled(lua_toboolean(L, 1));
+    return 0;
+}
+
+// app.profile_begin(name) - scope times add up per frame
+static int l_app_profile_begin(lua_State *L) {
+    if (!profiler_enabled) return 0;
+    profiler_begin(profiler_register(luaL_checkstring(L, 1)));
+    return 0;
+}
+
+// app.profile_end(name)
+static int l_app_profile_end(lua_State *L) {
+    if (!profiler_enabled) return 0;
+    profiler_end(profiler_find(luaL_checkstring(L, 1)));
+    return 0;
+}
+
+// app.get_profile() -> { { name, samples, lastMs, avgMs, p50Ms, p95Ms, p99Ms, maxMs }, ... }
+static int l_app_get_profile(lua_State *L) {
+    int count = profiler_get_scope_count();
+    lua_createtable(L, count, 0);
+    for (int i = 0; i < count; ++i) {
+        ProfilerStats stats = profiler_get_stats(i);
+        lua_createtable(L, 0, 8);
+        lua_pushstring(L, stats.name);      lua_setfield(L, -2, "name");
+        lua_pushinteger(L, stats.samples);  lua_setfield(L, -2, "samples");
+        lua_pushnumber(L, stats.lastMs);    lua_setfield(L, -2, "lastMs");
+        lua_pushnumber(L, stats.avgMs);     lua_setfield(L, -2, "avgMs");
+        lua_pushnumber(L, stats.p50Ms);     lua_setfield(L, -2, "p50Ms");
+        lua_pushnumber(L, stats.p95Ms);     lua_setfield(L, -2, "p95Ms");
+        lua_pushnumber(L, stats.p99Ms);     lua_setfield(L, -2, "p99Ms");
+        lua_pushnumber(L, stats.maxMs);     lua_setfield(L, -2, "maxMs");
+        lua_rawseti(L, -2, i + 1);
+    }
+    return 1;
+}
+
+static const struct luaL_Reg app_funcs[] = {
+    {"set_pacing", l_app_set_pacing},
+    {"get_pacing", l_app_get_pacing},
+    {"get_frame_stats", l_app_get_frame_stats},
+    {"set_idle", l_app_set_idle},
+    {"request_redraw", l_app_request_redraw},
+    {"animate_for", l_app_animate_for},
+    {"get_idle_stats", l_app_get_idle_stats},
+    {"invalidate_ui", l_app_invalidate_ui},
+    {"set_ui_rate", l_app_set_ui_rate},
+    {"get_ui_rate", l_app_get_ui_rate},
+    {"get_ui_stats", l_app_get_ui_stats},
+    {"get_pipeline_stats", l_app_get_pipeline_stats},
+    {"set_dynres", l_app_set_dynres},
+    {"get_dynres_stats", l_app_get_dynres_stats},
+    {"set_gpu_timers", l_app_set_gpu_timers},
+    {"get_gpu_times", l_app_get_gpu_times},
+    {"set_profiler", l_app_set_profiler},
+    {"profile_begin", l_app_profile_begin},
+    {"profile_end", l_app_profile_end},
+    {"get_profile", l_app_get_profile},
+    {NULL, NULL}
+};
+
+void app_init(void) {
+    lua_State *L = lua_get_state();
+    if (!L) {
+        printf("Error: No Lua state available in app_init\n");
+        return;
+    }
+
+    lua_newtable(L);
+    luaL_setfuncs(L, app_funcs, 0);
+    lua_setglobal(L, "app");
+    lua_settop(L, 0);
+
+    printf("app module initialized\n");
+}
+
+void app_cleanup(void) {
+    printf("app module cleaned up\n");
+}
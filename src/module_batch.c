@@ -0,0 +1,167 @@
+// module_batch.c
+// Owns the active rlgl render batch so its size and buffer count can be
+// configured, and counts flushes/vertices/draw calls per frame.
+//
+// rlgl flushes on its own when a buffer or the draw call list fills up, and
+// on state changes (blend mode, shader, framebuffer switches). Those internal
+// flushes are detected at sample points: every rlDrawRenderBatch() advances
+// currentBuffer and resets currentDepth, so a change since the last sample
+// means rlgl submitted mid-frame. The cause can't be told apart from here,
+// and a flush is attributed at the next sample (rlEnd or our own flush).
+#include "module_batch.h"
+#include "module_lua.h"
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+#include <stdio.h>
+#include <string.h>
+#include "rlgl.h"
+
+static rlRenderBatch g_batch = { 0 };
+static bool g_batch_loaded = false;
+static int g_last_buffer = 0;       // currentBuffer at last sample
+static float g_last_depth = 0.0f;   // currentDepth at last sample
+static int g_pending_vertices = 0;  // Vertices queued at last sample
+static int g_pending_draws = 0;     // Non-empty draw calls queued at last sample
+static BatchStats g_frame = { 0 };  // Counting frame
+static BatchStats g_last = { 0 };   // Last completed frame
+
+// Count what is queued in the current buffer
+static void count_pending(int *vertices, int *draws) {
+    int v = 0;
+    int d = 0;
+    for (int i = 0; i < g_batch.drawCounter; ++i) {
+        if (g_batch.draws[i].vertexCount > 0) {
+            v += g_batch.draws[i].vertexCount;
+            d++;
+        }
+    }
+    *vertices = v;
+    *draws = d;
+}
+
+void batch_load(int bufferCount, int bufferElements) {
+    if (g_batch_loaded) return;
+    g_batch = rlLoadRenderBatch(bufferCount, bufferElements);
+    rlSetRenderBatchActive(&g_batch);
+    g_batch_loaded = true;
+    g_last_buffer = g_batch.currentBuffer;
+    g_last_depth = g_batch.currentDepth;
+    printf("Render batch: %d buffers x %d elements\n", bufferCount, bufferElements);
+}
+
+void batch_sample(void) {
+    if (!g_batch_loaded) return;
+
+    int internal = (g_batch.currentBuffer - g_last_buffer + g_batch.bufferCount) % g_batch.bufferCount;
+    if (internal == 0 && g_batch.currentDepth < g_last_depth) {
+        internal = g_batch.bufferCount;    // Wrapped around the whole ring
+    }
+    if (internal > 0) {
+        g_frame.flushes += internal;
+        g_frame.internalFlushes += internal;
+        g_frame.vertices += g_pending_vertices;
+        g_frame.drawCalls += (g_pending_draws > 0) ? g_pending_draws : internal;
+    }
+
+    count_pending(&g_pending_vertices, &g_pending_draws);
+    g_last_buffer = g_batch.currentBuffer;
+    g_last_depth = g_batch.currentDepth;
+}
+
+void batch_flush(void) {
+    if (!g_batch_loaded) {
+        rlDrawRenderBatchActive();
+        return;
+    }
+
+    batch_sample();
+    if (g_pending_vertices > 0) {
+        g_frame.flushes++;
+        g_frame.vertices += g_pending_vertices;
+        g_frame.drawCalls += g_pending_draws;
+    }
+    rlDrawRenderBatchActive();
+
+    // Our own flush advanced the ring, don't count it again
+    g_pending_vertices = 0;
+    g_pending_draws = 0;
+    g_last_buffer = g_batch.currentBuffer;
+    g_last_depth = g_batch.currentDepth;
+}
+
+void batch_begin_frame(void) {
+    memset(&g_frame, 0, sizeof(g_frame));
+}
+
+void batch_end_frame(void) {
+    batch_sample();
+    g_last = g_frame;
+}
+
+BatchStats batch_get_stats(void) {
+    return g_last;
+}
+
+int batch_get_buffer_count(void) {
+    return g_batch_loaded ? g_batch.bufferCount : 0;
+}
+
+int batch_get_buffer_elements(void) {
+    return (g_batch_loaded && g_batch.vertexBuffer) ? g_batch.vertexBuffer[0].elementCount : 0;
+}
+
+// rl.GetBatchStats() -> { flushes, internalFlushes, vertices, drawCalls, buffers, elements }
+static int lua_raylib_get_batch_stats(lua_State *L) {
+    BatchStats stats = batch_get_stats();
+    lua_createtable(L, 0, 6);
+    lua_pushinteger(L, stats.flushes);         lua_setfield(L, -2, "flushes");
+    lua_pushinteger(L, stats.internalFlushes); lua_setfield(L, -2, "internalFlushes");
+    lua_pushinteger(L, stats.vertices);        lua_setfield(L, -2, "vertices");
+    lua_pushinteger(L, stats.drawCalls);       lua_setfield(L, -2, "drawCalls");
+    lua_pushinteger(L, batch_get_buffer_count());    lua_setfield(L, -2, "buffers");
+    lua_pushinteger(L, batch_get_buffer_elements()); lua_setfield(L, -2, "elements");
+    return 1;
+}
+
+// rl.rlDrawRenderBatchActive() - explicit flush (counted)
+static int lua_raylib_draw_render_batch_active(lua_State *L) {
+    batch_flush();
+    return 0;
+}
+
+static const struct luaL_Reg batch_funcs[] = {
+    {"GetBatchStats", lua_raylib_get_batch_stats},
+    {"rlDrawRenderBatchActive", lua_raylib_draw_render_batch_active},
+    {NULL, NULL}
+};
+
+// Add batch functions to the global 'rl' table (call after raylib_init)
+void batch_init(void) {
+    lua_State *L = lua_get_state();
+    if (!L) {
+        printf("Error: No Lua state available in batch_init\n");
+        return;
+    }
+
+    lua_getglobal(L, "rl");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setglobal(L, "rl");
+    }
+    luaL_setfuncs(L, batch_funcs, 0);
+    lua_settop(L, 0);
+
+    printf("batch module initialized\n");
+}
+
+void batch_cleanup(void) {
+    if (g_batch_loaded) {
+        rlSetRenderBatchActive(NULL);   // Flushes ours and restores the rlgl default batch
+        rlUnloadRenderBatch(g_batch);
+        g_batch_loaded = false;
+    }
+    printf("batch module cleaned up\n");
+}
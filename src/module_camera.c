@@ -0,0 +1,347 @@
+// module_camera.c
+// C-owned camera with cached view/projection/view-projection matrices.
+#include "module_camera.h"
+#include "module_raylib.h"
+#include "module_lua.h"
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "rlgl.h"
+#include "raymath.h"
+
+#define CAMERA_MT "rl.Camera"
+
+// Lua side handle, the main camera is not owned by Lua
+typedef struct CameraHandle {
+    CachedCamera *camera;
+    bool owned;
+} CameraHandle;
+
+static CachedCamera g_main_camera;
+
+static bool vector3_equal(Vector3 a, Vector3 b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+void camera_setup(CachedCamera *camera, Vector3 position, Vector3 target, Vector3 up, float fovy) {
+    memset(camera, 0, sizeof(CachedCamera));
+    camera->position = position;
+    camera->target = target;
+    camera->up = up;
+    camera->fovy = fovy;
+    camera->aspect = 16.0f/9.0f;
+    camera->nearPlane = 0.1f;
+    camera->farPlane = 1000.0f;
+    camera->viewDirty = true;
+    camera->projectionDirty = true;
+}
+
+void camera_set_position(CachedCamera *camera, Vector3 position) {
+    if (vector3_equal(camera->position, position)) return;
+    camera->position = position;
+    camera->viewDirty = true;
+}
+
+void camera_set_target(CachedCamera *camera, Vector3 target) {
+    if (vector3_equal(camera->target, target)) return;
+    camera->target = target;
+    camera->viewDirty = true;
+}
+
+void camera_set_up(CachedCamera *camera, Vector3 up) {
+    if (vector3_equal(camera->up, up)) return;
+    camera->up = up;
+    camera->viewDirty = true;
+}
+
+void camera_set_fovy(CachedCamera *camera, float fovy) {
+    if (camera->fovy == fovy) return;
+    camera->fovy = fovy;
+    camera->projectionDirty = true;
+}
+
+void camera_set_clip(CachedCamera *camera, float nearPlane, float farPlane) {
+    if (camera->nearPlane == nearPlane && camera->farPlane == farPlane) return;
+    camera->nearPlane = nearPlane;
+    camera->farPlane = farPlane;
+    camera->projectionDirty = true;
+}
+
+void camera_set_viewport(CachedCamera *camera, int width, int height) {
+    if (width <= 0 || height <= 0) return;   // Minimized window
+    if (camera->viewportWidth == width && camera->viewportHeight == height) return;
+    camera->viewportWidth = width;
+    camera->viewportHeight = height;
+    camera->aspect = (float)width/(float)height;
+    camera->projectionDirty = true;
+}
+
+void camera_update(CachedCamera *camera) {
+    if (!camera->viewDirty && !camera->projectionDirty) return;
+    if (camera->viewDirty) {
+        camera->view = MatrixLookAt(camera->position, camera->target, camera->up);
+    }
+    if (camera->projectionDirty) {
+        camera->projection = MatrixPerspective(camera->fovy*DEG2RAD, camera->aspect, camera->nearPlane, camera->farPlane);
+    }
+    camera->viewProjection = MatrixMultiply(camera->view, camera->projection);
+    camera->invViewProjection = MatrixInvert(camera->viewProjection);
+    camera->frustum = frustum_from_matrix(camera->viewProjection);
+    camera->viewDirty = false;
+    camera->projectionDirty = false;
+    camera->version++;
+}
+
+void camera_apply(CachedCamera *camera) {
+    camera_update(camera);
+    rlSetMatrixProjection(camera->projection);
+    rlSetMatrixModelview(camera->view);
+}
+
+// Unproject a clip space point through the cached inverse view-projection
+static Vector3 unproject(const Matrix *m, float x, float y, float z) {
+    float rx = m->m0*x + m->m4*y + m->m8*z + m->m12;
+    float ry = m->m1*x + m->m5*y + m->m9*z + m->m13;
+    float rz = m->m2*x + m->m6*y + m->m10*z + m->m14;
+    float rw = m->m3*x + m->m7*y + m->m11*z + m->m15;
+    if (rw != 0.0f) { rx /= rw; ry /= rw; rz /= rw; }
+    return (Vector3){ rx, ry, rz };
+}
+
+void camera_screen_ray(CachedCamera *camera, float screenX, float screenY, Vector3 *origin, Vector3 *direction) {
+    camera_update(camera);
+    float width = (camera->viewportWidth > 0) ? (float)camera->viewportWidth : 1.0f;
+    float height = (camera->viewportHeight > 0) ? (float)camera->viewportHeight : 1.0f;
+    float x = 2.0f*screenX/width - 1.0f;
+    float y = 1.0f - 2.0f*screenY/height;
+    Vector3 nearPoint = unproject(&camera->invViewProjection, x, y, -1.0f);
+    Vector3 farPoint = unproject(&camera->invViewProjection, x, y, 1.0f);
+    *origin = nearPoint;
+    *direction = Vector3Normalize(Vector3Subtract(farPoint, nearPoint));
+}
+
+CachedCamera *camera_get_main(void) {
+    return &g_main_camera;
+}
+
+//----------------------------------------------------------------------------------
+// Lua bindings
+//----------------------------------------------------------------------------------
+CachedCamera *camera_test_lua(lua_State *L, int index) {
+    CameraHandle *handle = (CameraHandle*)luaL_testudata(L, index, CAMERA_MT);
+    return handle ? handle->camera : NULL;
+}
+
+CachedCamera *camera_check_lua(lua_State *L, int index) {
+    CameraHandle *handle = (CameraHandle*)luaL_checkudata(L, index, CAMERA_MT);
+    return handle->camera;
+}
+
+static void push_camera(lua_State *L, CachedCamera *camera, bool owned) {
+    CameraHandle *handle = (CameraHandle*)lua_newuserdata(L, sizeof(CameraHandle));
+    handle->camera = camera;
+    handle->owned = owned;
+    luaL_getmetatable(L, CAMERA_MT);
+    lua_setmetatable(L, -2);
+}
+
+static float opt_field(lua_State *L, int index, const char *name, float def) {
+    lua_getfield(L, index, name);
+    float value = lua_isnumber(L, -1) ? (float)lua_tonumber(L, -1) : def;
+    lua_pop(L, 1);
+    return value;
+}
+
+// rl.Camera({ position = {x,y,z}, target = {x,y,z}, up = {x,y,z}, fovy = 45, near = 0.1, far = 1000 })
+static int lua_raylib_camera(lua_State *L) {
+    CachedCamera *camera = (CachedCamera*)malloc(sizeof(CachedCamera));
+    if (!camera) return luaL_error(L, "out of memory");
+    camera_setup(camera, (Vector3){ 5.0f, 5.0f, 5.0f }, (Vector3){ 0.0f, 0.0f, 0.0f },
+                 (Vector3){ 0.0f, 1.0f, 0.0f }, 45.0f);
+
+    if (lua_istable(L, 1)) {
+        lua_getfield(L, 1, "position");
+        if (lua_istable(L, -1)) camera->position = get_vector3(L, lua_gettop(L));
+        lua_pop(L, 1);
+        lua_getfield(L, 1, "target");
+        if (lua_istable(L, -1)) camera->target = get_vector3(L, lua_gettop(L));
+        lua_pop(L, 1);
+        lua_getfield(L, 1, "up");
+        if (lua_istable(L, -1)) camera->up = get_vector3(L, lua_gettop(L));
+        lua_pop(L, 1);
+        camera->fovy = opt_field(L, 1, "fovy", camera->fovy);
+        camera->nearPlane = opt_field(L, 1, "near", camera->nearPlane);
+        camera->farPlane = opt_field(L, 1, "far", camera->farPlane);
+        camera->aspect = opt_field(L, 1, "aspect", camera->aspect);
+    }
+    push_camera(L, camera, true);
+    return 1;
+}
+
+// rl.GetCamera() - the camera main.c renders with
+static int lua_raylib_get_camera(lua_State *L) {
+    push_camera(L, &g_main_camera, false);
+    return 1;
+}
+
+static Vector3 check_xyz(lua_State *L, int index) {
+    if (lua_istable(L, index)) return get_vector3(L, index);
+    return (Vector3){ (float)luaL_checknumber(L, index), (float)luaL_checknumber(L, index + 1),
+                      (float)luaL_checknumber(L, index + 2) };
+}
+
+// camera:SetPosition(x, y, z) or camera:SetPosition({x, y, z})
+static int camera_method_set_position(lua_State *L) {
+    camera_set_position(camera_check_lua(L, 1), check_xyz(L, 2));
+    return 0;
+}
+
+static int camera_method_set_target(lua_State *L) {
+    camera_set_target(camera_check_lua(L, 1), check_xyz(L, 2));
+    return 0;
+}
+
+static int camera_method_set_up(lua_State *L) {
+    camera_set_up(camera_check_lua(L, 1), check_xyz(L, 2));
+    return 0;
+}
+
+static int camera_method_set_fovy(lua_State *L) {
+    camera_set_fovy(camera_check_lua(L, 1), (float)luaL_checknumber(L, 2));
+    return 0;
+}
+
+static int camera_method_set_clip(lua_State *L) {
+    camera_set_clip(camera_check_lua(L, 1), (float)luaL_checknumber(L, 2), (float)luaL_checknumber(L, 3));
+    return 0;
+}
+
+// camera:SetViewport(width, height) - also sets the aspect ratio
+static int camera_method_set_viewport(lua_State *L) {
+    camera_set_viewport(camera_check_lua(L, 1), (int)luaL_checkinteger(L, 2), (int)luaL_checkinteger(L, 3));
+    return 0;
+}
+
+static int camera_method_get_position(lua_State *L) {
+    push_vector3(L, camera_check_lua(L, 1)->position);
+    return 1;
+}
+
+static int camera_method_get_target(lua_State *L) {
+    push_vector3(L, camera_check_lua(L, 1)->target);
+    return 1;
+}
+
+static int camera_method_get_view_matrix(lua_State *L) {
+    CachedCamera *camera = camera_check_lua(L, 1);
+    camera_update(camera);
+    push_matrix(L, camera->view);
+    return 1;
+}
+
+static int camera_method_get_projection_matrix(lua_State *L) {
+    CachedCamera *camera = camera_check_lua(L, 1);
+    camera_update(camera);
+    push_matrix(L, camera->projection);
+    return 1;
+}
+
+static int camera_method_get_view_projection_matrix(lua_State *L) {
+    CachedCamera *camera = camera_check_lua(L, 1);
+    camera_update(camera);
+    push_matrix(L, camera->viewProjection);
+    return 1;
+}
+
+// camera:GetVersion() - changes only when the matrices were rebuilt
+static int camera_method_get_version(lua_State *L) {
+    CachedCamera *camera = camera_check_lua(L, 1);
+    camera_update(camera);
+    lua_pushinteger(L, camera->version);
+    return 1;
+}
+
+// camera:Apply() - set rlgl projection and modelview (view) from the cache
+static int camera_method_apply(lua_State *L) {
+    camera_apply(camera_check_lua(L, 1));
+    return 0;
+}
+
+// camera:GetRay(screenX, screenY) -> origin, direction
+static int camera_method_get_ray(lua_State *L) {
+    CachedCamera *camera = camera_check_lua(L, 1);
+    Vector3 origin, direction;
+    camera_screen_ray(camera, (float)luaL_checknumber(L, 2), (float)luaL_checknumber(L, 3), &origin, &direction);
+    push_vector3(L, origin);
+    push_vector3(L, direction);
+    return 2;
+}
+
+static int camera_gc(lua_State *L) {
+    CameraHandle *handle = (CameraHandle*)luaL_checkudata(L, 1, CAMERA_MT);
+    if (handle->owned && handle->camera) {
+        free(handle->camera);
+    }
+    handle->camera = NULL;
+    return 0;
+}
+
+static const struct luaL_Reg camera_methods[] = {
+    {"SetPosition", camera_method_set_position},
+    {"SetTarget", camera_method_set_target},
+    {"SetUp", camera_method_set_up},
+    {"SetFovy", camera_method_set_fovy},
+    {"SetClip", camera_method_set_clip},
+    {"SetViewport", camera_method_set_viewport},
+    {"GetPosition", camera_method_get_position},
+    {"GetTarget", camera_method_get_target},
+    {"GetViewMatrix", camera_method_get_view_matrix},
+    {"GetProjectionMatrix", camera_method_get_projection_matrix},
+    {"GetViewProjectionMatrix", camera_method_get_view_projection_matrix},
+    {"GetVersion", camera_method_get_version},
+    {"GetRay", camera_method_get_ray},
+    {"Apply", camera_method_apply},
+    {NULL, NULL}
+};
+
+static const struct luaL_Reg camera_funcs[] = {
+    {"Camera", lua_raylib_camera},
+    {"GetCamera", lua_raylib_get_camera},
+    {NULL, NULL}
+};
+
+// Add camera functions to the global 'rl' table (call after raylib_init)
+void camera_init(void) {
+    lua_State *L = lua_get_state();
+    if (!L) {
+        printf("Error: No Lua state available in camera_init\n");
+        return;
+    }
+
+    luaL_newmetatable(L, CAMERA_MT);
+    lua_newtable(L);
+    luaL_setfuncs(L, camera_methods, 0);
+    lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, camera_gc);
+    lua_setfield(L, -2, "__gc");
+    lua_pop(L, 1);
+
+    lua_getglobal(L, "rl");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setglobal(L, "rl");
+    }
+    luaL_setfuncs(L, camera_funcs, 0);
+    lua_settop(L, 0);
+
+    printf("camera module initialized\n");
+}
+
+void camera_cleanup(void) {
+    printf("camera module cleaned up\n");
+}
@@ -0,0 +1,590 @@
+// module_culling.c
+// Frustum culling over a dynamic AABB tree (BVH) kept in C.
+#include "module_culling.h"
+#include "module_raylib.h"
+#include "module_camera.h"
+#include "module_scene.h"
+#include "module_lua.h"
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include "rlgl.h"
+#include "raymath.h"
+
+#define BVH_NULL -1
+#define BVH_MARGIN 0.1f   // Fat box margin so small moves need no refit
+#define BVH_INDEX_BITS 20                           // Handle = generation << 20 | (index + 1)
+#define BVH_MAX_NODES ((1 << BVH_INDEX_BITS) - 1)
+#define BVH_GENERATION_MASK 0x7ff                   // 11 bits, handles stay positive
+
+typedef struct BvhNode {
+    CullAABB box;   // Fat box for leaves, union of children otherwise
+    CullAABB tight; // Exact leaf bounds for picking
+    int parent;
+    int child1;     // BVH_NULL for leaves
+    int child2;
+    int userId;     // Leaf payload
+    int next;       // Free list link
+    int generation; // Bumped on free, stale handles stop matching
+    bool used;
+} BvhNode;
+
+static BvhNode *g_nodes = NULL;
+static int g_capacity = 0;
+static int g_free = BVH_NULL;
+static int g_root = BVH_NULL;
+static int *g_stack = NULL;       // Traversal stack (capacity sized)
+static int *g_visible = NULL;     // Visible userIds from last cull
+static int g_visible_capacity = 0;
+static CullStats g_stats = {0};
+
+//----------------------------------------------------------------------------------
+// Box helpers
+//----------------------------------------------------------------------------------
+static CullAABB aabb_union(CullAABB a, CullAABB b) {
+    CullAABB r;
+    r.min.x = fminf(a.min.x, b.min.x); r.min.y = fminf(a.min.y, b.min.y); r.min.z = fminf(a.min.z, b.min.z);
+    r.max.x = fmaxf(a.max.x, b.max.x); r.max.y = fmaxf(a.max.y, b.max.y); r.max.z = fmaxf(a.max.z, b.max.z);
+    return r;
+}
+
+static float aabb_area(CullAABB b) {
+    float dx = b.max.x - b.min.x, dy = b.max.y - b.min.y, dz = b.max.z - b.min.z;
+    return 2.0f*(dx*dy + dy*dz + dz*dx);
+}
+
+static bool aabb_contains(CullAABB outer, CullAABB inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+           outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+static bool aabb_overlaps(CullAABB a, CullAABB b) {
+    return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y &&
+           a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+static bool aabb_equal(CullAABB a, CullAABB b) {
+    return memcmp(&a, &b, sizeof(CullAABB)) == 0;
+}
+
+static CullAABB aabb_fatten(CullAABB b) {
+    b.min.x -= BVH_MARGIN; b.min.y -= BVH_MARGIN; b.min.z -= BVH_MARGIN;
+    b.max.x += BVH_MARGIN; b.max.y += BVH_MARGIN; b.max.z += BVH_MARGIN;
+    return b;
+}
+
+//----------------------------------------------------------------------------------
+// Frustum
+//----------------------------------------------------------------------------------
+static Vector4 plane_normalize(float a, float b, float c, float d) {
+    float len = sqrtf(a*a + b*b + c*c);
+    if (len > 0.0f) { a /= len; b /= len; c /= len; d /= len; }
+    return (Vector4){ a, b, c, d };
+}
+
+// Gribb/Hartmann plane extraction, viewProj = MatrixMultiply(view, projection)
+Frustum frustum_from_matrix(Matrix m) {
+    Frustum f;
+    f.planes[0] = plane_normalize(m.m3 + m.m0, m.m7 + m.m4, m.m11 + m.m8,  m.m15 + m.m12); // Left
+    f.planes[1] = plane_normalize(m.m3 - m.m0, m.m7 - m.m4, m.m11 - m.m8,  m.m15 - m.m12); // Right
+    f.planes[2] = plane_normalize(m.m3 + m.m1, m.m7 + m.m5, m.m11 + m.m9,  m.m15 + m.m13); // Bottom
+    f.planes[3] = plane_normalize(m.m3 - m.m1, m.m7 - m.m5, m.m11 - m.m9,  m.m15 - m.m13); // Top
+    f.planes[4] = plane_normalize(m.m3 + m.m2, m.m7 + m.m6, m.m11 + m.m10, m.m15 + m.m14); // Near
+    f.planes[5] = plane_normalize(m.m3 - m.m2, m.m7 - m.m6, m.m11 - m.m10, m.m15 - m.m14); // Far
+    return f;
+}
+
+FrustumResult frustum_classify_aabb(const Frustum *frustum, CullAABB box) {
+    FrustumResult result = FRUSTUM_INSIDE;
+    for (int i = 0; i < 6; ++i) {
+        Vector4 p = frustum->planes[i];
+        // Farthest corner along the plane normal
+        float px = (p.x >= 0.0f) ? box.max.x : box.min.x;
+        float py = (p.y >= 0.0f) ? box.max.y : box.min.y;
+        float pz = (p.z >= 0.0f) ? box.max.z : box.min.z;
+        if (p.x*px + p.y*py + p.z*pz + p.w < 0.0f) return FRUSTUM_OUTSIDE;
+        // Nearest corner
+        float nx = (p.x >= 0.0f) ? box.min.x : box.max.x;
+        float ny = (p.y >= 0.0f) ? box.min.y : box.max.y;
+        float nz = (p.z >= 0.0f) ? box.min.z : box.max.z;
+        if (p.x*nx + p.y*ny + p.z*nz + p.w < 0.0f) result = FRUSTUM_INTERSECT;
+    }
+    return result;
+}
+
+//----------------------------------------------------------------------------------
+// Tree
+//----------------------------------------------------------------------------------
+static bool node_is_leaf(int index) {
+    return g_nodes[index].child1 == BVH_NULL;
+}
+
+static int node_alloc(void) {
+    if (g_free == BVH_NULL) {
+        if (g_capacity >= BVH_MAX_NODES) return BVH_NULL;
+        int newCapacity = (g_capacity == 0) ? 64 : g_capacity*2;
+        if (newCapacity > BVH_MAX_NODES) newCapacity = BVH_MAX_NODES;
+        BvhNode *nodes = (BvhNode*)realloc(g_nodes, (size_t)newCapacity*sizeof(BvhNode));
+        int *stack = (int*)realloc(g_stack, (size_t)newCapacity*sizeof(int));
+        if (!nodes || !stack) {
+            // Keep whichever block moved, the old pointers may be stale
+            if (nodes) g_nodes = nodes;
+            if (stack) g_stack = stack;
+            return BVH_NULL;
+        }
+        g_nodes = nodes;
+        g_stack = stack;
+        for (int i = g_capacity; i < newCapacity; ++i) {
+            g_nodes[i].used = false;
+            g_nodes[i].generation = 0;
+            g_nodes[i].next = (i + 1 < newCapacity) ? i + 1 : BVH_NULL;
+        }
+        g_free = g_capacity;
+        g_capacity = newCapacity;
+    }
+    int index = g_free;
+    g_free = g_nodes[index].next;
+    BvhNode *node = &g_nodes[index];
+    int generation = node->generation;
+    memset(node, 0, sizeof(BvhNode));
+    node->generation = generation;
+    node->parent = BVH_NULL;
+    node->child1 = BVH_NULL;
+    node->child2 = BVH_NULL;
+    node->next = BVH_NULL;
+    node->used = true;
+    return index;
+}
+
+static void node_free(int index) {
+    g_nodes[index].used = false;
+    g_nodes[index].generation = (g_nodes[index].generation + 1) & BVH_GENERATION_MASK;
+    g_nodes[index].next = g_free;
+    g_free = index;
+}
+
+// Recompute ancestor boxes, stop once a box no longer changes
+static void refit_up(int index) {
+    while (index != BVH_NULL) {
+        BvhNode *node = &g_nodes[index];
+        CullAABB box = aabb_union(g_nodes[node->child1].box, g_nodes[node->child2].box);
+        if (aabb_equal(box, node->box)) break;
+        node->box = box;
+        index = node->parent;
+    }
+}
+
+// Descend by surface area cost and pair the leaf with the cheapest sibling.
+// False when no node is left for the new parent, the leaf is then not in the tree
+static bool insert_leaf(int leaf) {
+    if (g_root == BVH_NULL) {
+        g_root = leaf;
+        g_nodes[leaf].parent = BVH_NULL;
+        return true;
+    }
+
+    CullAABB box = g_nodes[leaf].box;
+    int index = g_root;
+    while (!node_is_leaf(index)) {
+        BvhNode *node = &g_nodes[index];
+        float area = aabb_area(node->box);
+        float combined = aabb_area(aabb_union(node->box, box));
+        float cost = 2.0f*combined;
+        float inherit = 2.0f*(combined - area);
+
+        float cost1 = aabb_area(aabb_union(g_nodes[node->child1].box, box)) + inherit;
+        if (!node_is_leaf(node->child1)) cost1 -= aabb_area(g_nodes[node->child1].box);
+        float cost2 = aabb_area(aabb_union(g_nodes[node->child2].box, box)) + inherit;
+        if (!node_is_leaf(node->child2)) cost2 -= aabb_area(g_nodes[node->child2].box);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = (cost1 < cost2) ? node->child1 : node->child2;
+    }
+
+    int sibling = index;
+    int oldParent = g_nodes[sibling].parent;
+    int newParent = node_alloc();
+    if (newParent == BVH_NULL) return false;
+    g_nodes[newParent].parent = oldParent;
+    g_nodes[newParent].box = aabb_union(box, g_nodes[sibling].box);
+    g_nodes[newParent].child1 = sibling;
+    g_nodes[newParent].child2 = leaf;
+    g_nodes[newParent].userId = -1;
+    g_nodes[sibling].parent = newParent;
+    g_nodes[leaf].parent = newParent;
+
+    if (oldParent != BVH_NULL) {
+        if (g_nodes[oldParent].child1 == sibling) g_nodes[oldParent].child1 = newParent;
+        else g_nodes[oldParent].child2 = newParent;
+        refit_up(oldParent);
+    } else {
+        g_root = newParent;
+    }
+    return true;
+}
+
+static void remove_leaf(int leaf) {
+    if (leaf == g_root) {
+        g_root = BVH_NULL;
+        return;
+    }
+    int parent = g_nodes[leaf].parent;
+    int grandParent = g_nodes[parent].parent;
+    int sibling = (g_nodes[parent].child1 == leaf) ? g_nodes[parent].child2 : g_nodes[parent].child1;
+
+    if (grandParent != BVH_NULL) {
+        if (g_nodes[grandParent].child1 == parent) g_nodes[grandParent].child1 = sibling;
+        else g_nodes[grandParent].child2 = sibling;
+        g_nodes[sibling].parent = grandParent;
+        node_free(parent);
+        refit_up(grandParent);
+    } else {
+        g_root = sibling;
+        g_nodes[sibling].parent = BVH_NULL;
+        node_free(parent);
+    }
+    g_nodes[leaf].parent = BVH_NULL;
+}
+
+static int leaf_handle(int leaf) {
+    return (g_nodes[leaf].generation << BVH_INDEX_BITS) | (leaf + 1);
+}
+
+// BVH_NULL for stale handles, a removed leaf's node may belong to another object now
+static int handle_to_leaf(int handle) {
+    if (handle <= 0) return BVH_NULL;
+    int index = (handle & BVH_MAX_NODES) - 1;
+    if (index < 0 || index >= g_capacity) return BVH_NULL;
+    if (!g_nodes[index].used || !node_is_leaf(index)) return BVH_NULL;
+    if (g_nodes[index].generation != (handle >> BVH_INDEX_BITS)) return BVH_NULL;
+    return index;
+}
+
+int culling_insert(CullAABB box, int userId) {
+    int leaf = node_alloc();
+    if (leaf == BVH_NULL) return 0;
+    g_nodes[leaf].box = aabb_fatten(box);
+    g_nodes[leaf].tight = box;
+    g_nodes[leaf].userId = (userId != 0) ? userId : leaf_handle(leaf);
+    if (!insert_leaf(leaf)) {
+        node_free(leaf);
+        return 0;
+    }
+    g_stats.objects++;
+    return leaf_handle(leaf);
+}
+
+// Moves inside the fat box cost nothing, short moves refit ancestors,
+// jumps away from the old bounds reinsert the leaf for a better tree.
+void culling_move(int handle, CullAABB box) {
+    int leaf = handle_to_leaf(handle);
+    if (leaf == BVH_NULL) return;
+    g_nodes[leaf].tight = box;
+    if (aabb_contains(g_nodes[leaf].box, box)) return;
+
+    CullAABB fat = aabb_fatten(box);
+    if (aabb_overlaps(g_nodes[leaf].box, fat)) {
+        g_nodes[leaf].box = fat;
+        if (g_nodes[leaf].parent != BVH_NULL) refit_up(g_nodes[leaf].parent);
+        g_stats.refits++;
+    } else {
+        remove_leaf(leaf);
+        g_nodes[leaf].box = fat;
+        if (!insert_leaf(leaf)) {
+            // Out of nodes, drop the object rather than keep an orphan leaf
+            node_free(leaf);
+            g_stats.objects--;
+            return;
+        }
+        g_stats.reinserts++;
+    }
+}
+
+void culling_remove(int handle) {
+    int leaf = handle_to_leaf(handle);
+    if (leaf == BVH_NULL) return;
+    remove_leaf(leaf);
+    node_free(leaf);
+    g_stats.objects--;
+}
+
+// Nodes are kept so generations survive, handles from before stay stale
+void culling_clear(void) {
+    g_free = BVH_NULL;
+    for (int i = g_capacity - 1; i >= 0; --i) {
+        if (g_nodes[i].used) node_free(i);
+        else {
+            g_nodes[i].next = g_free;
+            g_free = i;
+        }
+    }
+    g_root = BVH_NULL;
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+static bool visible_push(int userId, int count) {
+    if (count >= g_visible_capacity) {
+        int newCapacity = (g_visible_capacity == 0) ? 256 : g_visible_capacity*2;
+        int *visible = (int*)realloc(g_visible, (size_t)newCapacity*sizeof(int));
+        if (!visible) return false;
+        g_visible = visible;
+        g_visible_capacity = newCapacity;
+    }
+    g_visible[count] = userId;
+    return true;
+}
+
+// Walk the tree, skip rejected subtrees and take fully inside subtrees without more tests
+int culling_cull(const Frustum *frustum, const int **visible) {
+    int count = 0;
+    g_stats.tested = 0;
+
+    if (g_root != BVH_NULL) {
+        int top = 0;
+        g_stack[top++] = g_root;
+        while (top > 0) {
+            int index = g_stack[--top];
+            BvhNode *node = &g_nodes[index];
+            FrustumResult result = frustum_classify_aabb(frustum, node->box);
+            g_stats.tested++;
+            if (result == FRUSTUM_OUTSIDE) continue;
+
+            if (result == FRUSTUM_INSIDE) {
+                // Whole subtree visible; reuse the stack above 'top'
+                int base = top;
+                g_stack[top++] = index;
+                while (top > base) {
+                    int sub = g_stack[--top];
+                    if (node_is_leaf(sub)) {
+                        if (visible_push(g_nodes[sub].userId, count)) count++;
+                    } else {
+                        g_stack[top++] = g_nodes[sub].child1;
+                        g_stack[top++] = g_nodes[sub].child2;
+                    }
+                }
+            } else if (node_is_leaf(index)) {
+                if (visible_push(node->userId, count)) count++;
+            } else {
+                g_stack[top++] = node->child1;
+                g_stack[top++] = node->child2;
+            }
+        }
+    }
+
+    g_stats.visible = count;
+    g_stats.culled = g_stats.objects - count;
+    if (visible) *visible = g_visible;
+    return count;
+}
+
+// Slab test, returns the entry distance along the ray or -1 on a miss
+static float ray_aabb(Vector3 origin, Vector3 invDir, CullAABB box, float maxDistance) {
+    float t1 = (box.min.x - origin.x)*invDir.x, t2 = (box.max.x - origin.x)*invDir.x;
+    float tmin = fminf(t1, t2), tmax = fmaxf(t1, t2);
+    t1 = (box.min.y - origin.y)*invDir.y; t2 = (box.max.y - origin.y)*invDir.y;
+    tmin = fmaxf(tmin, fminf(t1, t2)); tmax = fminf(tmax, fmaxf(t1, t2));
+    t1 = (box.min.z - origin.z)*invDir.z; t2 = (box.max.z - origin.z)*invDir.z;
+    tmin = fmaxf(tmin, fminf(t1, t2)); tmax = fminf(tmax, fmaxf(t1, t2));
+    if (tmax < 0.0f || tmin > tmax || tmin > maxDistance) return -1.0f;
+    return (tmin > 0.0f) ? tmin : 0.0f;
+}
+
+// Closest hit along the ray, subtrees farther than the best hit are skipped
+int culling_raycast(Vector3 origin, Vector3 direction, float maxDistance, float *distance) {
+    int hitId = 0;
+    float best = maxDistance;
+    if (g_root == BVH_NULL) return 0;
+
+    // Infinities from zero components are what the slab test expects
+    Vector3 invDir = { 1.0f/direction.x, 1.0f/direction.y, 1.0f/direction.z };
+    int top = 0;
+    g_stack[top++] = g_root;
+    while (top > 0) {
+        int index = g_stack[--top];
+        BvhNode *node = &g_nodes[index];
+        if (ray_aabb(origin, invDir, node->box, best) < 0.0f) continue;
+        if (node_is_leaf(index)) {
+            float t = ray_aabb(origin, invDir, node->tight, best);
+            if (t >= 0.0f) {
+                best = t;
+                hitId = node->userId;
+            }
+        } else {
+            g_stack[top++] = node->child1;
+            g_stack[top++] = node->child2;
+        }
+    }
+    if (hitId != 0 && distance) *distance = best;
+    return hitId;
+}
+
+CullStats culling_get_stats(void) {
+    return g_stats;
+}
+
+//----------------------------------------------------------------------------------
+// Lua bindings
+//----------------------------------------------------------------------------------
+static CullAABB check_aabb(lua_State *L, int index) {
+    CullAABB box;
+    box.min.x = (float)luaL_checknumber(L, index);
+    box.min.y = (float)luaL_checknumber(L, index + 1);
+    box.min.z = (float)luaL_checknumber(L, index + 2);
+    box.max.x = (float)luaL_checknumber(L, index + 3);
+    box.max.y = (float)luaL_checknumber(L, index + 4);
+    box.max.z = (float)luaL_checknumber(L, index + 5);
+    return box;
+}
+
+// rl.BvhInsert(minx, miny, minz, maxx, maxy, maxz, [id]) -> handle
+static int lua_raylib_bvh_insert(lua_State *L) {
+    CullAABB box = check_aabb(L, 1);
+    int handle = culling_insert(box, (int)luaL_optinteger(L, 7, 0));
+    if (handle == 0) {
+        lua_pushnil(L);
+        return 1;
+    }
+    lua_pushinteger(L, handle);
+    return 1;
+}
+
+// rl.BvhMove(handle, minx, miny, minz, maxx, maxy, maxz)
+static int lua_raylib_bvh_move(lua_State *L) {
+    int handle = (int)luaL_checkinteger(L, 1);
+    culling_move(handle, check_aabb(L, 2));
+    return 0;
+}
+
+// rl.BvhRemove(handle)
+static int lua_raylib_bvh_remove(lua_State *L) {
+    culling_remove((int)luaL_checkinteger(L, 1));
+    return 0;
+}
+
+// rl.BvhClear(), scene nodes lose their bounds as well
+static int lua_raylib_bvh_clear(lua_State *L) {
+    culling_clear();
+    scene_forget_bounds();
+    return 0;
+}
+
+// rl.BvhCull([camera | view, projection], [out]) -> out, count
+// A camera uses its cached frustum, without matrices the current rlgl
+// modelview/projection are used.
+// 'out' is reused when given so culling every frame does not allocate.
+static int lua_raylib_bvh_cull(lua_State *L) {
+    Frustum frustum;
+    int outIndex = 1;
+    CachedCamera *camera = camera_test_lua(L, 1);
+    if (camera) {
+        camera_update(camera);
+        frustum = camera->frustum;
+        outIndex = 2;
+    } else if (lua_istable(L, 1) && lua_istable(L, 2)) {
+        frustum = frustum_from_matrix(MatrixMultiply(get_matrix(L, 1), get_matrix(L, 2)));
+        outIndex = 3;
+    } else {
+        frustum = frustum_from_matrix(MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+    }
+
+    const int *visible = NULL;
+    int count = culling_cull(&frustum, &visible);
+
+    if (lua_istable(L, outIndex)) {
+        lua_pushvalue(L, outIndex);
+    } else {
+        lua_createtable(L, count, 0);
+    }
+    int previous = (int)lua_rawlen(L, -1);
+    for (int i = 0; i < count; ++i) {
+        lua_pushinteger(L, visible[i]);
+        lua_rawseti(L, -2, i + 1);
+    }
+    // Trim leftovers from a longer previous frame
+    for (int i = count + 1; i <= previous; ++i) {
+        lua_pushnil(L);
+        lua_rawseti(L, -2, i);
+    }
+    lua_pushinteger(L, count);
+    return 2;
+}
+
+// rl.BvhPick(camera, screenX, screenY, [maxDistance]) -> id, distance (nil on a miss)
+static int lua_raylib_bvh_pick(lua_State *L) {
+    CachedCamera *camera = camera_check_lua(L, 1);
+    Vector3 origin, direction;
+    camera_screen_ray(camera, (float)luaL_checknumber(L, 2), (float)luaL_checknumber(L, 3), &origin, &direction);
+    float distance = 0.0f;
+    int id = culling_raycast(origin, direction, (float)luaL_optnumber(L, 4, camera->farPlane), &distance);
+    if (id == 0) {
+        lua_pushnil(L);
+        return 1;
+    }
+    lua_pushinteger(L, id);
+    lua_pushnumber(L, distance);
+    return 2;
+}
+
+// rl.GetCullStats() -> { objects, tested, culled, visible, refits, reinserts }
+static int lua_raylib_get_cull_stats(lua_State *L) {
+    CullStats stats = culling_get_stats();
+    lua_createtable(L, 0, 6);
+    lua_pushinteger(L, stats.objects);   lua_setfield(L, -2, "objects");
+    lua_pushinteger(L, stats.tested);    lua_setfield(L, -2, "tested");
+    lua_pushinteger(L, stats.culled);    lua_setfield(L, -2, "culled");
+    lua_pushinteger(L, stats.visible);   lua_setfield(L, -2, "visible");
+    lua_pushinteger(L, stats.refits);    lua_setfield(L, -2, "refits");
+    lua_pushinteger(L, stats.reinserts); lua_setfield(L, -2, "reinserts");
+    return 1;
+}
+
+static const struct luaL_Reg culling_funcs[] = {
+    {"BvhInsert", lua_raylib_bvh_insert},
+    {"BvhMove", lua_raylib_bvh_move},
+    {"BvhRemove", lua_raylib_bvh_remove},
+    {"BvhClear", lua_raylib_bvh_clear},
+    {"BvhCull", lua_raylib_bvh_cull},
+    {"BvhPick", lua_raylib_bvh_pick},
+    {"GetCullStats", lua_raylib_get_cull_stats},
+    {NULL, NULL}
+};
+
+// Add culling functions to the global 'rl' table (call after raylib_init)
+void culling_init(void) {
+    lua_State *L = lua_get_state();
+    if (!L) {
+        printf("Error: No Lua state available in culling_init\n");
+        return;
+    }
+
+    lua_getglobal(L, "rl");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setglobal(L, "rl");
+    }
+    luaL_setfuncs(L, culling_funcs, 0);
+    lua_settop(L, 0);
+
+    printf("culling module initialized\n");
+}
+
+void culling_cleanup(void) {
+    free(g_nodes);
+    free(g_stack);
+    free(g_visible);
+    g_nodes = NULL;
+    g_stack = NULL;
+    g_visible = NULL;
+    g_capacity = 0;
+    g_visible_capacity = 0;
+    g_free = BVH_NULL;
+    g_root = BVH_NULL;
+    memset(&g_stats, 0, sizeof(g_stats));
+    printf("culling module cleaned up\n");
+}
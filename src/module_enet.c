@@ -1,6 +1,12 @@
 // module_enet.c
 #include "module_enet.h"
 #include "module_lua.h"
+#include "app_clock.h"
+#include "net_thread.h"
+#include "packet_pool.h"
+#include "packet_codec.h"
+#include "peer_group.h"
+#include "module_replication.h"
 #include <lauxlib.h>
 #include <lualib.h>
 #include <enet.h>
@@ -9,7 +15,11 @@
 
 #define ENET_HOST_MT "ENetHost"
 #define ENET_PEER_MT "ENetPeer"
-#define ENET_PACKET_MT "ENetPacket"
+#define ENET_WRITER_MT "ENetPacketWriter"
+#define ENET_GROUP_MT "ENetPeerGroup"
+#define ENET_VIEW_REF "enet_packet_view"     // The one view handed to receive handlers
+#define ENET_PEER_CACHE "enet_peer_cache"
+#define ENET_SERVICE_MAX_EVENTS 1024    // Default host_service_all count budget
 
 // Local Lua state
 static lua_State* g_lua_state = NULL;
@@ -30,12 +40,381 @@ static ENetPeer** push_enet_peer(lua_State *L) {
     return peer;
 }
 
+// Peer userdata cached per ENetPeer, a peer keeps one userdata for its
+// lifetime instead of a new one per event (peers are bounded by the host)
+static void push_enet_peer_cached(lua_State *L, ENetPeer *peer) {
+    lua_getfield(L, LUA_REGISTRYINDEX, ENET_PEER_CACHE);
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, LUA_REGISTRYINDEX, ENET_PEER_CACHE);
+    }
+    lua_rawgetp(L, -1, peer);
+    if (lua_isnil(L, -1)) {
+        lua_pop(L, 1);
+        ENetPeer **ud = push_enet_peer(L);
+        *ud = peer;
+        lua_pushvalue(L, -1);
+        lua_rawsetp(L, -3, peer);
+    }
+    lua_remove(L, -2);
+}
+
+// Drop cached userdata and group memberships of a host's peers before the
+// host memory goes away
+static void forget_host_peers(lua_State *L, ENetHost *host) {
+    peer_group_forget_host(host);
+    replication_forget_host(host);
+    lua_getfield(L, LUA_REGISTRYINDEX, ENET_PEER_CACHE);
+    if (lua_istable(L, -1)) {
+        for (size_t i = 0; i < host->peerCount; ++i) {
+            lua_pushnil(L);
+            lua_rawsetp(L, -2, &host->peers[i]);
+        }
+    }
+    lua_pop(L, 1);
+}
+
+// Who holds the ENetPacket behind a packet userdata
+typedef enum PacketState {
+    PACKET_OWNED,       // Created by the script, __gc destroys it
+    PACKET_RECEIVED,    // From host_service, the script owns it as well
+    PACKET_SENT,        // ENet took it over, the userdata is empty
+    PACKET_DESTROYED,   // packet_destroy() ran
+} PacketState;
+
+static const char *g_packet_state_names[] = { "owned", "received", "sent", "destroyed" };
+
+typedef struct PacketHandle {
+    ENetPacket *packet;     // NULL once sent or destroyed
+    PacketState state;
+} PacketHandle;
+
+// Packet userdata lifetimes, for packet_pool_stats
+static struct {
+    int64_t created;
+    int64_t received;
+    int64_t sent;
+    int64_t destroyed;      // packet_destroy()
+    int64_t collected;      // __gc of a packet the script still owned
+} g_packet_counts;
+
 // Helper to push ENetPacket userdata
-static ENetPacket** push_enet_packet(lua_State *L) {
-    ENetPacket **packet = (ENetPacket**)lua_newuserdata(L, sizeof(ENetPacket*));
+static PacketHandle* push_enet_packet(lua_State *L, ENetPacket *packet, PacketState state) {
+    PacketHandle *handle = (PacketHandle*)lua_newuserdatauv(L, sizeof(PacketHandle), 0);
+    handle->packet = packet;
+    handle->state = state;
     luaL_getmetatable(L, ENET_PACKET_MT);
     lua_setmetatable(L, -2);
-    return packet;
+    if (state == PACKET_RECEIVED) g_packet_counts.received++;
+    else g_packet_counts.created++;
+    return handle;
+}
+
+void enet_push_packet(lua_State *L, ENetPacket *packet) {
+    push_enet_packet(L, packet, PACKET_OWNED);
+}
+
+ENetPeer *enet_check_peer(lua_State *L, int idx) {
+    return *(ENetPeer**)luaL_checkudata(L, idx, ENET_PEER_MT);
+}
+
+// Packet the script still owns, errors once it was sent or destroyed
+static ENetPacket *check_live_packet(lua_State *L, int idx) {
+    PacketHandle *handle = (PacketHandle*)luaL_checkudata(L, idx, ENET_PACKET_MT);
+    if (!handle->packet) luaL_error(L, "packet was already %s", g_packet_state_names[handle->state]);
+    return handle->packet;
+}
+
+// ENet took the packet over (peer_send, broadcast)
+static void mark_packet_sent(lua_State *L, int idx) {
+    PacketHandle *handle = (PacketHandle*)lua_touserdata(L, idx);
+    handle->packet = NULL;
+    handle->state = PACKET_SENT;
+    g_packet_counts.sent++;
+}
+
+// Packet readers, shared by packet userdata and packet views. Offsets are
+// 1-based like string.unpack, every reader returns value, next offset.
+// Multi-byte values are little-endian.
+const unsigned char *enet_check_packet_bytes(lua_State *L, int idx, size_t *length) {
+    if (luaL_testudata(L, idx, ENET_PACKET_MT)) {
+        ENetPacket *packet = check_live_packet(L, idx);
+        *length = packet->dataLength;
+        return packet->data;
+    }
+    PacketView *view = (PacketView*)luaL_checkudata(L, idx, ENET_VIEW_MT);
+    if (!view->data) luaL_error(L, "packet view used after its receive handler returned");
+    *length = view->length;
+    return view->data;
+}
+
+// Start of the read at arg 2, checked against the packet length
+static size_t check_read(lua_State *L, size_t length, size_t size) {
+    lua_Integer offset = luaL_optinteger(L, 2, 1);
+    luaL_argcheck(L, offset >= 1 && (size_t)offset - 1 <= length && size <= length - ((size_t)offset - 1),
+                  2, "read past the end of the packet");
+    return (size_t)offset - 1;
+}
+
+static int read_fixed(lua_State *L, int size) {
+    size_t length;
+    const unsigned char *data = enet_check_packet_bytes(L, 1, &length);
+    size_t at = check_read(L, length, (size_t)size);
+    uint64_t bits = packet_load_le(data + at, size);
+    lua_pushinteger(L, (lua_Integer)bits);
+    lua_pushinteger(L, (lua_Integer)(at + size + 1));
+    return 2;
+}
+
+// packet:u8([offset]) -> value, next
+static int l_packet_u8(lua_State *L) { return read_fixed(L, 1); }
+static int l_packet_u16(lua_State *L) { return read_fixed(L, 2); }
+static int l_packet_u32(lua_State *L) { return read_fixed(L, 4); }
+
+static int l_packet_i32(lua_State *L) {
+    size_t length;
+    const unsigned char *data = enet_check_packet_bytes(L, 1, &length);
+    size_t at = check_read(L, length, 4);
+    lua_pushinteger(L, (int32_t)(uint32_t)packet_load_le(data + at, 4));
+    lua_pushinteger(L, (lua_Integer)(at + 5));
+    return 2;
+}
+
+static int l_packet_f32(lua_State *L) {
+    size_t length;
+    const unsigned char *data = enet_check_packet_bytes(L, 1, &length);
+    size_t at = check_read(L, length, 4);
+    uint32_t bits = (uint32_t)packet_load_le(data + at, 4);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    lua_pushnumber(L, value);
+    lua_pushinteger(L, (lua_Integer)(at + 5));
+    return 2;
+}
+
+static int l_packet_f64(lua_State *L) {
+    size_t length;
+    const unsigned char *data = enet_check_packet_bytes(L, 1, &length);
+    size_t at = check_read(L, length, 8);
+    uint64_t bits = packet_load_le(data + at, 8);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    lua_pushnumber(L, value);
+    lua_pushinteger(L, (lua_Integer)(at + 9));
+    return 2;
+}
+
+static int l_packet_varint(lua_State *L) {
+    size_t length;
+    const unsigned char *data = enet_check_packet_bytes(L, 1, &length);
+    size_t at = check_read(L, length, 0);
+    uint64_t value;
+    if (!packet_load_varint(data, length, &at, &value)) return luaL_error(L, "bad varint in packet");
+    lua_pushinteger(L, (lua_Integer)value);
+    lua_pushinteger(L, (lua_Integer)(at + 1));
+    return 2;
+}
+
+// packet:lstring([offset]) -> string, next (varint length prefix)
+static int l_packet_lstring(lua_State *L) {
+    size_t length;
+    const unsigned char *data = enet_check_packet_bytes(L, 1, &length);
+    size_t at = check_read(L, length, 0);
+    uint64_t size;
+    if (!packet_load_varint(data, length, &at, &size) || size > length - at) {
+        return luaL_error(L, "bad string length in packet");
+    }
+    lua_pushlstring(L, (const char*)data + at, (size_t)size);
+    lua_pushinteger(L, (lua_Integer)(at + size + 1));
+    return 2;
+}
+
+// packet:len()
+static int l_packet_len(lua_State *L) {
+    size_t length;
+    enet_check_packet_bytes(L, 1, &length);
+    lua_pushinteger(L, (lua_Integer)length);
+    return 1;
+}
+
+static const luaL_Reg enet_packet_read_methods[] = {
+    {"u8", l_packet_u8},
+    {"u16", l_packet_u16},
+    {"u32", l_packet_u32},
+    {"i32", l_packet_i32},
+    {"f32", l_packet_f32},
+    {"f64", l_packet_f64},
+    {"varint", l_packet_varint},
+    {"lstring", l_packet_lstring},
+    {"len", l_packet_len},
+    {NULL, NULL}
+};
+
+// Packet writer, builds into a pooled buffer that becomes the packet
+typedef struct PacketWriter {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+    enet_uint32 flags;
+} PacketWriter;
+
+static unsigned char *writer_reserve(lua_State *L, PacketWriter *writer, size_t size) {
+    if (writer->size + size > writer->capacity) {
+        size_t want = writer->capacity ? writer->capacity*2 : PACKET_POOL_MIN_BLOCK;
+        while (want < writer->size + size) want *= 2;
+        unsigned char *data = (unsigned char*)packet_pool_grow(writer->data, writer->size, want, &writer->capacity);
+        if (!data) luaL_error(L, "packet writer out of memory");
+        writer->data = data;
+    }
+    unsigned char *at = writer->data + writer->size;
+    writer->size += size;
+    return at;
+}
+
+static int write_fixed(lua_State *L, uint64_t bits, int size) {
+    PacketWriter *writer = (PacketWriter*)luaL_checkudata(L, 1, ENET_WRITER_MT);
+    packet_store_le(writer_reserve(L, writer, (size_t)size), bits, size);
+    lua_settop(L, 1);
+    return 1;
+}
+
+static void write_varint(lua_State *L, PacketWriter *writer, uint64_t value) {
+    unsigned char bytes[PACKET_VARINT_MAX];
+    int count = packet_store_varint(bytes, value);
+    memcpy(writer_reserve(L, writer, (size_t)count), bytes, (size_t)count);
+}
+
+// writer:u8(value) -> writer
+static int l_writer_u8(lua_State *L) { return write_fixed(L, (uint64_t)luaL_checkinteger(L, 2), 1); }
+static int l_writer_u16(lua_State *L) { return write_fixed(L, (uint64_t)luaL_checkinteger(L, 2), 2); }
+static int l_writer_u32(lua_State *L) { return write_fixed(L, (uint64_t)luaL_checkinteger(L, 2), 4); }
+static int l_writer_i32(lua_State *L) { return write_fixed(L, (uint64_t)luaL_checkinteger(L, 2), 4); }
+
+static int l_writer_f32(lua_State *L) {
+    float value = (float)luaL_checknumber(L, 2);
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return write_fixed(L, bits, 4);
+}
+
+static int l_writer_f64(lua_State *L) {
+    double value = luaL_checknumber(L, 2);
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return write_fixed(L, bits, 8);
+}
+
+static int l_writer_varint(lua_State *L) {
+    PacketWriter *writer = (PacketWriter*)luaL_checkudata(L, 1, ENET_WRITER_MT);
+    write_varint(L, writer, (uint64_t)luaL_checkinteger(L, 2));
+    lua_settop(L, 1);
+    return 1;
+}
+
+static int l_writer_lstring(lua_State *L) {
+    PacketWriter *writer = (PacketWriter*)luaL_checkudata(L, 1, ENET_WRITER_MT);
+    size_t length;
+    const char *s = luaL_checklstring(L, 2, &length);
+    write_varint(L, writer, length);
+    if (length) memcpy(writer_reserve(L, writer, length), s, length);
+    lua_settop(L, 1);
+    return 1;
+}
+
+// writer:size()
+static int l_writer_size(lua_State *L) {
+    PacketWriter *writer = (PacketWriter*)luaL_checkudata(L, 1, ENET_WRITER_MT);
+    lua_pushinteger(L, (lua_Integer)writer->size);
+    return 1;
+}
+
+// writer:reset(), keeps the buffer
+static int l_writer_reset(lua_State *L) {
+    PacketWriter *writer = (PacketWriter*)luaL_checkudata(L, 1, ENET_WRITER_MT);
+    writer->size = 0;
+    lua_settop(L, 1);
+    return 1;
+}
+
+// writer:finish([flags]) -> packet, the buffer becomes the packet payload
+// and the writer starts over with a fresh one on the next write
+static int l_writer_finish(lua_State *L) {
+    PacketWriter *writer = (PacketWriter*)luaL_checkudata(L, 1, ENET_WRITER_MT);
+    enet_uint32 flags = (enet_uint32)luaL_optinteger(L, 2, writer->flags);
+    if (!writer->data) {
+        writer->data = (unsigned char*)packet_pool_alloc(0, &writer->capacity);
+        if (!writer->data) return luaL_error(L, "packet writer out of memory");
+    }
+    ENetPacket *packet = packet_pool_packet(writer->data, writer->size, flags);
+    if (!packet) {
+        lua_pushnil(L);
+        return 1;
+    }
+    writer->data = NULL;
+    writer->size = 0;
+    writer->capacity = 0;
+    push_enet_packet(L, packet, PACKET_OWNED);
+    return 1;
+}
+
+static int enet_writer_gc(lua_State *L) {
+    PacketWriter *writer = (PacketWriter*)luaL_checkudata(L, 1, ENET_WRITER_MT);
+    packet_pool_free(writer->data);
+    writer->data = NULL;
+    return 0;
+}
+
+static const luaL_Reg enet_writer_methods[] = {
+    {"u8", l_writer_u8},
+    {"u16", l_writer_u16},
+    {"u32", l_writer_u32},
+    {"i32", l_writer_i32},
+    {"f32", l_writer_f32},
+    {"f64", l_writer_f64},
+    {"varint", l_writer_varint},
+    {"lstring", l_writer_lstring},
+    {"size", l_writer_size},
+    {"reset", l_writer_reset},
+    {"finish", l_writer_finish},
+    {NULL, NULL}
+};
+
+// enet.packet_writer([capacity], [flags]) -> writer
+static int l_enet_packet_writer(lua_State *L) {
+    size_t capacity = (size_t)luaL_optinteger(L, 1, 0);
+    enet_uint32 flags = (enet_uint32)luaL_optinteger(L, 2, 0);
+    PacketWriter *writer = (PacketWriter*)lua_newuserdatauv(L, sizeof(PacketWriter), 0);
+    memset(writer, 0, sizeof(*writer));
+    writer->flags = flags;
+    luaL_getmetatable(L, ENET_WRITER_MT);
+    lua_setmetatable(L, -2);
+    if (capacity) {
+        writer->data = (unsigned char*)packet_pool_alloc(capacity, &writer->capacity);
+        if (!writer->data) return luaL_error(L, "packet writer out of memory");
+    }
+    return 1;
+}
+
+// enet.packet_pool_stats() -> {allocs, frees, reused, oversize, outstanding, cachedBytes,
+//                              created, received, sent, destroyed, collected}
+// Pool counters cover every ENet allocation, the rest count packet userdata
+static int l_enet_packet_pool_stats(lua_State *L) {
+    PacketPoolStats stats = packet_pool_get_stats();
+    lua_createtable(L, 0, 11);
+    lua_pushinteger(L, stats.allocs);                   lua_setfield(L, -2, "allocs");
+    lua_pushinteger(L, stats.frees);                    lua_setfield(L, -2, "frees");
+    lua_pushinteger(L, stats.reused);                   lua_setfield(L, -2, "reused");
+    lua_pushinteger(L, stats.oversize);                 lua_setfield(L, -2, "oversize");
+    lua_pushinteger(L, stats.outstanding);              lua_setfield(L, -2, "outstanding");
+    lua_pushinteger(L, (lua_Integer)stats.cachedBytes); lua_setfield(L, -2, "cachedBytes");
+    lua_pushinteger(L, g_packet_counts.created);        lua_setfield(L, -2, "created");
+    lua_pushinteger(L, g_packet_counts.received);       lua_setfield(L, -2, "received");
+    lua_pushinteger(L, g_packet_counts.sent);           lua_setfield(L, -2, "sent");
+    lua_pushinteger(L, g_packet_counts.destroyed);      lua_setfield(L, -2, "destroyed");
+    lua_pushinteger(L, g_packet_counts.collected);      lua_setfield(L, -2, "collected");
+    return 1;
 }
 
 // enet.initialize()
@@ -90,6 +469,8 @@ static int l_enet_host_create(lua_State *L) {
 static int l_enet_host_destroy(lua_State *L) {
     ENetHost **host = (ENetHost**)luaL_checkudata(L, 1, ENET_HOST_MT);
     if (*host) {
+        net_thread_stop(*host);
+        forget_host_peers(L, *host);
         enet_host_destroy(*host);
         *host = NULL;
     }
@@ -119,6 +500,9 @@ static int l_enet_host_connect(lua_State *L) {
 
     size_t channelCount = luaL_checkinteger(L, 3);
     enet_uint32 data = luaL_optinteger(L, 4, 0);
+    if (net_thread_is_running(*host)) {
+        return luaL_error(L, "host_connect: the host runs on its network thread, connect before host_start_thread");
+    }
 
     ENetPeer *peer = enet_host_connect(*host, &address, channelCount, data);
     if (peer == NULL) {
@@ -130,13 +514,26 @@ static int l_enet_host_connect(lua_State *L) {
     return 1;
 }
 
+// Next event, taken from the network thread's queue once the host is threaded
+// (the thread does the waiting then, timeout is ignored)
+static int next_event(ENetHost *host, ENetEvent *event, enet_uint32 timeout) {
+    int result;
+    if (net_thread_is_running(host)) result = net_thread_poll(host, event) ? 1 : 0;
+    else result = enet_host_service(host, event, timeout);
+    if (result > 0 && (event->type == ENET_EVENT_TYPE_DISCONNECT || event->type == ENET_EVENT_TYPE_DISCONNECT_TIMEOUT)) {
+        peer_group_forget_peer(event->peer);    // The slot may be reused by the next connection
+        replication_forget_peer(event->peer);
+    }
+    return result;
+}
+
 // enet.host_service(host, timeout)
 static int l_enet_host_service(lua_State *L) {
     ENetHost **host = (ENetHost**)luaL_checkudata(L, 1, ENET_HOST_MT);
     enet_uint32 timeout = luaL_optinteger(L, 2, 1000);
     ENetEvent event;
 
-    int result = enet_host_service(*host, &event, timeout);
+    int result = next_event(*host, &event, timeout);
     if (result > 0) {
         lua_newtable(L);
         lua_pushinteger(L, event.type);
@@ -149,8 +546,7 @@ static int l_enet_host_service(lua_State *L) {
         lua_pushinteger(L, event.channelID);
         lua_setfield(L, -2, "channelID");
         if (event.packet) {
-            ENetPacket **ud = push_enet_packet(L);
-            *ud = event.packet;
+            push_enet_packet(L, event.packet, PACKET_RECEIVED);
             lua_setfield(L, -2, "packet");
         }
         return 1;
@@ -159,6 +555,130 @@ static int l_enet_host_service(lua_State *L) {
     return 1;
 }
 
+// enet.host_set_handlers(host, {connect = fn(peer, data), disconnect = fn(peer, data), receive = fn(peer, data, channelID)})
+// nil removes them, host_service_all then fills an array instead
+static int l_enet_host_set_handlers(lua_State *L) {
+    luaL_checkudata(L, 1, ENET_HOST_MT);
+    if (!lua_isnoneornil(L, 2)) luaL_checktype(L, 2, LUA_TTABLE);
+    lua_settop(L, 2);
+    lua_setiuservalue(L, 1, 1);
+    return 0;
+}
+
+// One event into the reused record out[index]: { type, peer, channelID, data }
+static void store_event(lua_State *L, int out, int index, const ENetEvent *event) {
+    if (lua_rawgeti(L, out, index) != LUA_TTABLE) {
+        lua_pop(L, 1);
+        lua_createtable(L, 0, 4);
+        lua_pushvalue(L, -1);
+        lua_rawseti(L, out, index);
+    }
+    lua_pushinteger(L, event->type);
+    lua_setfield(L, -2, "type");
+    push_enet_peer_cached(L, event->peer);
+    lua_setfield(L, -2, "peer");
+    lua_pushinteger(L, event->channelID);
+    lua_setfield(L, -2, "channelID");
+    if (event->packet) lua_pushlstring(L, (const char*)event->packet->data, event->packet->dataLength);
+    else lua_pushinteger(L, event->data);
+    lua_setfield(L, -2, "data");
+    lua_pop(L, 1);
+}
+
+// handler(peer, data, channelID), errors are printed and the pump goes on.
+// With views, data of a receive is the shared packet view, valid until the
+// handler returns, instead of a copy.
+static void dispatch_event(lua_State *L, int handlers, const ENetEvent *event, bool views) {
+    const char *name = (event->type == ENET_EVENT_TYPE_CONNECT) ? "connect" :
+                       (event->type == ENET_EVENT_TYPE_RECEIVE) ? "receive" : "disconnect";
+    if (lua_getfield(L, handlers, name) != LUA_TFUNCTION) {
+        lua_pop(L, 1);
+        return;
+    }
+    push_enet_peer_cached(L, event->peer);
+    PacketView *view = NULL;
+    PacketView saved = { 0 };
+    if (event->packet && views) {
+        lua_getfield(L, LUA_REGISTRYINDEX, ENET_VIEW_REF);
+        view = (PacketView*)lua_touserdata(L, -1);
+        saved = *view;      // The handler may pump another host
+        view->data = event->packet->data ? event->packet->data : (const unsigned char*)"";
+        view->length = event->packet->dataLength;
+    } else if (event->packet) {
+        lua_pushlstring(L, (const char*)event->packet->data, event->packet->dataLength);
+    } else {
+        lua_pushinteger(L, event->data);
+    }
+    lua_pushinteger(L, event->channelID);
+    if (lua_pcall(L, 3, 0, 0) != LUA_OK) {
+        printf("enet %s handler error: %s\n", name, lua_tostring(L, -1));
+        lua_pop(L, 1);
+    }
+    if (view) *view = saved;
+}
+
+// enet.host_service_all(host, [budget], [out]) -> count, more
+// Drains events until none are left or the budget runs out. budget is a max
+// event count or { events = N, ms = M }. Events go to the host's handlers,
+// else into out (reused records out[1..count], out.n = count). Received
+// packets are copied into strings and freed here.
+static int l_enet_host_service_all(lua_State *L) {
+    ENetHost **host = (ENetHost**)luaL_checkudata(L, 1, ENET_HOST_MT);
+    int maxEvents = ENET_SERVICE_MAX_EVENTS;
+    double maxMs = 0.0;
+    if (lua_istable(L, 2)) {
+        lua_getfield(L, 2, "events");
+        maxEvents = (int)luaL_optinteger(L, -1, ENET_SERVICE_MAX_EVENTS);
+        lua_getfield(L, 2, "ms");
+        maxMs = luaL_optnumber(L, -1, 0.0);
+        lua_pop(L, 2);
+    } else if (!lua_isnoneornil(L, 2)) {
+        maxEvents = (int)luaL_checkinteger(L, 2);
+    }
+    int out = 0;
+    if (lua_istable(L, 3)) out = 3;
+
+    lua_getiuservalue(L, 1, 1);
+    int handlers = lua_istable(L, -1) ? lua_gettop(L) : 0;
+    bool views = false;
+    if (handlers) {
+        out = 0;
+        lua_getfield(L, handlers, "views");
+        views = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+    } else if (!out) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        out = lua_gettop(L);
+    }
+
+    double deadline = (maxMs > 0.0) ? app_clock_real() + maxMs/1000.0 : 0.0;
+    int count = 0;
+    bool more = false;
+    ENetEvent event;
+    while (*host) {
+        if (count >= maxEvents || (deadline > 0.0 && app_clock_real() >= deadline)) {
+            more = true;
+            break;
+        }
+        if (next_event(*host, &event, 0) <= 0) break;
+        count++;
+        if (handlers) dispatch_event(L, handlers, &event, views);
+        else store_event(L, out, count, &event);
+        if (event.packet) enet_packet_destroy(event.packet);
+    }
+
+    lua_pushinteger(L, count);
+    lua_pushboolean(L, more);
+    if (out) {
+        lua_pushinteger(L, count);
+        lua_setfield(L, out, "n");
+        lua_pushvalue(L, out);
+        return 3;
+    }
+    return 2;
+}
+
 // enet.packet_create(data, flags)
 static int l_enet_packet_create(lua_State *L) {
     size_t data_len;
@@ -169,57 +689,199 @@ static int l_enet_packet_create(lua_State *L) {
     if (packet == NULL) {
         lua_pushnil(L);
     } else {
-        ENetPacket **ud = push_enet_packet(L);
-        *ud = packet;
-        lua_pushvalue(L, -1);
-        lua_setfield(L, LUA_REGISTRYINDEX, "enet_packet_ref");
+        push_enet_packet(L, packet, PACKET_OWNED);
     }
     return 1;
 }
 
-// enet.packet_destroy(packet)
+// enet.packet_destroy(packet), no-op once sent or destroyed
 static int l_enet_packet_destroy(lua_State *L) {
-    ENetPacket **packet = (ENetPacket**)luaL_checkudata(L, 1, ENET_PACKET_MT);
-    if (*packet) {
-        enet_packet_destroy(*packet);
-        *packet = NULL;
-        lua_pushnil(L);
-        lua_setfield(L, LUA_REGISTRYINDEX, "enet_packet_ref");
+    PacketHandle *handle = (PacketHandle*)luaL_checkudata(L, 1, ENET_PACKET_MT);
+    if (handle->packet) {
+        enet_packet_destroy(handle->packet);
+        handle->packet = NULL;
+        handle->state = PACKET_DESTROYED;
+        g_packet_counts.destroyed++;
     }
     return 0;
 }
 
 // enet.packet_data(packet)
 static int l_enet_packet_data(lua_State *L) {
-    ENetPacket **packet = (ENetPacket**)luaL_checkudata(L, 1, ENET_PACKET_MT);
-    if (*packet) {
-        lua_pushlstring(L, (const char*)(*packet)->data, (*packet)->dataLength);
+    PacketHandle *handle = (PacketHandle*)luaL_checkudata(L, 1, ENET_PACKET_MT);
+    if (handle->packet) {
+        lua_pushlstring(L, (const char*)handle->packet->data, handle->packet->dataLength);
     } else {
         lua_pushnil(L);
     }
     return 1;
 }
 
+// enet.packet_state(packet) -> "owned", "received", "sent" or "destroyed"
+static int l_enet_packet_state(lua_State *L) {
+    PacketHandle *handle = (PacketHandle*)luaL_checkudata(L, 1, ENET_PACKET_MT);
+    lua_pushstring(L, g_packet_state_names[handle->state]);
+    return 1;
+}
+
 // enet.peer_send(peer, channelID, packet)
+// On success ENet owns the packet and the userdata is marked sent; on
+// failure the script still owns it
 static int l_enet_peer_send(lua_State *L) {
     ENetPeer **peer = (ENetPeer**)luaL_checkudata(L, 1, ENET_PEER_MT);
     enet_uint8 channelID = luaL_checkinteger(L, 2);
-    ENetPacket **packet = (ENetPacket**)luaL_checkudata(L, 3, ENET_PACKET_MT);
+    ENetPacket *packet = check_live_packet(L, 3);
 
-    int result = enet_peer_send(*peer, channelID, *packet);
-    if (result == 0) {
-        *packet = NULL;
-        lua_pushnil(L);
-        lua_setfield(L, LUA_REGISTRYINDEX, "enet_packet_ref");
-    }
+    int result;
+    if (net_thread_is_running((*peer)->host)) result = net_thread_send(*peer, channelID, packet) ? 0 : -1;
+    else result = enet_peer_send(*peer, channelID, packet);
+    if (result == 0) mark_packet_sent(L, 3);
     lua_pushinteger(L, result);
     return 1;
 }
 
+// enet.host_broadcast(host, channelID, packet)
+// Every connected peer of the host, ENet takes the packet in any case
+static int l_enet_host_broadcast(lua_State *L) {
+    ENetHost **host = (ENetHost**)luaL_checkudata(L, 1, ENET_HOST_MT);
+    enet_uint8 channelID = luaL_checkinteger(L, 2);
+    ENetPacket *packet = check_live_packet(L, 3);
+    if (!*host) return luaL_error(L, "host_broadcast: host was destroyed");
+
+    bool ok = true;
+    if (net_thread_is_running(*host)) ok = net_thread_broadcast(*host, channelID, packet);
+    else enet_host_broadcast(*host, channelID, packet);
+    if (ok) mark_packet_sent(L, 3);
+    lua_pushboolean(L, ok);
+    return 1;
+}
+
+// enet.group_create() -> group
+static int l_enet_group_create(lua_State *L) {
+    PeerGroup *group = (PeerGroup*)lua_newuserdatauv(L, sizeof(PeerGroup), 0);
+    peer_group_init(group);
+    luaL_setmetatable(L, ENET_GROUP_MT);
+    return 1;
+}
+
+// Channel subscription: nil = all, else a list of channel ids (0..31)
+static uint32_t check_channel_mask(lua_State *L, int idx) {
+    if (lua_isnoneornil(L, idx)) return PEER_GROUP_ALL_CHANNELS;
+    luaL_checktype(L, idx, LUA_TTABLE);
+    uint32_t mask = 0;
+    int count = (int)lua_rawlen(L, idx);
+    for (int i = 1; i <= count; ++i) {
+        lua_rawgeti(L, idx, i);
+        lua_Integer channel = luaL_checkinteger(L, -1);
+        luaL_argcheck(L, channel >= 0 && channel < 32, idx, "channels 0 to 31 expected");
+        mask |= 1u << channel;
+        lua_pop(L, 1);
+    }
+    return mask;
+}
+
+// enet.group_add(group, peer, [channels]) -> ok, adding again updates channels
+static int l_enet_group_add(lua_State *L) {
+    PeerGroup *group = (PeerGroup*)luaL_checkudata(L, 1, ENET_GROUP_MT);
+    ENetPeer **peer = (ENetPeer**)luaL_checkudata(L, 2, ENET_PEER_MT);
+    uint32_t channels = check_channel_mask(L, 3);
+    lua_pushboolean(L, peer_group_add(group, *peer, channels));
+    return 1;
+}
+
+// enet.group_remove(group, peer) -> was member
+static int l_enet_group_remove(lua_State *L) {
+    PeerGroup *group = (PeerGroup*)luaL_checkudata(L, 1, ENET_GROUP_MT);
+    ENetPeer **peer = (ENetPeer**)luaL_checkudata(L, 2, ENET_PEER_MT);
+    lua_pushboolean(L, peer_group_remove(group, *peer));
+    return 1;
+}
+
+// enet.group_clear(group)
+static int l_enet_group_clear(lua_State *L) {
+    PeerGroup *group = (PeerGroup*)luaL_checkudata(L, 1, ENET_GROUP_MT);
+    peer_group_clear(group);
+    return 0;
+}
+
+// enet.group_size(group)
+static int l_enet_group_size(lua_State *L) {
+    PeerGroup *group = (PeerGroup*)luaL_checkudata(L, 1, ENET_GROUP_MT);
+    lua_pushinteger(L, group->count);
+    return 1;
+}
+
+// enet.group_send(group, channelID, packet, [except]) -> recipients
+// One refcounted packet to every member subscribed to the channel, except
+// the given peer; the group takes the packet even with no recipients
+static int l_enet_group_send(lua_State *L) {
+    PeerGroup *group = (PeerGroup*)luaL_checkudata(L, 1, ENET_GROUP_MT);
+    enet_uint8 channelID = luaL_checkinteger(L, 2);
+    ENetPacket *packet = check_live_packet(L, 3);
+    ENetPeer *except = NULL;
+    if (!lua_isnoneornil(L, 4)) except = *(ENetPeer**)luaL_checkudata(L, 4, ENET_PEER_MT);
+
+    mark_packet_sent(L, 3);
+    lua_pushinteger(L, peer_group_send(group, channelID, packet, except));
+    return 1;
+}
+
+static int enet_group_gc(lua_State *L) {
+    PeerGroup *group = (PeerGroup*)luaL_checkudata(L, 1, ENET_GROUP_MT);
+    peer_group_free(group);
+    return 0;
+}
+
+// enet.peer_disconnect(peer, [data])
+static int l_enet_peer_disconnect(lua_State *L) {
+    ENetPeer **peer = (ENetPeer**)luaL_checkudata(L, 1, ENET_PEER_MT);
+    enet_uint32 data = luaL_optinteger(L, 2, 0);
+    if (net_thread_is_running((*peer)->host)) {
+        lua_pushboolean(L, net_thread_disconnect(*peer, data));
+    } else {
+        enet_peer_disconnect(*peer, data);
+        lua_pushboolean(L, true);
+    }
+    return 1;
+}
+
+// enet.host_start_thread(host, [intervalMs]) -> ok
+// Moves servicing to a network thread; host_service, host_service_all and
+// peer_send then go through its queues
+static int l_enet_host_start_thread(lua_State *L) {
+    ENetHost **host = (ENetHost**)luaL_checkudata(L, 1, ENET_HOST_MT);
+    int intervalMs = (int)luaL_optinteger(L, 2, NET_THREAD_INTERVAL_MS);
+    lua_pushboolean(L, *host && net_thread_start(*host, intervalMs));
+    return 1;
+}
+
+// enet.host_stop_thread(host), back to servicing on the calling thread
+static int l_enet_host_stop_thread(lua_State *L) {
+    ENetHost **host = (ENetHost**)luaL_checkudata(L, 1, ENET_HOST_MT);
+    if (*host) net_thread_stop(*host);
+    return 0;
+}
+
+// enet.host_thread_stats(host) -> {running, queuedEvents, queuedCommands, eventStalls, sendsRejected, loops}
+static int l_enet_host_thread_stats(lua_State *L) {
+    ENetHost **host = (ENetHost**)luaL_checkudata(L, 1, ENET_HOST_MT);
+    NetThreadStats stats = net_thread_get_stats(*host);
+    lua_createtable(L, 0, 6);
+    lua_pushboolean(L, stats.running);          lua_setfield(L, -2, "running");
+    lua_pushinteger(L, stats.queuedEvents);     lua_setfield(L, -2, "queuedEvents");
+    lua_pushinteger(L, stats.queuedCommands);   lua_setfield(L, -2, "queuedCommands");
+    lua_pushinteger(L, stats.eventStalls);      lua_setfield(L, -2, "eventStalls");
+    lua_pushinteger(L, stats.sendsRejected);    lua_setfield(L, -2, "sendsRejected");
+    lua_pushinteger(L, stats.loops);            lua_setfield(L, -2, "loops");
+    return 1;
+}
+
 // Metatables for cleanup
 static int enet_host_gc(lua_State *L) {
     ENetHost **host = (ENetHost**)luaL_checkudata(L, 1, ENET_HOST_MT);
     if (*host) {
+        net_thread_stop(*host);
+        forget_host_peers(L, *host);
         enet_host_destroy(*host);
         *host = NULL;
     }
@@ -227,10 +889,12 @@ static int enet_host_gc(lua_State *L) {
 }
 
 static int enet_packet_gc(lua_State *L) {
-    ENetPacket **packet = (ENetPacket**)luaL_checkudata(L, 1, ENET_PACKET_MT);
-    if (*packet) {
-        enet_packet_destroy(*packet);
-        *packet = NULL;
+    PacketHandle *handle = (PacketHandle*)luaL_checkudata(L, 1, ENET_PACKET_MT);
+    if (handle->packet) {
+        enet_packet_destroy(handle->packet);
+        handle->packet = NULL;
+        handle->state = PACKET_DESTROYED;
+        g_packet_counts.collected++;
     }
     return 0;
 }
@@ -242,10 +906,26 @@ static const luaL_Reg enet_funcs[] = {
     {"host_destroy", l_enet_host_destroy},
     {"host_connect", l_enet_host_connect},
     {"host_service", l_enet_host_service},
+    {"host_service_all", l_enet_host_service_all},
+    {"host_set_handlers", l_enet_host_set_handlers},
+    {"host_start_thread", l_enet_host_start_thread},
+    {"host_stop_thread", l_enet_host_stop_thread},
+    {"host_thread_stats", l_enet_host_thread_stats},
     {"packet_create", l_enet_packet_create},
     {"packet_destroy", l_enet_packet_destroy},
     {"packet_data", l_enet_packet_data},
+    {"packet_state", l_enet_packet_state},
     {"peer_send", l_enet_peer_send},
+    {"host_broadcast", l_enet_host_broadcast},
+    {"group_create", l_enet_group_create},
+    {"group_add", l_enet_group_add},
+    {"group_remove", l_enet_group_remove},
+    {"group_clear", l_enet_group_clear},
+    {"group_size", l_enet_group_size},
+    {"group_send", l_enet_group_send},
+    {"packet_writer", l_enet_packet_writer},
+    {"packet_pool_stats", l_enet_packet_pool_stats},
+    {"peer_disconnect", l_enet_peer_disconnect},
     {NULL, NULL}
 };
 
@@ -259,6 +939,16 @@ static const luaL_Reg enet_packet_mt[] = {
     {NULL, NULL}
 };
 
+static const luaL_Reg enet_writer_mt[] = {
+    {"__gc", enet_writer_gc},
+    {NULL, NULL}
+};
+
+static const luaL_Reg enet_group_mt[] = {
+    {"__gc", enet_group_gc},
+    {NULL, NULL}
+};
+
 int luaopen_enet(lua_State *L) {
     // Register ENetHost metatable
     luaL_newmetatable(L, ENET_HOST_MT);
@@ -269,9 +959,33 @@ int luaopen_enet(lua_State *L) {
     luaL_newmetatable(L, ENET_PEER_MT);
     lua_pop(L, 1);
 
-    // Register ENetPacket metatable
+    // Register ENetPacket metatable, packets read in place (packet:u32(offset))
     luaL_newmetatable(L, ENET_PACKET_MT);
     luaL_setfuncs(L, enet_packet_mt, 0);
+    luaL_newlib(L, enet_packet_read_methods);
+    lua_setfield(L, -2, "__index");
+    lua_pop(L, 1);
+
+    // Register ENetPacketView metatable and the shared view
+    luaL_newmetatable(L, ENET_VIEW_MT);
+    luaL_newlib(L, enet_packet_read_methods);
+    lua_setfield(L, -2, "__index");
+    lua_pop(L, 1);
+    PacketView *view = (PacketView*)lua_newuserdatauv(L, sizeof(PacketView), 0);
+    memset(view, 0, sizeof(*view));
+    luaL_setmetatable(L, ENET_VIEW_MT);
+    lua_setfield(L, LUA_REGISTRYINDEX, ENET_VIEW_REF);
+
+    // Register ENetPeerGroup metatable
+    luaL_newmetatable(L, ENET_GROUP_MT);
+    luaL_setfuncs(L, enet_group_mt, 0);
+    lua_pop(L, 1);
+
+    // Register ENetPacketWriter metatable
+    luaL_newmetatable(L, ENET_WRITER_MT);
+    luaL_setfuncs(L, enet_writer_mt, 0);
+    luaL_newlib(L, enet_writer_methods);
+    lua_setfield(L, -2, "__index");
     lua_pop(L, 1);
 
     // Register enet module
@@ -298,8 +1012,8 @@ void enet_init(void) {
         return;
     }
 
-    // Initialize ENet
-    if (enet_initialize() != 0) {
+    // Initialize ENet, allocations go through the packet pool
+    if (!packet_pool_install()) {
         printf("Error: Failed to initialize ENet\n");
         return;
     }
@@ -332,6 +1046,7 @@ void enet_update(void) {
 
 
 void enet_cleanup(void) {
+    net_thread_stop_all();
     enet_deinitialize();
     g_lua_state = NULL;
     printf("ENet module cleaned up\n");
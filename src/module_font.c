@@ -0,0 +1,517 @@
+// module_font.c
+// Background font loading + persistent glyph tables. The worker thread only
+// touches files; everything involving the atlas stays on the main thread,
+// between frames, because ImGui is not thread safe.
+//
+// A glyph table is keyed by the hashes of every file that went into one
+// ImFont (the base font plus the ones merged into it) and the ImGui version,
+// so editing a font or upgrading ImGui simply misses the cache.
+#include "module_font.h"
+#include "module_lua.h"
+#include "hash.h"
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>         // glfwGetTime()
+
+#define igGetIO igGetIO_Nil
+
+#if defined(_WIN32)
+    #include <direct.h>
+    #define font_mkdir(path) _mkdir(path)
+#else
+    #include <sys/stat.h>
+    #define font_mkdir(path) mkdir(path, 0755)
+#endif
+
+#define GLYPH_TABLE_MAGIC 0x47464c52u   // "RLFG"
+#define GLYPH_TABLE_VERSION 1
+#define GLYPH_TABLE_MAX_GLYPHS 16384    // Per size, a table is a cache not an archive
+
+typedef struct GlyphTableHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t bakes;
+} GlyphTableHeader;
+
+typedef struct GlyphBakeHeader {
+    float size;
+    float density;
+    uint32_t count;
+} GlyphBakeHeader;
+
+typedef enum {
+    FONT_QUEUED = 0,        // Waiting for the worker
+    FONT_READY,             // File in memory, not in the atlas yet
+    FONT_ADDED,
+    FONT_FAILED
+} FontState;
+
+typedef struct GlyphBake {
+    GlyphBakeHeader header;
+    uint32_t *codepoints;
+} GlyphBake;
+
+typedef struct FontEntry {
+    char path[512];
+    float size;
+    bool merge;
+    FontState state;        // Guarded by g_mutex while QUEUED / READY
+    void *data;             // File contents, borrowed by the atlas
+    int dataSize;
+    uint64_t hash;
+    ImFont *font;
+    int base;               // Entry owning the ImFont (itself unless merged)
+    float sizes[FONT_MAX_SIZES];
+    int sizeCount;
+    // Glyph table, base entries only
+    bool tableLoaded;
+    GlyphBake *bakes;
+    int bakeCount;
+    int bakeNext;           // Prewarm cursor
+    uint32_t glyphNext;
+} FontEntry;
+
+static FontEntry g_fonts[FONT_MAX_FONTS];
+static int g_font_count = 0;
+static int g_next_add = 0;          // First entry not handed to the atlas yet
+static int g_default = -1;
+static char g_directory[512] = { 0 };
+static bool g_tables_enabled = false;
+static FontCacheStats g_stats = { 0 };
+
+static pthread_t g_worker;
+static bool g_worker_running = false;
+static bool g_worker_stop = false;
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_wake = PTHREAD_COND_INITIALIZER;
+
+//----------------------------------------------------------------------------------
+// Worker
+//----------------------------------------------------------------------------------
+static void *read_file(const char *path, int *size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    void *data = (length > 0) ? malloc((size_t)length) : NULL;
+    if (data && fread(data, 1, (size_t)length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    *size = data ? (int)length : 0;
+    return data;
+}
+
+static void *worker_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&g_mutex);
+    for (;;) {
+        int next = -1;
+        for (int i = 0; i < g_font_count; ++i) {
+            if (g_fonts[i].state == FONT_QUEUED) { next = i; break; }
+        }
+        if (next < 0) {
+            if (g_worker_stop) break;
+            pthread_cond_wait(&g_wake, &g_mutex);
+            continue;
+        }
+        char path[512];
+        memcpy(path, g_fonts[next].path, sizeof(path));
+        pthread_mutex_unlock(&g_mutex);
+
+        double start = glfwGetTime();
+        int size = 0;
+        void *data = read_file(path, &size);
+        uint64_t hash = data ? hash_mix64(data, (size_t)size, HASH_FNV1A64_BASIS) : 0;
+        double ms = (glfwGetTime() - start)*1000.0;
+
+        pthread_mutex_lock(&g_mutex);
+        FontEntry *entry = &g_fonts[next];
+        entry->data = data;
+        entry->dataSize = size;
+        entry->hash = hash;
+        entry->state = data ? FONT_READY : FONT_FAILED;
+        g_stats.loadMs += ms;
+    }
+    pthread_mutex_unlock(&g_mutex);
+    return NULL;
+}
+
+//----------------------------------------------------------------------------------
+// Glyph tables
+//----------------------------------------------------------------------------------
+void font_cache_setup(const char *directory) {
+    g_tables_enabled = false;
+    g_directory[0] = '\0';
+    if (!directory || directory[0] == '\0') {
+        printf("Font cache: glyph tables disabled\n");
+        return;
+    }
+    snprintf(g_directory, sizeof(g_directory), "%s", directory);
+    g_tables_enabled = true;
+}
+
+// Hash of every file merged into the base entry's ImFont
+static uint64_t table_key(int base) {
+    uint64_t key = hash_fnv1a64(IMGUI_VERSION, strlen(IMGUI_VERSION), HASH_FNV1A64_BASIS);
+    for (int i = base; i < g_next_add; ++i) {
+        const FontEntry *entry = &g_fonts[i];
+        if (entry->state != FONT_ADDED || entry->base != base) continue;
+        key = hash_fnv1a64(&entry->hash, sizeof(entry->hash), key);
+    }
+    return key;
+}
+
+static void table_path(uint64_t key, char *path, size_t size) {
+    snprintf(path, size, "%s/%016llx.glyphs", g_directory, (unsigned long long)key);
+}
+
+static void load_table(FontEntry *entry, int base) {
+    entry->tableLoaded = true;
+    if (!g_tables_enabled) return;
+    uint64_t key = table_key(base);
+    char path[600];
+    table_path(key, path, sizeof(path));
+    FILE *file = fopen(path, "rb");
+    if (!file) return;
+
+    GlyphTableHeader header;
+    if (fread(&header, sizeof(header), 1, file) == 1 && header.magic == GLYPH_TABLE_MAGIC &&
+        header.version == GLYPH_TABLE_VERSION && header.key == key && header.bakes <= FONT_MAX_SIZES) {
+        entry->bakes = (GlyphBake*)calloc(header.bakes ? header.bakes : 1, sizeof(GlyphBake));
+        for (uint32_t i = 0; entry->bakes && i < header.bakes; ++i) {
+            GlyphBake *bake = &entry->bakes[entry->bakeCount];
+            if (fread(&bake->header, sizeof(bake->header), 1, file) != 1 ||
+                bake->header.count > GLYPH_TABLE_MAX_GLYPHS) break;
+            bake->codepoints = (uint32_t*)malloc((bake->header.count ? bake->header.count : 1)*sizeof(uint32_t));
+            if (!bake->codepoints) break;
+            if (fread(bake->codepoints, sizeof(uint32_t), bake->header.count, file) != bake->header.count) {
+                free(bake->codepoints);
+                break;
+            }
+            entry->bakeCount++;
+            g_stats.prewarmLeft += (int)bake->header.count;
+        }
+        if (entry->bakeCount > 0) g_stats.tableHits++;
+    }
+    fclose(file);
+}
+
+static void save_table(int base) {
+    FontEntry *entry = &g_fonts[base];
+    GlyphBake bakes[FONT_MAX_SIZES];
+    int bakeCount = 0;
+    for (int s = 0; s < entry->sizeCount; ++s) {
+        ImFontBaked *baked = ImFont_GetFontBaked(entry->font, entry->sizes[s], -1.0f);
+        if (!baked || baked->Glyphs.Size == 0) continue;
+        int count = baked->Glyphs.Size;
+        if (count > GLYPH_TABLE_MAX_GLYPHS) count = GLYPH_TABLE_MAX_GLYPHS;
+        GlyphBake *bake = &bakes[bakeCount];
+        bake->codepoints = (uint32_t*)malloc((size_t)count*sizeof(uint32_t));
+        if (!bake->codepoints) break;
+        for (int g = 0; g < count; ++g) bake->codepoints[g] = baked->Glyphs.Data[g].Codepoint;
+        bake->header.size = baked->Size;
+        bake->header.density = baked->RasterizerDensity;
+        bake->header.count = (uint32_t)count;
+        bakeCount++;
+    }
+    if (bakeCount == 0) return;
+
+    uint64_t key = table_key(base);
+    char path[600];
+    table_path(key, path, sizeof(path));
+    font_mkdir(g_directory);
+    FILE *file = fopen(path, "wb");
+    if (file) {
+        GlyphTableHeader header = { GLYPH_TABLE_MAGIC, GLYPH_TABLE_VERSION, key, (uint32_t)bakeCount };
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+        for (int i = 0; ok && i < bakeCount; ++i) {
+            ok = fwrite(&bakes[i].header, sizeof(bakes[i].header), 1, file) == 1 &&
+                 fwrite(bakes[i].codepoints, sizeof(uint32_t), bakes[i].header.count, file) == bakes[i].header.count;
+        }
+        fclose(file);
+        if (ok) g_stats.tablesSaved++;
+    }
+    for (int i = 0; i < bakeCount; ++i) free(bakes[i].codepoints);
+}
+
+static void free_table(FontEntry *entry) {
+    for (int i = 0; i < entry->bakeCount; ++i) free(entry->bakes[i].codepoints);
+    free(entry->bakes);
+    entry->bakes = NULL;
+    entry->bakeCount = 0;
+}
+
+//----------------------------------------------------------------------------------
+// Atlas (main thread)
+//----------------------------------------------------------------------------------
+int font_cache_load(const char *path, float size, bool merge) {
+    if (!path || g_font_count >= FONT_MAX_FONTS) return -1;
+    if (!g_worker_running) {
+        g_worker_stop = false;
+        if (pthread_create(&g_worker, NULL, worker_main, NULL) != 0) {
+            printf("Font cache: failed to start the loader thread\n");
+            return -1;
+        }
+        g_worker_running = true;
+    }
+
+    pthread_mutex_lock(&g_mutex);
+    int id = g_font_count++;
+    FontEntry *entry = &g_fonts[id];
+    memset(entry, 0, sizeof(FontEntry));
+    snprintf(entry->path, sizeof(entry->path), "%s", path);
+    entry->size = (size > 0.0f) ? size : 16.0f;
+    entry->merge = merge;
+    entry->base = id;
+    entry->sizes[entry->sizeCount++] = entry->size;
+    entry->state = FONT_QUEUED;
+    pthread_cond_signal(&g_wake);
+    pthread_mutex_unlock(&g_mutex);
+    return id;
+}
+
+void font_cache_set_default(int id) {
+    g_default = id;
+    ImFont *font = font_cache_get(id);
+    if (font) igGetIO()->FontDefault = font;
+}
+
+ImFont *font_cache_get(int id) {
+    if (id < 0 || id >= g_font_count || id >= g_next_add) return NULL;
+    return (g_fonts[id].state == FONT_ADDED) ? g_fonts[id].font : NULL;
+}
+
+void font_cache_note_size(int id, float size) {
+    if (id < 0 || id >= g_font_count || size <= 0.0f) return;
+    FontEntry *entry = &g_fonts[g_fonts[id].base];
+    for (int i = 0; i < entry->sizeCount; ++i) {
+        if (entry->sizes[i] == size) return;
+    }
+    if (entry->sizeCount < FONT_MAX_SIZES) entry->sizes[entry->sizeCount++] = size;
+}
+
+static void add_font(int id) {
+    FontEntry *entry = &g_fonts[id];
+    ImFontAtlas *atlas = igGetIO()->Fonts;
+
+    // Merged glyphs go into the closest earlier font of ours, else into
+    // whatever font the atlas added last
+    int base = id;
+    if (entry->merge) {
+        for (int i = id - 1; i >= 0; --i) {
+            if (g_fonts[i].state == FONT_ADDED) { base = g_fonts[i].base; break; }
+        }
+    }
+
+    ImFontConfig *config = ImFontConfig_ImFontConfig();
+    config->FontDataOwnedByAtlas = false;   // Freed by font_cleanup
+    config->MergeMode = entry->merge;
+    const char *name = strrchr(entry->path, '/');
+    snprintf(config->Name, sizeof(config->Name), "%s", name ? name + 1 : entry->path);
+    ImFont *font = ImFontAtlas_AddFontFromMemoryTTF(atlas, entry->data, entry->dataSize, entry->size, config, NULL);
+    ImFontConfig_destroy(config);
+
+    if (!font) {
+        printf("Font cache: '%s' is not a usable font\n", entry->path);
+        entry->state = FONT_FAILED;
+        g_stats.failed++;
+        return;
+    }
+    entry->font = font;
+    entry->base = base;
+    entry->state = FONT_ADDED;
+    if (base != id) font_cache_note_size(base, entry->size);
+    if (g_default == id) igGetIO()->FontDefault = font;
+    g_stats.fonts++;
+}
+
+// Bake cached glyphs ahead of use, spread over frames
+static void prewarm(void) {
+    double start = glfwGetTime();
+    int baked = 0;
+    for (int i = 0; i < g_next_add; ++i) {
+        FontEntry *entry = &g_fonts[i];
+        if (entry->state != FONT_ADDED || entry->base != i) continue;
+        if (!entry->tableLoaded) load_table(entry, i);
+        while (entry->bakeNext < entry->bakeCount) {
+            GlyphBake *bake = &entry->bakes[entry->bakeNext];
+            ImFontBaked *fontBaked = ImFont_GetFontBaked(entry->font, bake->header.size, bake->header.density);
+            while (fontBaked && entry->glyphNext < bake->header.count) {
+                uint32_t codepoint = bake->codepoints[entry->glyphNext++];
+                g_stats.prewarmLeft--;
+                if (sizeof(ImWchar) == 2 && codepoint > 0xFFFF) continue;
+                ImFontBaked_FindGlyph(fontBaked, (ImWchar)codepoint);
+                g_stats.prewarmed++;
+                if ((++baked & 15) == 0 && (glfwGetTime() - start)*1000.0 >= FONT_PREWARM_BUDGET_MS) {
+                    g_stats.prewarmMs += (glfwGetTime() - start)*1000.0;
+                    return;
+                }
+            }
+            if (!fontBaked) g_stats.prewarmLeft -= (int)(bake->header.count - entry->glyphNext);
+            entry->bakeNext++;
+            entry->glyphNext = 0;
+        }
+        if (entry->bakes) free_table(entry);
+    }
+    if (baked > 0) g_stats.prewarmMs += (glfwGetTime() - start)*1000.0;
+}
+
+void font_cache_update(void) {
+    if (g_font_count == 0) return;
+
+    // In request order, so a merged font always follows the one it extends
+    while (g_next_add < g_font_count) {
+        pthread_mutex_lock(&g_mutex);
+        FontState state = g_fonts[g_next_add].state;
+        pthread_mutex_unlock(&g_mutex);
+        if (state == FONT_QUEUED) break;
+        if (state == FONT_READY) {
+            add_font(g_next_add);
+        } else {
+            printf("Font cache: failed to read '%s'\n", g_fonts[g_next_add].path);
+            g_stats.failed++;
+        }
+        g_next_add++;
+    }
+
+    // Tables are keyed by every file merged into a font: wait for the queue to drain
+    if (g_next_add == g_font_count) prewarm();
+}
+
+FontCacheStats font_cache_get_stats(void) {
+    pthread_mutex_lock(&g_mutex);
+    FontCacheStats stats = g_stats;
+    pthread_mutex_unlock(&g_mutex);
+    stats.pending = g_font_count - g_next_add;
+    return stats;
+}
+
+//----------------------------------------------------------------------------------
+// Lua
+//----------------------------------------------------------------------------------
+
+// imgui.LoadFont(path, size, [merge]) -> id, returns immediately
+static int lua_imgui_load_font(lua_State *L) {
+    const char *path = luaL_checkstring(L, 1);
+    float size = (float)luaL_optnumber(L, 2, 16.0);
+    bool merge = lua_toboolean(L, 3);
+    int id = font_cache_load(path, size, merge);
+    if (id < 0) {
+        lua_pushnil(L);
+        return 1;
+    }
+    lua_pushinteger(L, id);
+    return 1;
+}
+
+// imgui.IsFontLoaded(id)
+static int lua_imgui_is_font_loaded(lua_State *L) {
+    lua_pushboolean(L, font_cache_get((int)luaL_checkinteger(L, 1)) != NULL);
+    return 1;
+}
+
+// imgui.SetDefaultFont(id)
+static int lua_imgui_set_default_font(lua_State *L) {
+    font_cache_set_default((int)luaL_checkinteger(L, 1));
+    return 0;
+}
+
+// imgui.PushFont(id, [size]), keeps the current font until id has loaded
+static int lua_imgui_push_font(lua_State *L) {
+    int id = (int)luaL_checkinteger(L, 1);
+    float size = (float)luaL_optnumber(L, 2, 0.0);
+    font_cache_note_size(id, size);
+    igPushFont(font_cache_get(id), size);
+    return 0;
+}
+
+// imgui.PopFont()
+static int lua_imgui_pop_font(lua_State *L) {
+    (void)L;
+    igPopFont();
+    return 0;
+}
+
+// imgui.GetFontCacheStats() -> {fonts, pending, failed, tableHits, ...}
+static int lua_imgui_get_font_cache_stats(lua_State *L) {
+    FontCacheStats stats = font_cache_get_stats();
+    lua_newtable(L);
+    lua_pushinteger(L, stats.fonts);       lua_setfield(L, -2, "fonts");
+    lua_pushinteger(L, stats.pending);     lua_setfield(L, -2, "pending");
+    lua_pushinteger(L, stats.failed);      lua_setfield(L, -2, "failed");
+    lua_pushinteger(L, stats.tableHits);   lua_setfield(L, -2, "tableHits");
+    lua_pushinteger(L, stats.tablesSaved); lua_setfield(L, -2, "tablesSaved");
+    lua_pushinteger(L, stats.prewarmed);   lua_setfield(L, -2, "prewarmed");
+    lua_pushinteger(L, stats.prewarmLeft); lua_setfield(L, -2, "prewarmLeft");
+    lua_pushnumber(L, stats.loadMs);       lua_setfield(L, -2, "loadMs");
+    lua_pushnumber(L, stats.prewarmMs);    lua_setfield(L, -2, "prewarmMs");
+    return 1;
+}
+
+static const luaL_Reg font_funcs[] = {
+    {"LoadFont", lua_imgui_load_font},
+    {"IsFontLoaded", lua_imgui_is_font_loaded},
+    {"SetDefaultFont", lua_imgui_set_default_font},
+    {"PushFont", lua_imgui_push_font},
+    {"PopFont", lua_imgui_pop_font},
+    {"GetFontCacheStats", lua_imgui_get_font_cache_stats},
+    {NULL, NULL}
+};
+
+void font_init(void) {
+    lua_State *L = lua_get_state();
+    if (!L) {
+        printf("Error: No Lua state available in font_init\n");
+        return;
+    }
+
+    lua_getglobal(L, "imgui");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setglobal(L, "imgui");
+    }
+    luaL_setfuncs(L, font_funcs, 0);
+    lua_settop(L, 0);
+    printf("font module initialized\n");
+}
+
+void font_cleanup(void) {
+    if (g_worker_running) {
+        pthread_mutex_lock(&g_mutex);
+        g_worker_stop = true;
+        pthread_cond_signal(&g_wake);
+        pthread_mutex_unlock(&g_mutex);
+        pthread_join(g_worker, NULL);
+        g_worker_running = false;
+    }
+
+    if (g_tables_enabled) {
+        for (int i = 0; i < g_next_add; ++i) {
+            if (g_fonts[i].state == FONT_ADDED && g_fonts[i].base == i) save_table(i);
+        }
+    }
+
+    // The atlas borrows the file data, drop our fonts before freeing it
+    if (g_stats.fonts > 0) ImFontAtlas_Clear(igGetIO()->Fonts);
+    for (int i = 0; i < g_font_count; ++i) {
+        free_table(&g_fonts[i]);
+        free(g_fonts[i].data);
+        g_fonts[i].data = NULL;
+    }
+    g_font_count = g_next_add = 0;
+    g_default = -1;
+    printf("font module cleaned up\n");
+}
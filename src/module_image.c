@@ -0,0 +1,487 @@
+// module_image.c
+// Image decode happens on IMAGE_WORKERS threads with raylib's LoadImage
+// (CPU only). Everything touching GL stays on the main thread: textures are
+// allocated empty, then filled top to bottom in row chunks copied into one
+// pixel unpack buffer that is orphaned each frame, so a chunk never waits on
+// the GPU reading the previous one. Without MapBufferRange the rows are
+// uploaded straight from memory, still in budgeted chunks.
+#include "module_image.h"
+#include "module_lua.h"
+#include "idle_mode.h"
+#include "gl_ext.h"
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cimgui.h"
+#include "raylib.h"
+#include "rlgl.h"
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>         // glfwGetTime()
+
+#define IMAGE_MAX_CHUNKS 32
+#define IMAGE_PLACEHOLDER_COLOR 0xFF3C3C3Cu     // ABGR
+#define IMAGE_FAILED_COLOR 0xFF3C3C8Cu
+
+typedef enum {
+    IMAGE_QUEUED = 0,       // Waiting for a worker
+    IMAGE_DECODING,
+    IMAGE_DECODED,          // Pixels in memory, handed to the main thread next update
+    IMAGE_UPLOADING,        // Main thread from here on
+    IMAGE_READY,
+    IMAGE_EVICTED,          // Texture dropped for the budget, decoded again on use
+    IMAGE_FAILED
+} ImageState;
+
+typedef struct ImageEntry {
+    char path[512];
+    ImageState state;       // Guarded by g_mutex up to IMAGE_DECODED
+    Image image;            // RGBA8 pixels while decoded / uploading
+    int width;
+    int height;
+    unsigned int texture;
+    int uploadRow;          // Rows already copied
+    unsigned int lastUsed;  // Frame of the last image_cache_use()
+    bool reported;          // Failure printed, drawn as a red placeholder
+} ImageEntry;
+
+typedef struct UploadChunk {
+    int entry;
+    int row;
+    int rows;
+    size_t offset;          // In the unpack buffer
+} UploadChunk;
+
+static ImageEntry *g_entries = NULL;
+static int g_entry_count = 0;
+static int g_entry_capacity = 0;
+static int *g_uploads = NULL;       // FIFO of entries in IMAGE_UPLOADING
+static int g_upload_count = 0;
+static unsigned int g_pbo = 0;
+static unsigned int g_frame = 0;
+static size_t g_budget = 0;
+static size_t g_vram = 0;
+static ImageCacheStats g_stats = { 0 };
+
+static pthread_t g_workers[IMAGE_WORKERS];
+static int g_worker_count = 0;
+static bool g_workers_stop = false;
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_wake = PTHREAD_COND_INITIALIZER;
+
+//----------------------------------------------------------------------------------
+// Workers
+//----------------------------------------------------------------------------------
+static void *worker_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&g_mutex);
+    for (;;) {
+        int next = -1;
+        for (int i = 0; i < g_entry_count; ++i) {
+            if (g_entries[i].state == IMAGE_QUEUED) { next = i; break; }
+        }
+        if (next < 0) {
+            if (g_workers_stop) break;
+            pthread_cond_wait(&g_wake, &g_mutex);
+            continue;
+        }
+        // g_entries may be reallocated by the main thread, only index it under the lock
+        char path[512];
+        memcpy(path, g_entries[next].path, sizeof(path));
+        g_entries[next].state = IMAGE_DECODING;
+        pthread_mutex_unlock(&g_mutex);
+
+        double start = glfwGetTime();
+        Image image = LoadImage(path);
+        if (image.data && image.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) {
+            ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        }
+        double ms = (glfwGetTime() - start)*1000.0;
+
+        pthread_mutex_lock(&g_mutex);
+        ImageEntry *entry = &g_entries[next];
+        entry->image = image;
+        entry->width = image.width;
+        entry->height = image.height;
+        entry->state = image.data ? IMAGE_DECODED : IMAGE_FAILED;
+        g_stats.decodeMs += ms;
+    }
+    pthread_mutex_unlock(&g_mutex);
+    return NULL;
+}
+
+static bool start_workers(void) {
+    if (g_worker_count > 0) return true;
+    g_workers_stop = false;
+    while (g_worker_count < IMAGE_WORKERS) {
+        if (pthread_create(&g_workers[g_worker_count], NULL, worker_main, NULL) != 0) break;
+        g_worker_count++;
+    }
+    if (g_worker_count == 0) printf("Images: failed to start decode threads\n");
+    return g_worker_count > 0;
+}
+
+//----------------------------------------------------------------------------------
+// Cache (main thread)
+//----------------------------------------------------------------------------------
+void image_cache_setup(size_t budgetBytes) {
+    g_budget = budgetBytes;
+    if (glext.BindBuffer && glext.BufferData && glext.MapBufferRange && glext.UnmapBuffer) {
+        g_pbo = rlLoadVertexBuffer(NULL, IMAGE_PBO_BYTES, true);    // Any buffer name can back an unpack buffer
+    }
+    printf("Images: %zu MB texture budget, %s uploads\n", budgetBytes/(1024*1024),
+           g_pbo ? "pixel buffer" : "direct");
+}
+
+void image_cache_set_budget(size_t budgetBytes) {
+    g_budget = budgetBytes;
+}
+
+int image_cache_load(const char *path) {
+    if (!path) return 0;
+    for (int i = 0; i < g_entry_count; ++i) {
+        if (strcmp(g_entries[i].path, path) == 0) return i + 1;
+    }
+    if (!start_workers()) return 0;
+
+    pthread_mutex_lock(&g_mutex);
+    if (g_entry_count == g_entry_capacity) {
+        int newCapacity = (g_entry_capacity == 0) ? 64 : g_entry_capacity*2;
+        ImageEntry *entries = (ImageEntry*)realloc(g_entries, (size_t)newCapacity*sizeof(ImageEntry));
+        int *uploads = (int*)realloc(g_uploads, (size_t)newCapacity*sizeof(int));
+        if (uploads) g_uploads = uploads;
+        if (!entries || !uploads) {
+            if (entries) g_entries = entries;
+            pthread_mutex_unlock(&g_mutex);
+            return 0;
+        }
+        g_entries = entries;
+        g_entry_capacity = newCapacity;
+    }
+    int index = g_entry_count++;
+    ImageEntry *entry = &g_entries[index];
+    memset(entry, 0, sizeof(ImageEntry));
+    snprintf(entry->path, sizeof(entry->path), "%s", path);
+    entry->state = IMAGE_QUEUED;
+    entry->lastUsed = g_frame;
+    pthread_cond_signal(&g_wake);
+    pthread_mutex_unlock(&g_mutex);
+    return index + 1;
+}
+
+unsigned int image_cache_use(int handle, int *width, int *height) {
+    *width = *height = 0;
+    if (handle < 1 || handle > g_entry_count) return 0;
+    ImageEntry *entry = &g_entries[handle - 1];
+    entry->lastUsed = g_frame;
+
+    pthread_mutex_lock(&g_mutex);
+    ImageState state = entry->state;
+    if (state == IMAGE_EVICTED) {
+        entry->state = IMAGE_QUEUED;
+        pthread_cond_signal(&g_wake);
+    }
+    if (state >= IMAGE_DECODED && state != IMAGE_FAILED) {
+        *width = entry->width;
+        *height = entry->height;
+    }
+    pthread_mutex_unlock(&g_mutex);
+    return (state == IMAGE_READY) ? entry->texture : 0;
+}
+
+static void finish_upload(ImageEntry *entry) {
+    UnloadImage(entry->image);
+    entry->image.data = NULL;
+    pthread_mutex_lock(&g_mutex);
+    entry->state = IMAGE_READY;
+    pthread_mutex_unlock(&g_mutex);
+    g_vram += (size_t)entry->width*entry->height*4;
+}
+
+static void pop_upload(void) {
+    memmove(g_uploads, g_uploads + 1, (size_t)(g_upload_count - 1)*sizeof(int));
+    g_upload_count--;
+}
+
+// Copy row chunks of the queued images into the unpack buffer, then issue
+// the texture updates once it is unmapped
+static void upload_pbo(double start) {
+    UploadChunk chunks[IMAGE_MAX_CHUNKS];
+    int chunkCount = 0;
+    size_t used = 0;
+
+    glext.BindBuffer(GL_PIXEL_UNPACK_BUFFER, g_pbo);
+    glext.BufferData(GL_PIXEL_UNPACK_BUFFER, IMAGE_PBO_BYTES, NULL, GL_STREAM_DRAW);  // Orphan
+    unsigned char *mapped = (unsigned char *)glext.MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, IMAGE_PBO_BYTES,
+                                                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!mapped) {
+        glext.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return;
+    }
+
+    int queue = 0;
+    while (queue < g_upload_count && chunkCount < IMAGE_MAX_CHUNKS) {
+        ImageEntry *entry = &g_entries[g_uploads[queue]];
+        size_t pitch = (size_t)entry->width*4;
+        int rows = (int)((IMAGE_PBO_BYTES - used)/pitch);
+        if (rows > entry->height - entry->uploadRow) rows = entry->height - entry->uploadRow;
+        if (rows <= 0) break;
+
+        memcpy(mapped + used, (unsigned char *)entry->image.data + (size_t)entry->uploadRow*pitch, (size_t)rows*pitch);
+        chunks[chunkCount++] = (UploadChunk){ g_uploads[queue], entry->uploadRow, rows, used };
+        used += (size_t)rows*pitch;
+        entry->uploadRow += rows;
+        if (entry->uploadRow == entry->height) queue++;
+        if ((glfwGetTime() - start)*1000.0 >= IMAGE_UPLOAD_BUDGET_MS) break;
+    }
+    glext.UnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    // With an unpack buffer bound the data pointer is an offset into it
+    for (int i = 0; i < chunkCount; ++i) {
+        ImageEntry *entry = &g_entries[chunks[i].entry];
+        rlUpdateTexture(entry->texture, 0, chunks[i].row, entry->width, chunks[i].rows,
+                        RL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, (const void *)(uintptr_t)chunks[i].offset);
+    }
+    glext.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);    // Client memory uploads (font atlas) expect none bound
+
+    for (; queue > 0; --queue) {
+        finish_upload(&g_entries[g_uploads[0]]);
+        pop_upload();
+    }
+    g_stats.uploadedBytes = (int)used;
+}
+
+static void upload_direct(double start) {
+    int bytes = 0;
+    while (g_upload_count > 0 && bytes < IMAGE_PBO_BYTES) {
+        ImageEntry *entry = &g_entries[g_uploads[0]];
+        int pitch = entry->width*4;
+        int rows = (IMAGE_PBO_BYTES - bytes)/pitch;
+        if (rows > entry->height - entry->uploadRow) rows = entry->height - entry->uploadRow;
+        if (rows <= 0) break;
+
+        rlUpdateTexture(entry->texture, 0, entry->uploadRow, entry->width, rows, RL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+                        (unsigned char *)entry->image.data + (size_t)entry->uploadRow*pitch);
+        bytes += rows*pitch;
+        entry->uploadRow += rows;
+        if (entry->uploadRow == entry->height) {
+            finish_upload(entry);
+            pop_upload();
+        }
+        if ((glfwGetTime() - start)*1000.0 >= IMAGE_UPLOAD_BUDGET_MS) break;
+    }
+    g_stats.uploadedBytes = bytes;
+}
+
+// Least recently drawn first, never something drawn in the last few frames
+static void evict(void) {
+    while (g_vram > g_budget) {
+        ImageEntry *oldest = NULL;
+        for (int i = 0; i < g_entry_count; ++i) {
+            ImageEntry *entry = &g_entries[i];
+            if (entry->state != IMAGE_READY || g_frame - entry->lastUsed < IMAGE_EVICT_MIN_FRAMES) continue;
+            if (!oldest || entry->lastUsed < oldest->lastUsed) oldest = entry;
+        }
+        if (!oldest) break;
+        rlUnloadTexture(oldest->texture);
+        oldest->texture = 0;
+        oldest->uploadRow = 0;
+        g_vram -= (size_t)oldest->width*oldest->height*4;
+        pthread_mutex_lock(&g_mutex);
+        oldest->state = IMAGE_EVICTED;
+        pthread_mutex_unlock(&g_mutex);
+        g_stats.evictions++;
+    }
+}
+
+void image_cache_update(void) {
+    g_frame++;
+    g_stats.uploadedBytes = 0;
+    g_stats.uploadMs = 0.0;
+    if (g_entry_count == 0) return;
+
+    // Take over what the workers finished, in the order it finished
+    pthread_mutex_lock(&g_mutex);
+    for (int i = 0; i < g_entry_count; ++i) {
+        ImageEntry *entry = &g_entries[i];
+        if (entry->state == IMAGE_FAILED && !entry->reported) {
+            entry->reported = true;
+            printf("Images: failed to load '%s'\n", entry->path);
+        }
+        if (entry->state != IMAGE_DECODED) continue;
+        entry->state = IMAGE_UPLOADING;
+        g_uploads[g_upload_count++] = i;
+    }
+    pthread_mutex_unlock(&g_mutex);
+
+    if (g_upload_count > 0) {
+        double start = glfwGetTime();
+        // Storage first: with an unpack buffer bound a NULL pixel pointer would read from it
+        for (int i = 0; i < g_upload_count; ++i) {
+            ImageEntry *entry = &g_entries[g_uploads[i]];
+            if (entry->texture != 0) continue;
+            entry->texture = rlLoadTexture(NULL, entry->width, entry->height, RL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+            rlTextureParameters(entry->texture, RL_TEXTURE_MIN_FILTER, RL_TEXTURE_FILTER_LINEAR);
+            rlTextureParameters(entry->texture, RL_TEXTURE_MAG_FILTER, RL_TEXTURE_FILTER_LINEAR);
+        }
+        if (g_pbo && (size_t)g_entries[g_uploads[0]].width*4 <= IMAGE_PBO_BYTES) upload_pbo(start);
+        else upload_direct(start);
+        g_stats.uploadMs = (glfwGetTime() - start)*1000.0;
+    }
+    evict();
+
+    // Keep frames coming while placeholders wait for their texture
+    if (image_cache_get_stats().pending > 0) idle_animate_for(0.1);
+}
+
+ImageCacheStats image_cache_get_stats(void) {
+    pthread_mutex_lock(&g_mutex);
+    ImageCacheStats stats = g_stats;
+    stats.images = g_entry_count;
+    stats.ready = stats.pending = stats.failed = 0;
+    for (int i = 0; i < g_entry_count; ++i) {
+        ImageState state = g_entries[i].state;
+        if (state == IMAGE_READY) stats.ready++;
+        else if (state == IMAGE_FAILED) stats.failed++;
+        else if (state != IMAGE_EVICTED) stats.pending++;
+    }
+    pthread_mutex_unlock(&g_mutex);
+    stats.vramBytes = g_vram;
+    stats.budgetBytes = g_budget;
+    return stats;
+}
+
+//----------------------------------------------------------------------------------
+// Lua
+//----------------------------------------------------------------------------------
+
+// imgui.LoadImage(path) -> handle, decoding starts in the background
+static int lua_imgui_load_image(lua_State *L) {
+    int handle = image_cache_load(luaL_checkstring(L, 1));
+    if (handle == 0) {
+        lua_pushnil(L);
+        return 1;
+    }
+    lua_pushinteger(L, handle);
+    return 1;
+}
+
+// imgui.Image(handle, [w], [h]) -> ready, placeholder until the texture is uploaded
+static int lua_imgui_image(lua_State *L) {
+    int handle = (int)luaL_checkinteger(L, 1);
+    int width = 0, height = 0;
+    unsigned int texture = image_cache_use(handle, &width, &height);
+    ImVec2 size = { (float)luaL_optnumber(L, 2, width > 0 ? width : 64),
+                    (float)luaL_optnumber(L, 3, height > 0 ? height : 64) };
+
+    if (texture != 0) {
+        ImTextureRef ref = { NULL, (ImTextureID)texture };
+        igImage(ref, size, (ImVec2){ 0.0f, 0.0f }, (ImVec2){ 1.0f, 1.0f });
+    } else {
+        ImVec2 pos;
+        igGetCursorScreenPos(&pos);
+        igDummy(size);
+        bool failed = (handle >= 1 && handle <= g_entry_count && g_entries[handle - 1].reported);
+        ImDrawList_AddRectFilled(igGetWindowDrawList(), pos, (ImVec2){ pos.x + size.x, pos.y + size.y },
+                                 failed ? IMAGE_FAILED_COLOR : IMAGE_PLACEHOLDER_COLOR, 0.0f, 0);
+    }
+    lua_pushboolean(L, texture != 0);
+    return 1;
+}
+
+// imgui.GetImageSize(handle) -> w, h (nil until decoded)
+static int lua_imgui_get_image_size(lua_State *L) {
+    int width = 0, height = 0;
+    image_cache_use((int)luaL_checkinteger(L, 1), &width, &height);
+    if (width == 0) {
+        lua_pushnil(L);
+        return 1;
+    }
+    lua_pushinteger(L, width);
+    lua_pushinteger(L, height);
+    return 2;
+}
+
+// imgui.SetImageBudget(megabytes)
+static int lua_imgui_set_image_budget(lua_State *L) {
+    double mb = luaL_checknumber(L, 1);
+    image_cache_set_budget((size_t)((mb > 0.0 ? mb : 0.0)*1024.0*1024.0));     // Fractional MB kept
+    return 0;
+}
+
+// imgui.GetImageCacheStats() -> {images, ready, pending, failed, evictions, vramMB, budgetMB, ...}
+static int lua_imgui_get_image_cache_stats(lua_State *L) {
+    ImageCacheStats stats = image_cache_get_stats();
+    lua_newtable(L);
+    lua_pushinteger(L, stats.images);                            lua_setfield(L, -2, "images");
+    lua_pushinteger(L, stats.ready);                             lua_setfield(L, -2, "ready");
+    lua_pushinteger(L, stats.pending);                           lua_setfield(L, -2, "pending");
+    lua_pushinteger(L, stats.failed);                            lua_setfield(L, -2, "failed");
+    lua_pushinteger(L, stats.evictions);                         lua_setfield(L, -2, "evictions");
+    lua_pushnumber(L, (double)stats.vramBytes/(1024.0*1024.0));   lua_setfield(L, -2, "vramMB");
+    lua_pushnumber(L, (double)stats.budgetBytes/(1024.0*1024.0)); lua_setfield(L, -2, "budgetMB");
+    lua_pushinteger(L, stats.uploadedBytes);                     lua_setfield(L, -2, "uploadedBytes");
+    lua_pushnumber(L, stats.uploadMs);                           lua_setfield(L, -2, "uploadMs");
+    lua_pushnumber(L, stats.decodeMs);                           lua_setfield(L, -2, "decodeMs");
+    return 1;
+}
+
+static const luaL_Reg image_funcs[] = {
+    {"LoadImage", lua_imgui_load_image},
+    {"Image", lua_imgui_image},
+    {"GetImageSize", lua_imgui_get_image_size},
+    {"SetImageBudget", lua_imgui_set_image_budget},
+    {"GetImageCacheStats", lua_imgui_get_image_cache_stats},
+    {NULL, NULL}
+};
+
+void image_init(void) {
+    lua_State *L = lua_get_state();
+    if (!L) {
+        printf("Error: No Lua state available in image_init\n");
+        return;
+    }
+
+    lua_getglobal(L, "imgui");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setglobal(L, "imgui");
+    }
+    luaL_setfuncs(L, image_funcs, 0);
+    lua_settop(L, 0);
+    printf("image module initialized\n");
+}
+
+void image_cleanup(void) {
+    if (g_worker_count > 0) {
+        pthread_mutex_lock(&g_mutex);
+        g_workers_stop = true;
+        for (int i = 0; i < g_entry_count; ++i) {
+            if (g_entries[i].state == IMAGE_QUEUED) g_entries[i].state = IMAGE_EVICTED;   // Don't start new decodes
+        }
+        pthread_cond_broadcast(&g_wake);
+        pthread_mutex_unlock(&g_mutex);
+        for (int i = 0; i < g_worker_count; ++i) pthread_join(g_workers[i], NULL);
+        g_worker_count = 0;
+    }
+
+    for (int i = 0; i < g_entry_count; ++i) {
+        if (g_entries[i].texture) rlUnloadTexture(g_entries[i].texture);
+        if (g_entries[i].image.data) UnloadImage(g_entries[i].image);
+    }
+    if (g_pbo) rlUnloadVertexBuffer(g_pbo);
+    g_pbo = 0;
+    free(g_entries);
+    free(g_uploads);
+    g_entries = NULL;
+    g_uploads = NULL;
+    g_entry_count = g_entry_capacity = g_upload_count = 0;
+    g_vram = 0;
+    printf("image module cleaned up\n");
+}
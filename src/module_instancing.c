@@ -0,0 +1,333 @@
+// module_instancing.c
+// Hardware instanced cubes: one VBO of per-instance transforms/colors, one draw call.
+#include "module_instancing.h"
+#include "module_lua.h"
+#include "module_batch.h"
+#include "module_shader.h"
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include "rlgl.h"
+#include "raymath.h"
+
+#define INSTANCE_BATCH_MT "rl.InstanceBatch"
+#define CUBE_VERTEX_COUNT 36
+
+static const char *instancing_vs =
+    "#version 330\n"
+    "in vec3 vertexPosition;\n"
+    "in vec3 vertexNormal;\n"
+    "in vec4 instanceColor;\n"
+    "in mat4 instanceTransform;\n"
+    "uniform mat4 mvp;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    vec3 n = normalize(mat3(instanceTransform)*vertexNormal);\n"
+    "    float light = 0.55 + 0.45*max(dot(n, normalize(vec3(0.4, 1.0, 0.6))), 0.0);\n"
+    "    fragColor = vec4(instanceColor.rgb*light, instanceColor.a);\n"
+    "    gl_Position = mvp*instanceTransform*vec4(vertexPosition, 1.0);\n"
+    "}\n";
+
+static const char *instancing_fs =
+    "#version 330\n"
+    "in vec4 fragColor;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    finalColor = fragColor;\n"
+    "}\n";
+
+// Shared cube mesh + shader (created on first batch)
+static unsigned int g_shader_id = 0;
+static unsigned int g_cube_vbo = 0;
+static int g_loc_mvp = -1;
+static int g_loc_position = -1;
+static int g_loc_normal = -1;
+static int g_loc_color = -1;
+static int g_loc_transform = -1;
+
+// Unit cube centered at origin, corners in CCW order seen from outside
+static const float cube_faces[6][4][3] = {
+    {{-0.5f,-0.5f, 0.5f}, { 0.5f,-0.5f, 0.5f}, { 0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}}, // Front
+    {{ 0.5f,-0.5f,-0.5f}, {-0.5f,-0.5f,-0.5f}, {-0.5f, 0.5f,-0.5f}, { 0.5f, 0.5f,-0.5f}}, // Back
+    {{-0.5f, 0.5f, 0.5f}, { 0.5f, 0.5f, 0.5f}, { 0.5f, 0.5f,-0.5f}, {-0.5f, 0.5f,-0.5f}}, // Top
+    {{-0.5f,-0.5f,-0.5f}, { 0.5f,-0.5f,-0.5f}, { 0.5f,-0.5f, 0.5f}, {-0.5f,-0.5f, 0.5f}}, // Bottom
+    {{ 0.5f,-0.5f, 0.5f}, { 0.5f,-0.5f,-0.5f}, { 0.5f, 0.5f,-0.5f}, { 0.5f, 0.5f, 0.5f}}, // Right
+    {{-0.5f,-0.5f,-0.5f}, {-0.5f,-0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f,-0.5f}}  // Left
+};
+static const float cube_normals[6][3] = {
+    {0,0,1}, {0,0,-1}, {0,1,0}, {0,-1,0}, {1,0,0}, {-1,0,0}
+};
+
+// Load shader and cube VBO once
+static bool instancing_load_shared(void) {
+    if (g_shader_id != 0) return true;
+
+    g_shader_id = shader_cache_load(instancing_vs, instancing_fs);
+    if (g_shader_id == 0) {
+        printf("Error: Failed to load instancing shader\n");
+        return false;
+    }
+    g_loc_mvp = rlGetLocationUniform(g_shader_id, "mvp");
+    g_loc_position = rlGetLocationAttrib(g_shader_id, "vertexPosition");
+    g_loc_normal = rlGetLocationAttrib(g_shader_id, "vertexNormal");
+    g_loc_color = rlGetLocationAttrib(g_shader_id, "instanceColor");
+    g_loc_transform = rlGetLocationAttrib(g_shader_id, "instanceTransform");
+
+    // Interleaved position + normal, two triangles per face
+    static const int corner_order[6] = { 0, 1, 2, 2, 3, 0 };
+    float vertices[CUBE_VERTEX_COUNT*6];
+    int v = 0;
+    for (int face = 0; face < 6; ++face) {
+        for (int i = 0; i < 6; ++i) {
+            const float *p = cube_faces[face][corner_order[i]];
+            vertices[v++] = p[0]; vertices[v++] = p[1]; vertices[v++] = p[2];
+            vertices[v++] = cube_normals[face][0];
+            vertices[v++] = cube_normals[face][1];
+            vertices[v++] = cube_normals[face][2];
+        }
+    }
+    g_cube_vbo = rlLoadVertexBuffer(vertices, sizeof(vertices), false);
+    return true;
+}
+
+InstanceBatch *instancing_batch_create(int capacity) {
+    // rlgl takes buffer sizes as int, every offset below stays under capacity*sizeof
+    if (capacity <= 0 || (size_t)capacity > INT_MAX/sizeof(InstanceData)) return NULL;
+    if (!instancing_load_shared()) return NULL;
+    // Optimised out or a broken shader; the normal is optional
+    if (g_loc_position < 0 || g_loc_transform < 0 || g_loc_color < 0) {
+        printf("Error: Instancing shader is missing position, transform or color attributes\n");
+        return NULL;
+    }
+
+    InstanceBatch *batch = (InstanceBatch*)calloc(1, sizeof(InstanceBatch));
+    if (!batch) return NULL;
+    batch->instances = (InstanceData*)calloc((size_t)capacity, sizeof(InstanceData));
+    if (!batch->instances) {
+        free(batch);
+        return NULL;
+    }
+    batch->capacity = capacity;
+    batch->count = 0;
+    batch->dirtyMin = -1;
+    batch->dirtyMax = -1;
+
+    batch->vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(batch->vaoId);
+
+    // Shared cube mesh (per-vertex)
+    rlEnableVertexBuffer(g_cube_vbo);
+    rlSetVertexAttribute(g_loc_position, 3, RL_FLOAT, false, 6*sizeof(float), 0);
+    rlEnableVertexAttribute(g_loc_position);
+    if (g_loc_normal >= 0) {
+        rlSetVertexAttribute(g_loc_normal, 3, RL_FLOAT, false, 6*sizeof(float), 3*sizeof(float));
+        rlEnableVertexAttribute(g_loc_normal);
+    }
+
+    // Instance buffer (per-instance), mat4 takes four consecutive locations
+    batch->instanceVboId = rlLoadVertexBuffer(NULL, capacity*(int)sizeof(InstanceData), true);
+    for (int i = 0; i < 4; ++i) {
+        rlSetVertexAttribute(g_loc_transform + i, 4, RL_FLOAT, false, sizeof(InstanceData), i*4*sizeof(float));
+        rlEnableVertexAttribute(g_loc_transform + i);
+        rlSetVertexAttributeDivisor(g_loc_transform + i, 1);
+    }
+    rlSetVertexAttribute(g_loc_color, 4, RL_UNSIGNED_BYTE, true, sizeof(InstanceData), offsetof(InstanceData, color));
+    rlEnableVertexAttribute(g_loc_color);
+    rlSetVertexAttributeDivisor(g_loc_color, 1);
+
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    return batch;
+}
+
+void instancing_batch_destroy(InstanceBatch *batch) {
+    if (!batch) return;
+    if (batch->vaoId) rlUnloadVertexArray(batch->vaoId);
+    if (batch->instanceVboId) rlUnloadVertexBuffer(batch->instanceVboId);
+    free(batch->instances);
+    free(batch);
+}
+
+// Build the column-major transform (translate * rotateY * scale) directly
+void instancing_batch_set(InstanceBatch *batch, int index, float x, float y, float z,
+                          float width, float height, float length, float rotationY,
+                          unsigned char r, unsigned char g, unsigned char b, unsigned char a) {
+    if (index < 0 || index >= batch->capacity) return;
+    float c = cosf(rotationY);
+    float s = sinf(rotationY);
+    InstanceData *inst = &batch->instances[index];
+    float *m = inst->transform;
+    m[0] = c*width;   m[1] = 0.0f;   m[2] = -s*width;  m[3] = 0.0f;
+    m[4] = 0.0f;      m[5] = height; m[6] = 0.0f;      m[7] = 0.0f;
+    m[8] = s*length;  m[9] = 0.0f;   m[10] = c*length; m[11] = 0.0f;
+    m[12] = x;        m[13] = y;     m[14] = z;        m[15] = 1.0f;
+    inst->color[0] = r; inst->color[1] = g; inst->color[2] = b; inst->color[3] = a;
+
+    if (batch->dirtyMin < 0 || index < batch->dirtyMin) batch->dirtyMin = index;
+    if (index > batch->dirtyMax) batch->dirtyMax = index;
+    if (index >= batch->count) batch->count = index + 1;
+}
+
+void instancing_batch_draw(InstanceBatch *batch) {
+    if (!batch || batch->count <= 0) return;
+
+    // Flush queued immediate-mode geometry so draw order is kept
+    batch_flush();
+
+    // Upload only the modified range
+    if (batch->dirtyMin >= 0) {
+        int first = batch->dirtyMin;
+        int count = batch->dirtyMax - batch->dirtyMin + 1;
+        rlUpdateVertexBuffer(batch->instanceVboId, &batch->instances[first],
+                             count*(int)sizeof(InstanceData), first*(int)sizeof(InstanceData));
+        batch->dirtyMin = -1;
+        batch->dirtyMax = -1;
+    }
+
+    Matrix mvp = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    rlEnableShader(g_shader_id);
+    rlSetUniformMatrix(g_loc_mvp, mvp);
+    rlEnableVertexArray(batch->vaoId);
+    rlDrawVertexArrayInstanced(0, CUBE_VERTEX_COUNT, batch->count);
+    rlDisableVertexArray();
+    rlDisableShader();
+}
+
+// Helper to get InstanceBatch userdata
+static InstanceBatch *check_instance_batch(lua_State *L, int index) {
+    InstanceBatch **ud = (InstanceBatch**)luaL_checkudata(L, index, INSTANCE_BATCH_MT);
+    if (!*ud) luaL_error(L, "instance batch already unloaded");
+    return *ud;
+}
+
+// rl.LoadInstanceBatch(capacity)
+static int lua_raylib_load_instance_batch(lua_State *L) {
+    int capacity = (int)luaL_checkinteger(L, 1);
+    InstanceBatch *batch = instancing_batch_create(capacity);
+    if (!batch) {
+        lua_pushnil(L);
+        return 1;
+    }
+    InstanceBatch **ud = (InstanceBatch**)lua_newuserdata(L, sizeof(InstanceBatch*));
+    *ud = batch;
+    luaL_getmetatable(L, INSTANCE_BATCH_MT);
+    lua_setmetatable(L, -2);
+    return 1;
+}
+
+// rl.UnloadInstanceBatch(batch)
+static int lua_raylib_unload_instance_batch(lua_State *L) {
+    InstanceBatch **ud = (InstanceBatch**)luaL_checkudata(L, 1, INSTANCE_BATCH_MT);
+    if (*ud) {
+        instancing_batch_destroy(*ud);
+        *ud = NULL;
+    }
+    return 0;
+}
+
+// rl.SetInstance(batch, index, x, y, z, width, height, length, rotationY, r, g, b, a)
+// index is 1-based, rotationY in radians, color defaults to white
+static int lua_raylib_set_instance(lua_State *L) {
+    InstanceBatch *batch = check_instance_batch(L, 1);
+    int index = (int)luaL_checkinteger(L, 2) - 1;
+    luaL_argcheck(L, index >= 0 && index < batch->capacity, 2, "instance index out of range");
+    instancing_batch_set(batch, index,
+        (float)luaL_checknumber(L, 3), (float)luaL_checknumber(L, 4), (float)luaL_checknumber(L, 5),
+        (float)luaL_optnumber(L, 6, 1.0), (float)luaL_optnumber(L, 7, 1.0), (float)luaL_optnumber(L, 8, 1.0),
+        (float)luaL_optnumber(L, 9, 0.0),
+        (unsigned char)luaL_optinteger(L, 10, 255), (unsigned char)luaL_optinteger(L, 11, 255),
+        (unsigned char)luaL_optinteger(L, 12, 255), (unsigned char)luaL_optinteger(L, 13, 255));
+    return 0;
+}
+
+// rl.SetInstanceCount(batch, count)
+static int lua_raylib_set_instance_count(lua_State *L) {
+    InstanceBatch *batch = check_instance_batch(L, 1);
+    int count = (int)luaL_checkinteger(L, 2);
+    if (count < 0) count = 0;
+    if (count > batch->capacity) count = batch->capacity;
+    batch->count = count;
+    return 0;
+}
+
+// rl.GetInstanceCount(batch)
+static int lua_raylib_get_instance_count(lua_State *L) {
+    InstanceBatch *batch = check_instance_batch(L, 1);
+    lua_pushinteger(L, batch->count);
+    lua_pushinteger(L, batch->capacity);
+    return 2;
+}
+
+// rl.DrawInstanceBatch(batch) - uses current rlgl projection/modelview
+static int lua_raylib_draw_instance_batch(lua_State *L) {
+    InstanceBatch *batch = check_instance_batch(L, 1);
+    instancing_batch_draw(batch);
+    return 0;
+}
+
+static int instance_batch_gc(lua_State *L) {
+    InstanceBatch **ud = (InstanceBatch**)luaL_checkudata(L, 1, INSTANCE_BATCH_MT);
+    if (*ud) {
+        instancing_batch_destroy(*ud);
+        *ud = NULL;
+    }
+    return 0;
+}
+
+static const struct luaL_Reg instancing_funcs[] = {
+    {"LoadInstanceBatch", lua_raylib_load_instance_batch},
+    {"UnloadInstanceBatch", lua_raylib_unload_instance_batch},
+    {"SetInstance", lua_raylib_set_instance},
+    {"SetInstanceCount", lua_raylib_set_instance_count},
+    {"GetInstanceCount", lua_raylib_get_instance_count},
+    {"DrawInstanceBatch", lua_raylib_draw_instance_batch},
+    {NULL, NULL}
+};
+
+static const struct luaL_Reg instance_batch_mt[] = {
+    {"__gc", instance_batch_gc},
+    {NULL, NULL}
+};
+
+// Add instancing functions to the global 'rl' table (call after raylib_init)
+void instancing_init(void) {
+    lua_State *L = lua_get_state();
+    if (!L) {
+        printf("Error: No Lua state available in instancing_init\n");
+        return;
+    }
+
+    luaL_newmetatable(L, INSTANCE_BATCH_MT);
+    luaL_setfuncs(L, instance_batch_mt, 0);
+    lua_pop(L, 1);
+
+    lua_getglobal(L, "rl");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setglobal(L, "rl");
+    }
+    luaL_setfuncs(L, instancing_funcs, 0);
+    lua_settop(L, 0);
+
+    printf("instancing module initialized\n");
+}
+
+void instancing_cleanup(void) {
+    if (g_cube_vbo) {
+        rlUnloadVertexBuffer(g_cube_vbo);
+        g_cube_vbo = 0;
+    }
+    if (g_shader_id) {
+        shader_cache_release(g_shader_id);
+        g_shader_id = 0;
+    }
+    printf("instancing module cleaned up\n");
+}
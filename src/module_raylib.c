@@ -1,6 +1,8 @@
 // module_raylib.c
 #include "module_raylib.h"
 #include "module_lua.h"
+#include "module_batch.h"
+#include "app_clock.h"
 #include <lua.h>
 #include <lauxlib.h>
 #include <lualib.h>
@@ -9,7 +11,7 @@
 #include <GLFW/glfw3.h>
 
 // Helper function to push a Vector3 to Lua
-static void push_vector3(lua_State *L, Vector3 v) {
+void push_vector3(lua_State *L, Vector3 v) {
     lua_newtable(L);
     lua_pushnumber(L, v.x); lua_setfield(L, -2, "x");
     lua_pushnumber(L, v.y); lua_setfield(L, -2, "y");
@@ -17,7 +19,7 @@ static void push_vector3(lua_State *L, Vector3 v) {
 }
 
 // Helper function to get a Vector3 from Lua
-static Vector3 get_vector3(lua_State *L, int index) {
+Vector3 get_vector3(lua_State *L, int index) {
     Vector3 v = {0};
     lua_getfield(L, index, "x"); v.x = lua_tonumber(L, -1); lua_pop(L, 1);
     lua_getfield(L, index, "y"); v.y = lua_tonumber(L, -1); lua_pop(L, 1);
@@ -26,7 +28,7 @@ static Vector3 get_vector3(lua_State *L, int index) {
 }
 
 // Helper function to push a Matrix to Lua
-static void push_matrix(lua_State *L, Matrix m) {
+void push_matrix(lua_State *L, Matrix m) {
     lua_newtable(L);
     lua_pushnumber(L, m.m0);  lua_setfield(L, -2, "m0");
     lua_pushnumber(L, m.m1);  lua_setfield(L, -2, "m1");
@@ -47,7 +49,7 @@ static void push_matrix(lua_State *L, Matrix m) {
 }
 
 // Helper function to get a Matrix from Lua
-static Matrix get_matrix(lua_State *L, int index) {
+Matrix get_matrix(lua_State *L, int index) {
     Matrix m = {0};
     lua_getfield(L, index, "m0");  m.m0  = lua_tonumber(L, -1); lua_pop(L, 1);
     lua_getfield(L, index, "m1");  m.m1  = lua_tonumber(L, -1); lua_pop(L, 1);
@@ -68,9 +70,9 @@ static Matrix get_matrix(lua_State *L, int index) {
     return m;
 }
 
-// Lua binding for GetTime
+// Lua binding for GetTime (simulated time in headless runs)
 static int lua_raylib_get_time(lua_State *L) {
-    lua_pushnumber(L, glfwGetTime());
+    lua_pushnumber(L, app_clock_now());
     return 1;
 }
 
@@ -146,6 +148,7 @@ static int lua_raylib_begin(lua_State *L) {
 // Lua binding for rlEnd
 static int lua_raylib_end(lua_State *L) {
     rlEnd();
+    batch_sample();   // Catch mid-frame batch flushes
     return 0;
 }
 
@@ -0,0 +1,836 @@
+// module_replication.c
+#undef ENET_IMPLEMENTATION      // Compiled once, in module_enet.c
+#include <enet.h>
+#include "module_replication.h"
+#include "module_lua.h"
+#include "module_enet.h"
+#include "net_thread.h"
+#include "packet_codec.h"
+#include "packet_pool.h"
+#include <lauxlib.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPL_WORLD_MT "ReplicationWorld"
+#define REPL_RECORD_RESERVE (16 + REPL_MAX_FIELDS*PACKET_VARINT_MAX)   // Worst case record
+
+typedef enum ReplRecord {
+    REPL_RECORD_UPDATE,
+    REPL_RECORD_CREATE,
+    REPL_RECORD_DESTROY,
+} ReplRecord;
+
+typedef enum ReplKind {
+    REPL_FLOAT,         // Quantised between min and max
+    REPL_F32,
+    REPL_U8,
+    REPL_U16,
+    REPL_U32,
+    REPL_I32,
+    REPL_BOOL,
+    REPL_VARINT,
+    REPL_KIND_COUNT
+} ReplKind;
+
+static const char *g_kind_names[REPL_KIND_COUNT] = { "float", "f32", "u8", "u16", "u32", "i32", "bool", "varint" };
+static const int g_kind_bytes[REPL_KIND_COUNT] = { 0, 4, 1, 2, 4, 4, 1, 0 };   // 0 = per field / variable
+
+typedef struct ReplField {
+    char name[REPL_NAME_MAX];
+    ReplKind kind;
+    int bytes;              // Wire size, 0 = varint
+    float min;              // REPL_FLOAT only
+    float max;
+    uint32_t steps;         // (1 << bits) - 1
+} ReplField;
+
+typedef struct ReplClass {
+    int fieldCount;
+    ReplField fields[REPL_MAX_FIELDS];
+} ReplClass;
+
+typedef struct ReplObject {
+    bool alive;
+    uint16_t classId;       // Index into classes
+    uint32_t spawnTick;
+    uint32_t destroyTick;
+    uint32_t changedTick;   // Latest field tick, objects older than a baseline are skipped whole
+    uint32_t seenTick;      // Client: last packet with a create record for it
+} ReplObject;
+
+typedef struct ReplPeer {
+    ENetPeer *peer;
+    uint32_t connectID;     // Connection the peer held when added
+    uint32_t acked;         // Baseline, 0 = nothing acknowledged
+    int64_t bytes;          // Sent since added
+} ReplPeer;
+
+typedef struct ReplWorld {
+    ReplClass *classes;
+    int classCount;
+    ReplObject *objects;
+    uint32_t *values;       // Wire values (quantised / raw bits), REPL_MAX_FIELDS per object
+    uint32_t *fieldTicks;   // Tick that carries each field's last change
+    int maxObjects;
+    int highWater;          // Slots ever used
+    int *freeSlots;
+    int freeCount;
+    int aliveCount;
+    uint32_t tick;          // Last sent (server) or applied (client)
+    ReplPeer *peers;
+    int peerCount;
+    int peerCapacity;
+    // Last tick
+    int64_t sentBytes;
+    int64_t fullBytes;      // What full snapshots would have cost
+    int packets;
+    struct ReplWorld *prev; // Live worlds, for replication_forget_*
+    struct ReplWorld *next;
+} ReplWorld;
+
+typedef struct ReplBuffer {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} ReplBuffer;
+
+// Local Lua state
+static lua_State* g_lua_state = NULL;
+static ReplWorld *g_worlds = NULL;
+
+// Value conversion
+
+static uint32_t quantise(const ReplField *field, double value) {
+    if (!(value > field->min)) return 0;        // Also NaN
+    if (value >= field->max) return field->steps;
+    return (uint32_t)((value - field->min)/(field->max - field->min)*field->steps + 0.5);
+}
+
+static uint32_t check_value(lua_State *L, const ReplField *field, int idx) {
+    switch (field->kind) {
+    case REPL_FLOAT:
+        return quantise(field, luaL_checknumber(L, idx));
+    case REPL_F32: {
+        float value = (float)luaL_checknumber(L, idx);
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    case REPL_BOOL:
+        return lua_toboolean(L, idx) ? 1 : 0;
+    case REPL_I32: {
+        lua_Integer value = luaL_checkinteger(L, idx);
+        if (value < INT32_MIN || value > INT32_MAX) luaL_error(L, "field '%s' out of range for i32", field->name);
+        return (uint32_t)(int32_t)value;
+    }
+    default: {
+        lua_Integer value = luaL_checkinteger(L, idx);
+        uint64_t limit = (field->kind == REPL_U8) ? UINT8_MAX : (field->kind == REPL_U16) ? UINT16_MAX : UINT32_MAX;
+        if (value < 0 || (uint64_t)value > limit) {
+            luaL_error(L, "field '%s' out of range for %s", field->name, g_kind_names[field->kind]);
+        }
+        return (uint32_t)value;
+    }
+    }
+}
+
+static void push_value(lua_State *L, const ReplField *field, uint32_t bits) {
+    switch (field->kind) {
+    case REPL_FLOAT:
+        lua_pushnumber(L, field->min + (double)bits*(field->max - field->min)/field->steps);
+        break;
+    case REPL_F32: {
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        lua_pushnumber(L, value);
+        break;
+    }
+    case REPL_BOOL:
+        lua_pushboolean(L, bits != 0);
+        break;
+    case REPL_I32:
+        lua_pushinteger(L, (int32_t)bits);
+        break;
+    default:
+        lua_pushinteger(L, bits);
+        break;
+    }
+}
+
+// World
+
+static ReplWorld *check_world(lua_State *L, int idx) {
+    ReplWorld *world = (ReplWorld*)luaL_checkudata(L, idx, REPL_WORLD_MT);
+    if (!world->objects) luaL_error(L, "replication world was freed");
+    return world;
+}
+
+// Object id (slot + 1) at idx; alive unless allowDead
+static int check_slot(lua_State *L, ReplWorld *world, int idx, bool allowDead) {
+    lua_Integer id = luaL_checkinteger(L, idx);
+    luaL_argcheck(L, id >= 1 && id <= world->highWater, idx, "unknown object id");
+    if (!allowDead && !world->objects[id - 1].alive) luaL_argerror(L, idx, "object was destroyed");
+    return (int)id - 1;
+}
+
+// Field index of a name or 1-based index at idx
+static int check_field(lua_State *L, const ReplClass *cls, int idx) {
+    if (lua_type(L, idx) == LUA_TNUMBER) {
+        lua_Integer index = lua_tointeger(L, idx);
+        luaL_argcheck(L, index >= 1 && index <= cls->fieldCount, idx, "field index out of range");
+        return (int)index - 1;
+    }
+    const char *name = luaL_checkstring(L, idx);
+    for (int f = 0; f < cls->fieldCount; ++f) {
+        if (strcmp(cls->fields[f].name, name) == 0) return f;
+    }
+    luaL_error(L, "unknown field '%s'", name);
+    return 0;
+}
+
+static void set_field(ReplWorld *world, int slot, int f, uint32_t bits) {
+    size_t at = (size_t)slot*REPL_MAX_FIELDS + (size_t)f;
+    if (world->values[at] == bits) return;      // Same after quantisation, nothing to send
+    world->values[at] = bits;
+    world->fieldTicks[at] = world->tick + 1;
+    world->objects[slot].changedTick = world->tick + 1;
+}
+
+// Fields of the table at idx that the class knows, others are ignored
+static void set_from_table(lua_State *L, ReplWorld *world, int slot, int idx) {
+    const ReplClass *cls = &world->classes[world->objects[slot].classId];
+    for (int f = 0; f < cls->fieldCount; ++f) {
+        if (lua_getfield(L, idx, cls->fields[f].name) != LUA_TNIL) {
+            set_field(world, slot, f, check_value(L, &cls->fields[f], -1));
+        }
+        lua_pop(L, 1);
+    }
+}
+
+// repl.world([maxObjects]) -> world
+static int l_repl_world(lua_State *L) {
+    lua_Integer maxObjects = luaL_optinteger(L, 1, REPL_DEFAULT_OBJECTS);
+    luaL_argcheck(L, maxObjects >= 1 && maxObjects <= REPL_MAX_OBJECTS, 1, "object count out of range");
+
+    ReplWorld *world = (ReplWorld*)lua_newuserdatauv(L, sizeof(ReplWorld), 0);
+    memset(world, 0, sizeof(*world));
+    luaL_setmetatable(L, REPL_WORLD_MT);
+    size_t fieldSlots = (size_t)maxObjects*REPL_MAX_FIELDS;
+    world->classes = (ReplClass*)calloc(REPL_MAX_CLASSES, sizeof(ReplClass));
+    world->objects = (ReplObject*)calloc((size_t)maxObjects, sizeof(ReplObject));
+    world->values = (uint32_t*)calloc(fieldSlots, sizeof(uint32_t));
+    world->fieldTicks = (uint32_t*)calloc(fieldSlots, sizeof(uint32_t));
+    world->freeSlots = (int*)malloc((size_t)maxObjects*sizeof(int));
+    world->maxObjects = (int)maxObjects;
+    if (!world->classes || !world->objects || !world->values || !world->fieldTicks || !world->freeSlots) {
+        free(world->classes);
+        free(world->objects);
+        free(world->values);
+        free(world->fieldTicks);
+        free(world->freeSlots);
+        world->objects = NULL;
+        return luaL_error(L, "replication world: out of memory");
+    }
+    world->next = g_worlds;
+    if (g_worlds) g_worlds->prev = world;
+    g_worlds = world;
+    return 1;
+}
+
+// world:class({ {"x", "float", min, max, bits}, {"hp", "u8"}, ... }) -> class id
+// Types: float (quantised, bits 1..32) f32 u8 u16 u32 i32 bool varint.
+// Client and server must define the same classes in the same order.
+static int l_world_class(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    luaL_checktype(L, 2, LUA_TTABLE);
+    if (world->classCount >= REPL_MAX_CLASSES) return luaL_error(L, "replication: more than %d classes", REPL_MAX_CLASSES);
+    int count = (int)lua_rawlen(L, 2);
+    luaL_argcheck(L, count >= 1 && count <= REPL_MAX_FIELDS, 2, "1 to 32 fields expected");
+
+    ReplClass cls;
+    memset(&cls, 0, sizeof(cls));
+    for (int i = 1; i <= count; ++i) {
+        if (lua_rawgeti(L, 2, i) != LUA_TTABLE) return luaL_error(L, "replication: field %d is not a { name, type, ... } table", i);
+        int spec = lua_gettop(L);
+        ReplField *field = &cls.fields[i - 1];
+        lua_rawgeti(L, spec, 1);
+        lua_rawgeti(L, spec, 2);
+        size_t nameLength;
+        const char *name = lua_tolstring(L, -2, &nameLength);
+        const char *kind = lua_tostring(L, -1);
+        if (!name || !kind || nameLength == 0 || nameLength >= REPL_NAME_MAX) {
+            return luaL_error(L, "replication: field %d needs a name (1 to %d characters) and a type", i, REPL_NAME_MAX - 1);
+        }
+        memcpy(field->name, name, nameLength + 1);
+        field->kind = REPL_KIND_COUNT;
+        for (int k = 0; k < REPL_KIND_COUNT; ++k) {
+            if (strcmp(kind, g_kind_names[k]) == 0) field->kind = (ReplKind)k;
+        }
+        if (field->kind == REPL_KIND_COUNT) return luaL_error(L, "replication: field '%s' has unknown type '%s'", name, kind);
+        field->bytes = g_kind_bytes[field->kind];
+        if (field->kind == REPL_FLOAT) {
+            lua_rawgeti(L, spec, 3);
+            lua_rawgeti(L, spec, 4);
+            lua_rawgeti(L, spec, 5);
+            field->min = (float)luaL_checknumber(L, -3);
+            field->max = (float)luaL_checknumber(L, -2);
+            lua_Integer bits = luaL_optinteger(L, -1, 16);
+            if (!(field->max > field->min) || bits < 1 || bits > 32) {
+                return luaL_error(L, "replication: float field '%s' needs min < max and 1 to 32 bits", name);
+            }
+            field->steps = (bits == 32) ? UINT32_MAX : (1u << bits) - 1;
+            field->bytes = (int)(bits + 7)/8;
+            lua_pop(L, 3);
+        }
+        lua_settop(L, spec - 1);
+    }
+    cls.fieldCount = count;
+    world->classes[world->classCount++] = cls;
+    lua_pushinteger(L, world->classCount);
+    return 1;
+}
+
+// world:spawn(class, [values]) -> id, ids of destroyed objects are reused
+static int l_world_spawn(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    lua_Integer classId = luaL_checkinteger(L, 2);
+    luaL_argcheck(L, classId >= 1 && classId <= world->classCount, 2, "unknown class");
+    int slot;
+    if (world->freeCount > 0) slot = world->freeSlots[--world->freeCount];
+    else if (world->highWater < world->maxObjects) slot = world->highWater++;
+    else return luaL_error(L, "replication: world is full (%d objects)", world->maxObjects);
+
+    ReplObject *object = &world->objects[slot];
+    object->alive = true;
+    object->classId = (uint16_t)(classId - 1);
+    object->spawnTick = world->tick + 1;
+    object->destroyTick = 0;
+    object->changedTick = world->tick + 1;
+    size_t at = (size_t)slot*REPL_MAX_FIELDS;
+    memset(world->values + at, 0, REPL_MAX_FIELDS*sizeof(uint32_t));
+    for (int f = 0; f < REPL_MAX_FIELDS; ++f) world->fieldTicks[at + f] = world->tick + 1;
+    world->aliveCount++;
+    if (lua_istable(L, 3)) set_from_table(L, world, slot, 3);
+    lua_pushinteger(L, slot + 1);
+    return 1;
+}
+
+// world:destroy(id)
+static int l_world_destroy(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    int slot = check_slot(L, world, 2, false);
+    ReplObject *object = &world->objects[slot];
+    object->alive = false;
+    object->destroyTick = world->tick + 1;
+    world->freeSlots[world->freeCount++] = slot;
+    world->aliveCount--;
+    return 0;
+}
+
+// world:set(id, field, value) or world:set(id, { field = value, ... })
+// Only values that change after quantisation are sent
+static int l_world_set(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    int slot = check_slot(L, world, 2, false);
+    if (lua_istable(L, 3)) {
+        set_from_table(L, world, slot, 3);
+        return 0;
+    }
+    const ReplClass *cls = &world->classes[world->objects[slot].classId];
+    int f = check_field(L, cls, 3);
+    set_field(world, slot, f, check_value(L, &cls->fields[f], 4));
+    return 0;
+}
+
+// world:get(id, field) -> value as the peers see it (quantised)
+static int l_world_get(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    int slot = check_slot(L, world, 2, false);
+    const ReplClass *cls = &world->classes[world->objects[slot].classId];
+    int f = check_field(L, cls, 3);
+    push_value(L, &cls->fields[f], world->values[(size_t)slot*REPL_MAX_FIELDS + (size_t)f]);
+    return 1;
+}
+
+// world:get_object(id, [out]) -> { field = value, ... }, class
+static int l_world_get_object(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    int slot = check_slot(L, world, 2, false);
+    const ReplClass *cls = &world->classes[world->objects[slot].classId];
+    if (lua_istable(L, 3)) lua_settop(L, 3);
+    else lua_createtable(L, 0, cls->fieldCount);
+    for (int f = 0; f < cls->fieldCount; ++f) {
+        push_value(L, &cls->fields[f], world->values[(size_t)slot*REPL_MAX_FIELDS + (size_t)f]);
+        lua_setfield(L, -2, cls->fields[f].name);
+    }
+    lua_pushinteger(L, world->objects[slot].classId + 1);
+    return 2;
+}
+
+// world:exists(id) -> alive
+static int l_world_exists(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    lua_Integer id = luaL_checkinteger(L, 2);
+    lua_pushboolean(L, id >= 1 && id <= world->highWater && world->objects[id - 1].alive);
+    return 1;
+}
+
+// Peers
+
+static int find_peer(const ReplWorld *world, const ENetPeer *peer) {
+    for (int i = 0; i < world->peerCount; ++i) {
+        if (world->peers[i].peer == peer) return i;
+    }
+    return -1;
+}
+
+static void remove_peer_at(ReplWorld *world, int index) {
+    world->peers[index] = world->peers[--world->peerCount];
+}
+
+// world:add_peer(peer), starts with a full snapshot
+static int l_world_add_peer(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    ENetPeer *peer = enet_check_peer(L, 2);
+    if (find_peer(world, peer) >= 0) return 0;
+    if (world->peerCount == world->peerCapacity) {
+        int capacity = world->peerCapacity ? world->peerCapacity*2 : 16;
+        ReplPeer *peers = (ReplPeer*)realloc(world->peers, (size_t)capacity*sizeof(ReplPeer));
+        if (!peers) return luaL_error(L, "replication: out of memory");
+        world->peers = peers;
+        world->peerCapacity = capacity;
+    }
+    world->peers[world->peerCount++] = (ReplPeer){ peer, peer->connectID, 0, 0 };
+    return 0;
+}
+
+// world:remove_peer(peer)
+static int l_world_remove_peer(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    int index = find_peer(world, enet_check_peer(L, 2));
+    if (index >= 0) remove_peer_at(world, index);
+    return 0;
+}
+
+// world:ack(peer, tick), the tick the client reported from apply()
+static int l_world_ack(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    int index = find_peer(world, enet_check_peer(L, 2));
+    lua_Integer tick = luaL_checkinteger(L, 3);
+    if (index >= 0 && tick > world->peers[index].acked && tick <= world->tick) {
+        world->peers[index].acked = (uint32_t)tick;
+    }
+    return 0;
+}
+
+// Encoding
+
+static bool buffer_reserve(ReplBuffer *buffer, size_t size) {
+    if (buffer->size + size <= buffer->capacity) return true;
+    size_t want = buffer->capacity ? buffer->capacity*2 : PACKET_POOL_MIN_BLOCK;
+    while (want < buffer->size + size) want *= 2;
+    unsigned char *data = (unsigned char*)packet_pool_grow(buffer->data, buffer->size, want, &buffer->capacity);
+    if (!data) return false;
+    buffer->data = data;
+    return true;
+}
+
+static void put_varint(ReplBuffer *buffer, uint64_t value) {
+    buffer->size += (size_t)packet_store_varint(buffer->data + buffer->size, value);
+}
+
+static void put_field(ReplBuffer *buffer, const ReplField *field, uint32_t bits) {
+    if (field->bytes) {
+        packet_store_le(buffer->data + buffer->size, bits, field->bytes);
+        buffer->size += (size_t)field->bytes;
+    } else {
+        put_varint(buffer, bits);
+    }
+}
+
+static size_t varint_size(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+// Records for a peer whose baseline is base; false when out of memory
+static bool encode_delta(const ReplWorld *world, uint32_t base, ReplBuffer *buffer, int *records) {
+    *records = 0;
+    for (int slot = 0; slot < world->highWater; ++slot) {
+        const ReplObject *object = &world->objects[slot];
+        ReplRecord kind;
+        if (!object->alive) {
+            // Spawned after the baseline: the client drops it for the missing create
+            if (object->destroyTick <= base || object->spawnTick > base) continue;
+            kind = REPL_RECORD_DESTROY;
+        } else if (object->spawnTick > base) {
+            kind = REPL_RECORD_CREATE;
+        } else if (object->changedTick > base) {
+            kind = REPL_RECORD_UPDATE;
+        } else {
+            continue;
+        }
+        if (!buffer_reserve(buffer, REPL_RECORD_RESERVE)) return false;
+        put_varint(buffer, ((uint64_t)slot << 2) | kind);
+        (*records)++;
+        if (kind == REPL_RECORD_DESTROY) continue;
+
+        const ReplClass *cls = &world->classes[object->classId];
+        const uint32_t *values = world->values + (size_t)slot*REPL_MAX_FIELDS;
+        const uint32_t *ticks = world->fieldTicks + (size_t)slot*REPL_MAX_FIELDS;
+        uint32_t mask = 0;
+        // Ticks go as ages, the client skips events for what it already has
+        if (kind == REPL_RECORD_CREATE) {
+            put_varint(buffer, object->classId + 1u);
+            put_varint(buffer, world->tick - object->spawnTick);
+            put_varint(buffer, object->changedTick - object->spawnTick);
+            mask = (cls->fieldCount == 32) ? UINT32_MAX : (1u << cls->fieldCount) - 1;
+        } else {
+            for (int f = 0; f < cls->fieldCount; ++f) {
+                if (ticks[f] > base) mask |= 1u << f;
+            }
+            put_varint(buffer, world->tick - object->changedTick);
+            put_varint(buffer, mask);
+        }
+        for (int f = 0; f < cls->fieldCount; ++f) {
+            if (mask & (1u << f)) put_field(buffer, &cls->fields[f], values[f]);
+        }
+    }
+    return true;
+}
+
+// Size of a full snapshot, for the bandwidth stats
+static int64_t full_snapshot_bytes(const ReplWorld *world) {
+    int64_t bytes = 0;
+    for (int slot = 0; slot < world->highWater; ++slot) {
+        const ReplObject *object = &world->objects[slot];
+        if (!object->alive) continue;
+        const ReplClass *cls = &world->classes[object->classId];
+        const uint32_t *values = world->values + (size_t)slot*REPL_MAX_FIELDS;
+        bytes += (int64_t)(varint_size((uint64_t)slot << 2) + varint_size(object->classId + 1u) +
+                           varint_size(world->tick - object->spawnTick) + varint_size(object->changedTick - object->spawnTick));
+        for (int f = 0; f < cls->fieldCount; ++f) {
+            bytes += cls->fields[f].bytes ? cls->fields[f].bytes : (int64_t)varint_size(values[f]);
+        }
+    }
+    return bytes;
+}
+
+// Threaded hosts check the connection, the slot may be reused before the
+// disconnect reaches the main thread
+static bool send_to_peer(const ReplPeer *target, uint8_t channelID, ReplBuffer *buffer, uint32_t flags) {
+    ENetPeer *peer = target->peer;
+    ENetPacket *packet = packet_pool_packet(buffer->data, buffer->size, flags);
+    if (!packet) return false;
+    buffer->data = NULL;        // The packet owns it now
+    buffer->size = buffer->capacity = 0;
+    bool sent = net_thread_is_running(peer->host) ? net_thread_send_to((NetThreadTarget){ peer, target->connectID }, channelID, packet)
+                                                  : enet_peer_send(peer, channelID, packet) == 0;
+    if (!sent) enet_packet_destroy(packet);
+    return sent;
+}
+
+// world:tick(channel, [flags], [prefix]) -> tick, bytes sent
+// Advances the tick and sends each peer its delta; prefix bytes go in front
+// for the script's own message routing (pass the offset to apply)
+static int l_world_tick(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    enet_uint8 channelID = (enet_uint8)luaL_checkinteger(L, 2);
+    uint32_t flags = (uint32_t)luaL_optinteger(L, 3, 0);
+    size_t prefixLength = 0;
+    const char *prefix = luaL_optlstring(L, 4, "", &prefixLength);
+
+    world->tick++;
+    world->sentBytes = 0;
+    world->packets = 0;
+    int64_t full = full_snapshot_bytes(world);
+    world->fullBytes = 0;
+    for (int i = 0; i < world->peerCount; ++i) {
+        ReplPeer *target = &world->peers[i];
+        ReplBuffer buffer = { 0 };
+        if (!buffer_reserve(&buffer, prefixLength + 2*PACKET_VARINT_MAX)) return luaL_error(L, "replication: out of memory");
+        memcpy(buffer.data, prefix, prefixLength);
+        buffer.size = prefixLength;
+        put_varint(&buffer, world->tick);
+        put_varint(&buffer, target->acked);
+        world->fullBytes += full + (int64_t)buffer.size;
+        int records;
+        if (!encode_delta(world, target->acked, &buffer, &records)) {
+            packet_pool_free(buffer.data);
+            return luaL_error(L, "replication: out of memory");
+        }
+        if (records == 0 && target->acked > 0) {
+            packet_pool_free(buffer.data);   // Nothing new since the baseline
+            continue;
+        }
+        size_t size = buffer.size;
+        if (send_to_peer(target, channelID, &buffer, flags)) {
+            target->bytes += (int64_t)size;
+            world->sentBytes += (int64_t)size;
+            world->packets++;
+        }
+        packet_pool_free(buffer.data);  // Only left on failure
+    }
+    lua_pushinteger(L, world->tick);
+    lua_pushinteger(L, world->sentBytes);
+    return 2;
+}
+
+// Decoding
+
+// Reused array events[name], cleared to n = 0
+static int event_list(lua_State *L, int events, const char *name) {
+    if (lua_getfield(L, events, name) != LUA_TTABLE) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, events, name);
+    }
+    lua_pushinteger(L, 0);
+    lua_setfield(L, -2, "n");
+    return lua_gettop(L);
+}
+
+static void event_push(lua_State *L, int list, int *count, int id) {
+    lua_pushinteger(L, id);
+    lua_rawseti(L, list, ++(*count));
+}
+
+static bool get_field(const unsigned char *data, size_t length, size_t *at, const ReplField *field, uint32_t *bits) {
+    if (field->bytes) {
+        if (length - *at < (size_t)field->bytes) return false;
+        *bits = (uint32_t)packet_load_le(data + *at, field->bytes);
+        *at += (size_t)field->bytes;
+        return true;
+    }
+    uint64_t value;
+    if (!packet_load_varint(data, length, at, &value)) return false;
+    *bits = (uint32_t)value;
+    return true;
+}
+
+// world:apply(source, [offset], [events]) -> tick, or nil for a stale packet
+// Client side: source is a packet, packet view or string from tick(). The
+// script acks the returned tick to the server. events, when given, gets
+// reused arrays spawned, updated and destroyed of object ids (with n); until
+// the ack lands packets repeat records, those already applied raise none.
+static int l_world_apply(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    size_t length;
+    const unsigned char *data = (lua_type(L, 2) == LUA_TSTRING) ?
+        (const unsigned char*)lua_tolstring(L, 2, &length) : enet_check_packet_bytes(L, 2, &length);
+    lua_Integer offset = luaL_optinteger(L, 3, 1);
+    luaL_argcheck(L, offset >= 1 && (size_t)offset - 1 <= length, 3, "offset out of range");
+    size_t at = (size_t)offset - 1;
+    int events = lua_istable(L, 4) ? 4 : 0;
+
+    uint64_t tick, base;
+    if (!packet_load_varint(data, length, &at, &tick) || !packet_load_varint(data, length, &at, &base)) {
+        return luaL_error(L, "replication: malformed packet header");
+    }
+    if (tick <= world->tick) {
+        lua_pushnil(L);     // Older than what we have, unreliable packets reorder
+        return 1;
+    }
+    if (base > world->tick) return luaL_error(L, "replication: baseline %d was never applied", (int)base);
+
+    int spawned = 0, updated = 0, destroyed = 0;
+    int spawnedList = 0, updatedList = 0, destroyedList = 0;
+    if (events) {
+        spawnedList = event_list(L, events, "spawned");
+        updatedList = event_list(L, events, "updated");
+        destroyedList = event_list(L, events, "destroyed");
+    }
+    while (at < length) {
+        uint64_t header;
+        if (!packet_load_varint(data, length, &at, &header)) return luaL_error(L, "replication: malformed record");
+        uint64_t slot = header >> 2;
+        ReplRecord kind = (ReplRecord)(header & 3);
+        if (slot >= (uint64_t)world->maxObjects) return luaL_error(L, "replication: object %d out of range", (int)slot + 1);
+        ReplObject *object = &world->objects[slot];
+        if ((int)slot >= world->highWater) world->highWater = (int)slot + 1;
+
+        if (kind == REPL_RECORD_DESTROY) {
+            if (!object->alive) continue;
+            object->alive = false;
+            world->aliveCount--;
+            if (events) event_push(L, destroyedList, &destroyed, (int)slot + 1);
+            continue;
+        }
+        uint32_t mask;
+        if (kind == REPL_RECORD_CREATE) {
+            uint64_t classId, spawnAge, changedAge;
+            if (!packet_load_varint(data, length, &at, &classId) || classId < 1 || classId > (uint64_t)world->classCount) {
+                return luaL_error(L, "replication: unknown class in record");
+            }
+            if (!packet_load_varint(data, length, &at, &spawnAge) || !packet_load_varint(data, length, &at, &changedAge) ||
+                spawnAge >= tick || changedAge > spawnAge) {
+                return luaL_error(L, "replication: bad create record");
+            }
+            uint32_t spawnTick = (uint32_t)(tick - spawnAge);
+            uint32_t changedTick = spawnTick + (uint32_t)changedAge;
+            if (object->alive && object->spawnTick == spawnTick) {
+                // Repeated until acked, only news since our state count
+                if (events && changedTick > world->tick) event_push(L, updatedList, &updated, (int)slot + 1);
+            } else {
+                if (object->alive && events) event_push(L, destroyedList, &destroyed, (int)slot + 1);   // Slot reused
+                if (!object->alive) world->aliveCount++;
+                object->alive = true;
+                object->spawnTick = spawnTick;
+                if (events) event_push(L, spawnedList, &spawned, (int)slot + 1);
+            }
+            object->classId = (uint16_t)(classId - 1);
+            object->changedTick = changedTick;
+            object->seenTick = (uint32_t)tick;
+            int fieldCount = world->classes[object->classId].fieldCount;
+            mask = (fieldCount == 32) ? UINT32_MAX : (1u << fieldCount) - 1;
+        } else {
+            uint64_t changedAge, bits;
+            if (kind != REPL_RECORD_UPDATE || !object->alive || !packet_load_varint(data, length, &at, &changedAge) ||
+                changedAge >= tick || !packet_load_varint(data, length, &at, &bits)) {
+                return luaL_error(L, "replication: bad update record");
+            }
+            uint32_t changedTick = (uint32_t)(tick - changedAge);
+            if (events && changedTick > world->tick) event_push(L, updatedList, &updated, (int)slot + 1);
+            object->changedTick = changedTick;
+            mask = (uint32_t)bits;
+        }
+        const ReplClass *cls = &world->classes[object->classId];
+        if (cls->fieldCount < 32 && (mask >> cls->fieldCount)) return luaL_error(L, "replication: bad field mask");
+        uint32_t *values = world->values + (size_t)slot*REPL_MAX_FIELDS;
+        for (int f = 0; f < cls->fieldCount; ++f) {
+            if (!(mask & (1u << f))) continue;
+            if (!get_field(data, length, &at, &cls->fields[f], &values[f])) return luaL_error(L, "replication: record truncated");
+        }
+    }
+    // Objects spawned after the baseline come as creates while alive, the
+    // ones missing were destroyed on the server
+    for (int slot = 0; slot < world->highWater; ++slot) {
+        ReplObject *object = &world->objects[slot];
+        if (!object->alive || object->spawnTick <= base || object->seenTick == (uint32_t)tick) continue;
+        object->alive = false;
+        world->aliveCount--;
+        if (events) event_push(L, destroyedList, &destroyed, slot + 1);
+    }
+    world->tick = (uint32_t)tick;
+    if (events) {
+        lua_pushinteger(L, spawned);
+        lua_setfield(L, spawnedList, "n");
+        lua_pushinteger(L, updated);
+        lua_setfield(L, updatedList, "n");
+        lua_pushinteger(L, destroyed);
+        lua_setfield(L, destroyedList, "n");
+    }
+    lua_pushinteger(L, (lua_Integer)tick);
+    return 1;
+}
+
+// world:stats() -> {tick, objects, peers, packets, sentBytes, fullBytes, totalBytes}
+// sentBytes / fullBytes: last tick, deltas against what full snapshots to
+// every peer would have cost
+static int l_world_stats(lua_State *L) {
+    ReplWorld *world = check_world(L, 1);
+    int64_t total = 0;
+    for (int i = 0; i < world->peerCount; ++i) total += world->peers[i].bytes;
+    lua_createtable(L, 0, 7);
+    lua_pushinteger(L, world->tick);            lua_setfield(L, -2, "tick");
+    lua_pushinteger(L, world->aliveCount);      lua_setfield(L, -2, "objects");
+    lua_pushinteger(L, world->peerCount);       lua_setfield(L, -2, "peers");
+    lua_pushinteger(L, world->packets);         lua_setfield(L, -2, "packets");
+    lua_pushinteger(L, world->sentBytes);       lua_setfield(L, -2, "sentBytes");
+    lua_pushinteger(L, world->fullBytes);       lua_setfield(L, -2, "fullBytes");
+    lua_pushinteger(L, total);                  lua_setfield(L, -2, "totalBytes");
+    return 1;
+}
+
+static int repl_world_gc(lua_State *L) {
+    ReplWorld *world = (ReplWorld*)luaL_checkudata(L, 1, REPL_WORLD_MT);
+    if (!world->objects) return 0;
+    if (world->prev) world->prev->next = world->next;
+    else if (g_worlds == world) g_worlds = world->next;
+    if (world->next) world->next->prev = world->prev;
+    free(world->classes);
+    free(world->objects);
+    free(world->values);
+    free(world->fieldTicks);
+    free(world->freeSlots);
+    free(world->peers);
+    memset(world, 0, sizeof(*world));
+    return 0;
+}
+
+void replication_forget_peer(ENetPeer *peer) {
+    for (ReplWorld *world = g_worlds; world; world = world->next) {
+        int index = find_peer(world, peer);
+        if (index >= 0) remove_peer_at(world, index);
+    }
+}
+
+void replication_forget_host(ENetHost *host) {
+    for (ReplWorld *world = g_worlds; world; world = world->next) {
+        for (int i = world->peerCount - 1; i >= 0; --i) {
+            if (world->peers[i].peer->host == host) remove_peer_at(world, i);
+        }
+    }
+}
+
+static const luaL_Reg repl_world_methods[] = {
+    {"class", l_world_class},
+    {"spawn", l_world_spawn},
+    {"destroy", l_world_destroy},
+    {"set", l_world_set},
+    {"get", l_world_get},
+    {"get_object", l_world_get_object},
+    {"exists", l_world_exists},
+    {"add_peer", l_world_add_peer},
+    {"remove_peer", l_world_remove_peer},
+    {"ack", l_world_ack},
+    {"tick", l_world_tick},
+    {"apply", l_world_apply},
+    {"stats", l_world_stats},
+    {NULL, NULL}
+};
+
+static const luaL_Reg repl_world_mt[] = {
+    {"__gc", repl_world_gc},
+    {NULL, NULL}
+};
+
+static const luaL_Reg repl_funcs[] = {
+    {"world", l_repl_world},
+    {NULL, NULL}
+};
+
+void replication_init(void) {
+    // Fetch Lua state
+    g_lua_state = lua_get_state();
+    if (!g_lua_state) {
+        printf("Error: No Lua state available in replication_init\n");
+        return;
+    }
+
+    luaL_newmetatable(g_lua_state, REPL_WORLD_MT);
+    luaL_setfuncs(g_lua_state, repl_world_mt, 0);
+    luaL_newlib(g_lua_state, repl_world_methods);
+    lua_setfield(g_lua_state, -2, "__index");
+    lua_pop(g_lua_state, 1);
+
+    luaL_newlib(g_lua_state, repl_funcs);
+    lua_setglobal(g_lua_state, "repl");
+    lua_settop(g_lua_state, 0);
+
+    printf("Replication module initialized\n");
+}
+
+void replication_cleanup(void) {
+    g_lua_state = NULL;
+    printf("Replication module cleaned up\n");
+}
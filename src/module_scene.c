@@ -0,0 +1,443 @@
+// module_scene.c
+// Scene graph with dirty-flag transform propagation. Node data and world
+// matrices live in flat arrays indexed by handle; only dirty subtrees are
+// recomputed, so a static scene costs nothing per frame.
+#include "module_scene.h"
+#include "module_raylib.h"
+#include "module_camera.h"
+#include "module_lua.h"
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include "rlgl.h"
+#include "raymath.h"
+
+#define SCENE_NULL -1
+#define SCENE_INDEX_BITS 20                         // Handle = generation << 20 | (index + 1)
+#define SCENE_MAX_NODES ((1 << SCENE_INDEX_BITS) - 1)
+#define SCENE_GENERATION_MASK 0x7ff                 // 11 bits, handles stay positive
+
+typedef struct SceneNode {
+    Vector3 position;
+    Vector3 rotation;
+    Vector3 scale;
+    int parent;
+    int firstChild;
+    int nextSibling;
+    int prevSibling;
+    int next;           // Free list link
+    int bvhHandle;      // 0 = no bounds registered
+    int generation;     // Bumped on destroy, stale handles stop matching
+    CullAABB bounds;    // Local space bounds
+    bool used;
+    bool dirty;
+} SceneNode;
+
+static SceneNode *g_nodes = NULL;
+static Matrix *g_world = NULL;      // World matrices, same index as g_nodes
+static int g_capacity = 0;
+static int g_free = SCENE_NULL;
+static int g_node_count = 0;
+static int *g_dirty = NULL;         // Nodes marked dirty since last update
+static int g_dirty_count = 0;
+static int *g_stack = NULL;         // Subtree traversal stack
+static int g_last_updated = 0;
+
+static bool scene_grow(void) {
+    if (g_capacity >= SCENE_MAX_NODES) return false;
+    int newCapacity = (g_capacity == 0) ? 64 : g_capacity*2;
+    if (newCapacity > SCENE_MAX_NODES) newCapacity = SCENE_MAX_NODES;
+    SceneNode *nodes = (SceneNode*)realloc(g_nodes, (size_t)newCapacity*sizeof(SceneNode));
+    if (!nodes) return false;
+    g_nodes = nodes;
+    Matrix *world = (Matrix*)realloc(g_world, (size_t)newCapacity*sizeof(Matrix));
+    if (!world) return false;
+    g_world = world;
+    int *dirty = (int*)realloc(g_dirty, (size_t)newCapacity*sizeof(int));
+    if (!dirty) return false;
+    g_dirty = dirty;
+    int *stack = (int*)realloc(g_stack, (size_t)newCapacity*sizeof(int));
+    if (!stack) return false;
+    g_stack = stack;
+
+    for (int i = g_capacity; i < newCapacity; ++i) {
+        g_nodes[i].used = false;
+        g_nodes[i].generation = 0;
+        g_nodes[i].next = (i + 1 < newCapacity) ? i + 1 : g_free;
+    }
+    g_free = g_capacity;
+    g_capacity = newCapacity;
+    return true;
+}
+
+static int node_handle(int index) {
+    return (g_nodes[index].generation << SCENE_INDEX_BITS) | (index + 1);
+}
+
+// SCENE_NULL for stale handles, a destroyed node's slot may hold another node now
+static int handle_to_index(int handle) {
+    if (handle <= 0) return SCENE_NULL;
+    int index = (handle & SCENE_MAX_NODES) - 1;
+    if (index < 0 || index >= g_capacity || !g_nodes[index].used) return SCENE_NULL;
+    if (g_nodes[index].generation != (handle >> SCENE_INDEX_BITS)) return SCENE_NULL;
+    return index;
+}
+
+static void mark_dirty(int index) {
+    if (g_nodes[index].dirty) return;
+    g_nodes[index].dirty = true;
+    g_dirty[g_dirty_count++] = index;
+}
+
+static void unlink_from_parent(int index) {
+    SceneNode *node = &g_nodes[index];
+    if (node->prevSibling != SCENE_NULL) g_nodes[node->prevSibling].nextSibling = node->nextSibling;
+    else if (node->parent != SCENE_NULL) g_nodes[node->parent].firstChild = node->nextSibling;
+    if (node->nextSibling != SCENE_NULL) g_nodes[node->nextSibling].prevSibling = node->prevSibling;
+    node->parent = SCENE_NULL;
+    node->prevSibling = SCENE_NULL;
+    node->nextSibling = SCENE_NULL;
+}
+
+static void link_to_parent(int index, int parent) {
+    SceneNode *node = &g_nodes[index];
+    node->parent = parent;
+    if (parent == SCENE_NULL) return;
+    node->nextSibling = g_nodes[parent].firstChild;
+    if (node->nextSibling != SCENE_NULL) g_nodes[node->nextSibling].prevSibling = index;
+    g_nodes[parent].firstChild = index;
+}
+
+int scene_create_node(int parent) {
+    int parentIndex = SCENE_NULL;
+    if (parent != 0) {
+        parentIndex = handle_to_index(parent);
+        if (parentIndex == SCENE_NULL) return 0;
+    }
+    if (g_free == SCENE_NULL && !scene_grow()) return 0;
+
+    int index = g_free;
+    g_free = g_nodes[index].next;
+    SceneNode *node = &g_nodes[index];
+    int generation = node->generation;
+    memset(node, 0, sizeof(SceneNode));
+    node->generation = generation;
+    node->scale = (Vector3){ 1.0f, 1.0f, 1.0f };
+    node->parent = SCENE_NULL;
+    node->firstChild = SCENE_NULL;
+    node->nextSibling = SCENE_NULL;
+    node->prevSibling = SCENE_NULL;
+    node->next = SCENE_NULL;
+    node->used = true;
+    g_world[index] = MatrixIdentity();
+
+    link_to_parent(index, parentIndex);
+    mark_dirty(index);
+    g_node_count++;
+    return node_handle(index);
+}
+
+void scene_destroy_node(int handle) {
+    int index = handle_to_index(handle);
+    if (index == SCENE_NULL) return;
+    unlink_from_parent(index);
+
+    // Free the whole subtree
+    int top = 0;
+    g_stack[top++] = index;
+    while (top > 0) {
+        int current = g_stack[--top];
+        for (int child = g_nodes[current].firstChild; child != SCENE_NULL; child = g_nodes[child].nextSibling) {
+            g_stack[top++] = child;
+        }
+        if (g_nodes[current].bvhHandle) culling_remove(g_nodes[current].bvhHandle);
+        g_nodes[current].used = false;
+        g_nodes[current].generation = (g_nodes[current].generation + 1) & SCENE_GENERATION_MASK;
+        g_nodes[current].next = g_free;
+        g_free = current;
+        g_node_count--;
+    }
+
+    // Drop freed entries from the dirty list
+    int kept = 0;
+    for (int i = 0; i < g_dirty_count; ++i) {
+        if (g_nodes[g_dirty[i]].used) g_dirty[kept++] = g_dirty[i];
+        else g_nodes[g_dirty[i]].dirty = false;
+    }
+    g_dirty_count = kept;
+}
+
+bool scene_set_parent(int handle, int parent) {
+    int index = handle_to_index(handle);
+    if (index == SCENE_NULL) return false;
+    int parentIndex = SCENE_NULL;
+    if (parent != 0) {
+        parentIndex = handle_to_index(parent);
+        if (parentIndex == SCENE_NULL) return false;
+        // Refuse cycles: the new parent may not be inside this subtree
+        for (int p = parentIndex; p != SCENE_NULL; p = g_nodes[p].parent) {
+            if (p == index) return false;
+        }
+    }
+    unlink_from_parent(index);
+    link_to_parent(index, parentIndex);
+    mark_dirty(index);
+    return true;
+}
+
+void scene_set_position(int handle, Vector3 position) {
+    int index = handle_to_index(handle);
+    if (index == SCENE_NULL) return;
+    g_nodes[index].position = position;
+    mark_dirty(index);
+}
+
+void scene_set_rotation(int handle, Vector3 rotation) {
+    int index = handle_to_index(handle);
+    if (index == SCENE_NULL) return;
+    g_nodes[index].rotation = rotation;
+    mark_dirty(index);
+}
+
+void scene_set_scale(int handle, Vector3 scale) {
+    int index = handle_to_index(handle);
+    if (index == SCENE_NULL) return;
+    g_nodes[index].scale = scale;
+    mark_dirty(index);
+}
+
+// World space AABB of a transformed local box (Arvo's method)
+static CullAABB transform_bounds(CullAABB box, Matrix m) {
+    float center[3] = { m.m12, m.m13, m.m14 };
+    float minOut[3] = { center[0], center[1], center[2] };
+    float maxOut[3] = { center[0], center[1], center[2] };
+    float rows[3][3] = {
+        { m.m0, m.m4, m.m8 },
+        { m.m1, m.m5, m.m9 },
+        { m.m2, m.m6, m.m10 }
+    };
+    float bmin[3] = { box.min.x, box.min.y, box.min.z };
+    float bmax[3] = { box.max.x, box.max.y, box.max.z };
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            float a = rows[i][j]*bmin[j];
+            float b = rows[i][j]*bmax[j];
+            minOut[i] += fminf(a, b);
+            maxOut[i] += fmaxf(a, b);
+        }
+    }
+    return (CullAABB){ { minOut[0], minOut[1], minOut[2] }, { maxOut[0], maxOut[1], maxOut[2] } };
+}
+
+int scene_set_bounds(int handle, CullAABB localBounds, int userId) {
+    int index = handle_to_index(handle);
+    if (index == SCENE_NULL) return 0;
+    SceneNode *node = &g_nodes[index];
+    node->bounds = localBounds;
+    if (node->bvhHandle) culling_remove(node->bvhHandle);
+    node->bvhHandle = culling_insert(transform_bounds(localBounds, g_world[index]), (userId != 0) ? userId : handle);
+    mark_dirty(index);
+    return node->bvhHandle;
+}
+
+void scene_forget_bounds(void) {
+    for (int i = 0; i < g_capacity; ++i) g_nodes[i].bvhHandle = 0;
+}
+
+static void update_node(int index) {
+    SceneNode *node = &g_nodes[index];
+    Matrix local = MatrixMultiply(MatrixMultiply(
+        MatrixScale(node->scale.x, node->scale.y, node->scale.z),
+        MatrixRotateXYZ(node->rotation)),
+        MatrixTranslate(node->position.x, node->position.y, node->position.z));
+    g_world[index] = (node->parent != SCENE_NULL) ? MatrixMultiply(local, g_world[node->parent]) : local;
+    node->dirty = false;
+    if (node->bvhHandle) culling_move(node->bvhHandle, transform_bounds(node->bounds, g_world[index]));
+}
+
+int scene_update(void) {
+    int updated = 0;
+    for (int i = 0; i < g_dirty_count; ++i) {
+        int index = g_dirty[i];
+        if (!g_nodes[index].dirty) continue;   // Already handled as part of a parent subtree
+
+        // Start from the top-most dirty ancestor so every matrix is computed once
+        int root = index;
+        for (int p = g_nodes[index].parent; p != SCENE_NULL; p = g_nodes[p].parent) {
+            if (g_nodes[p].dirty) root = p;
+        }
+
+        int top = 0;
+        g_stack[top++] = root;
+        while (top > 0) {
+            int current = g_stack[--top];
+            update_node(current);
+            updated++;
+            for (int child = g_nodes[current].firstChild; child != SCENE_NULL; child = g_nodes[child].nextSibling) {
+                g_stack[top++] = child;
+            }
+        }
+    }
+    g_dirty_count = 0;
+    g_last_updated = updated;
+    return updated;
+}
+
+const Matrix *scene_get_world(int handle) {
+    int index = handle_to_index(handle);
+    if (index == SCENE_NULL) return NULL;
+    return &g_world[index];
+}
+
+//----------------------------------------------------------------------------------
+// Lua bindings
+//----------------------------------------------------------------------------------
+static int check_node(lua_State *L, int index) {
+    int handle = (int)luaL_checkinteger(L, index);
+    luaL_argcheck(L, handle_to_index(handle) != SCENE_NULL, index, "invalid scene node");
+    return handle;
+}
+
+static Vector3 check_xyz(lua_State *L, int index) {
+    return (Vector3){ (float)luaL_checknumber(L, index), (float)luaL_checknumber(L, index + 1),
+                      (float)luaL_checknumber(L, index + 2) };
+}
+
+// rl.SceneCreateNode([parent]) -> handle
+static int lua_raylib_scene_create_node(lua_State *L) {
+    int handle = scene_create_node((int)luaL_optinteger(L, 1, 0));
+    if (handle == 0) lua_pushnil(L);
+    else lua_pushinteger(L, handle);
+    return 1;
+}
+
+// rl.SceneDestroyNode(node) - destroys the whole subtree
+static int lua_raylib_scene_destroy_node(lua_State *L) {
+    scene_destroy_node((int)luaL_checkinteger(L, 1));
+    return 0;
+}
+
+// rl.SceneSetParent(node, parent) - parent 0 detaches
+static int lua_raylib_scene_set_parent(lua_State *L) {
+    int handle = check_node(L, 1);
+    lua_pushboolean(L, scene_set_parent(handle, (int)luaL_optinteger(L, 2, 0)));
+    return 1;
+}
+
+// rl.SceneSetPosition(node, x, y, z)
+static int lua_raylib_scene_set_position(lua_State *L) {
+    scene_set_position(check_node(L, 1), check_xyz(L, 2));
+    return 0;
+}
+
+// rl.SceneSetRotation(node, x, y, z) - radians
+static int lua_raylib_scene_set_rotation(lua_State *L) {
+    scene_set_rotation(check_node(L, 1), check_xyz(L, 2));
+    return 0;
+}
+
+// rl.SceneSetScale(node, x, y, z)
+static int lua_raylib_scene_set_scale(lua_State *L) {
+    scene_set_scale(check_node(L, 1), check_xyz(L, 2));
+    return 0;
+}
+
+// rl.SceneSetBounds(node, minx, miny, minz, maxx, maxy, maxz, [id]) -> bvh handle
+static int lua_raylib_scene_set_bounds(lua_State *L) {
+    int handle = check_node(L, 1);
+    CullAABB box = { check_xyz(L, 2), check_xyz(L, 5) };
+    lua_pushinteger(L, scene_set_bounds(handle, box, (int)luaL_optinteger(L, 8, 0)));
+    return 1;
+}
+
+// rl.SceneUpdate() -> nodes recomputed
+static int lua_raylib_scene_update(lua_State *L) {
+    lua_pushinteger(L, scene_update());
+    return 1;
+}
+
+// rl.SceneGetWorldMatrix(node) -> matrix table
+static int lua_raylib_scene_get_world_matrix(lua_State *L) {
+    push_matrix(L, *scene_get_world(check_node(L, 1)));
+    return 1;
+}
+
+// rl.SceneApply(node, camera | view) - rlSetMatrixModelview(world * view)
+static int lua_raylib_scene_apply(lua_State *L) {
+    int handle = check_node(L, 1);
+    CachedCamera *camera = camera_test_lua(L, 2);
+    Matrix view;
+    if (camera) {
+        camera_update(camera);
+        view = camera->view;
+    } else {
+        view = lua_istable(L, 2) ? get_matrix(L, 2) : MatrixIdentity();
+    }
+    rlSetMatrixModelview(MatrixMultiply(*scene_get_world(handle), view));
+    return 0;
+}
+
+// rl.GetSceneStats() -> { nodes, updated, dirty }
+static int lua_raylib_get_scene_stats(lua_State *L) {
+    lua_createtable(L, 0, 3);
+    lua_pushinteger(L, g_node_count);   lua_setfield(L, -2, "nodes");
+    lua_pushinteger(L, g_last_updated); lua_setfield(L, -2, "updated");
+    lua_pushinteger(L, g_dirty_count);  lua_setfield(L, -2, "dirty");
+    return 1;
+}
+
+static const struct luaL_Reg scene_funcs[] = {
+    {"SceneCreateNode", lua_raylib_scene_create_node},
+    {"SceneDestroyNode", lua_raylib_scene_destroy_node},
+    {"SceneSetParent", lua_raylib_scene_set_parent},
+    {"SceneSetPosition", lua_raylib_scene_set_position},
+    {"SceneSetRotation", lua_raylib_scene_set_rotation},
+    {"SceneSetScale", lua_raylib_scene_set_scale},
+    {"SceneSetBounds", lua_raylib_scene_set_bounds},
+    {"SceneUpdate", lua_raylib_scene_update},
+    {"SceneGetWorldMatrix", lua_raylib_scene_get_world_matrix},
+    {"SceneApply", lua_raylib_scene_apply},
+    {"GetSceneStats", lua_raylib_get_scene_stats},
+    {NULL, NULL}
+};
+
+// Add scene functions to the global 'rl' table (call after raylib_init)
+void scene_init(void) {
+    lua_State *L = lua_get_state();
+    if (!L) {
+        printf("Error: No Lua state available in scene_init\n");
+        return;
+    }
+
+    lua_getglobal(L, "rl");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setglobal(L, "rl");
+    }
+    luaL_setfuncs(L, scene_funcs, 0);
+    lua_settop(L, 0);
+
+    printf("scene module initialized\n");
+}
+
+void scene_cleanup(void) {
+    free(g_nodes);
+    free(g_world);
+    free(g_dirty);
+    free(g_stack);
+    g_nodes = NULL;
+    g_world = NULL;
+    g_dirty = NULL;
+    g_stack = NULL;
+    g_capacity = 0;
+    g_free = SCENE_NULL;
+    g_node_count = 0;
+    g_dirty_count = 0;
+    printf("scene module cleaned up\n");
+}
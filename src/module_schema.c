@@ -0,0 +1,355 @@
+// module_schema.c
+#include "module_schema.h"
+#include "module_lua.h"
+#include "module_enet.h"
+#include "packet_codec.h"
+#include "packet_pool.h"
+#include <lauxlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SCHEMA_MT "Schema"
+
+typedef enum FieldType {
+    FIELD_U8,
+    FIELD_I8,
+    FIELD_U16,
+    FIELD_I16,
+    FIELD_U32,
+    FIELD_I32,
+    FIELD_F32,
+    FIELD_F64,
+    FIELD_BOOL,
+    FIELD_VARINT,       // Unsigned LEB128
+    FIELD_SVARINT,      // Zigzag LEB128
+    FIELD_LSTRING,      // Varint length + bytes
+    FIELD_TYPE_COUNT
+} FieldType;
+
+typedef struct FieldInfo {
+    const char *name;
+    int size;           // Fixed wire size, 0 = variable
+    int64_t min;        // Integer range checked by pack
+    int64_t max;
+} FieldInfo;
+
+static const FieldInfo g_field_info[FIELD_TYPE_COUNT] = {
+    [FIELD_U8]      = { "u8", 1, 0, UINT8_MAX },
+    [FIELD_I8]      = { "i8", 1, INT8_MIN, INT8_MAX },
+    [FIELD_U16]     = { "u16", 2, 0, UINT16_MAX },
+    [FIELD_I16]     = { "i16", 2, INT16_MIN, INT16_MAX },
+    [FIELD_U32]     = { "u32", 4, 0, UINT32_MAX },
+    [FIELD_I32]     = { "i32", 4, INT32_MIN, INT32_MAX },
+    [FIELD_F32]     = { "f32", 4, 0, 0 },
+    [FIELD_F64]     = { "f64", 8, 0, 0 },
+    [FIELD_BOOL]    = { "bool", 1, 0, 0 },
+    [FIELD_VARINT]  = { "varint", 0, 0, INT64_MAX },
+    [FIELD_SVARINT] = { "svarint", 0, INT64_MIN, INT64_MAX },
+    [FIELD_LSTRING] = { "lstring", 0, 0, 0 },
+};
+
+typedef struct SchemaField {
+    FieldType type;
+    char name[SCHEMA_NAME_MAX];
+} SchemaField;
+
+// Compiled layout, the userdata itself
+typedef struct Schema {
+    int count;
+    size_t fixedSize;       // Sum of fixed size fields
+    bool variable;          // Has varint or string fields
+    SchemaField fields[];
+} Schema;
+
+// Encode buffer from the packet pool, becomes the packet payload
+typedef struct PackBuffer {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} PackBuffer;
+
+// Local Lua state
+static lua_State* g_lua_state = NULL;
+
+static bool buffer_reserve(PackBuffer *buffer, size_t size) {
+    if (buffer->size + size <= buffer->capacity) return true;
+    size_t want = buffer->capacity ? buffer->capacity*2 : PACKET_POOL_MIN_BLOCK;
+    while (want < buffer->size + size) want *= 2;
+    unsigned char *data = (unsigned char*)packet_pool_grow(buffer->data, buffer->size, want, &buffer->capacity);
+    if (!data) return false;
+    buffer->data = data;
+    return true;
+}
+
+// Encodes table t into buffer; on failure writes the reason to error and
+// leaves the buffer for the caller to free (no Lua error with it held)
+static bool encode(lua_State *L, const Schema *schema, int t, PackBuffer *buffer, char *error, size_t errorSize) {
+    for (int i = 0; i < schema->count; ++i) {
+        const SchemaField *field = &schema->fields[i];
+        const FieldInfo *info = &g_field_info[field->type];
+        int type = lua_getfield(L, t, field->name);
+        unsigned char *at;
+        size_t length = 0;
+        const char *s = NULL;
+        uint64_t bits = 0;
+
+        switch (field->type) {
+        case FIELD_F32:
+        case FIELD_F64: {
+            int isnum;
+            lua_Number number = lua_tonumberx(L, -1, &isnum);
+            if (!isnum) goto bad_type;
+            if (field->type == FIELD_F32) {
+                float value = (float)number;
+                uint32_t word;
+                memcpy(&word, &value, sizeof(word));
+                bits = word;
+            } else {
+                memcpy(&bits, &number, sizeof(bits));
+            }
+            break;
+        }
+        case FIELD_BOOL:
+            bits = lua_toboolean(L, -1) ? 1 : 0;
+            break;
+        case FIELD_LSTRING:
+            if (type != LUA_TSTRING) goto bad_type;
+            s = lua_tolstring(L, -1, &length);
+            break;
+        default: {
+            int isnum;
+            lua_Integer value = lua_tointegerx(L, -1, &isnum);
+            if (!isnum) goto bad_type;
+            if (value < info->min || value > info->max) {
+                snprintf(error, errorSize, "field '%s' out of range for %s", field->name, info->name);
+                lua_pop(L, 1);
+                return false;
+            }
+            bits = (field->type == FIELD_SVARINT) ? packet_zigzag(value) : (uint64_t)value;
+            break;
+        }
+        }
+
+        if (!buffer_reserve(buffer, info->size ? (size_t)info->size : PACKET_VARINT_MAX + length)) {
+            snprintf(error, errorSize, "out of memory");
+            lua_pop(L, 1);
+            return false;
+        }
+        at = buffer->data + buffer->size;
+        if (info->size) {
+            packet_store_le(at, bits, info->size);
+            buffer->size += (size_t)info->size;
+        } else if (field->type == FIELD_LSTRING) {
+            buffer->size += (size_t)packet_store_varint(at, length);
+            memcpy(buffer->data + buffer->size, s, length);    // Copy before the pop, s is the table's string
+            buffer->size += length;
+        } else {
+            buffer->size += (size_t)packet_store_varint(at, bits);
+        }
+        lua_pop(L, 1);
+        continue;
+
+    bad_type:
+        snprintf(error, errorSize, "field '%s' expects %s, got %s", field->name, info->name, luaL_typename(L, -1));
+        lua_pop(L, 1);
+        return false;
+    }
+    return true;
+}
+
+static PackBuffer pack_table(lua_State *L) {
+    Schema *schema = (Schema*)luaL_checkudata(L, 1, SCHEMA_MT);
+    luaL_checktype(L, 2, LUA_TTABLE);
+    PackBuffer buffer = { 0 };
+    char error[128];
+    size_t reserve = schema->fixedSize + (schema->variable ? SCHEMA_PACK_RESERVE : 0);
+    buffer.data = (unsigned char*)packet_pool_alloc(reserve, &buffer.capacity);
+    if (!buffer.data) luaL_error(L, "schema pack: out of memory");
+    if (!encode(L, schema, 2, &buffer, error, sizeof(error))) {
+        packet_pool_free(buffer.data);
+        luaL_error(L, "schema pack: %s", error);
+    }
+    return buffer;
+}
+
+// schema:pack(t, [flags]) -> packet, ready for enet.peer_send
+static int l_schema_pack(lua_State *L) {
+    lua_Integer flags = luaL_optinteger(L, 3, 0);
+    PackBuffer buffer = pack_table(L);
+    ENetPacket *packet = packet_pool_packet(buffer.data, buffer.size, (uint32_t)flags);
+    if (!packet) {
+        packet_pool_free(buffer.data);
+        lua_pushnil(L);
+        return 1;
+    }
+    enet_push_packet(L, packet);
+    return 1;
+}
+
+// schema:pack_string(t) -> string
+static int l_schema_pack_string(lua_State *L) {
+    PackBuffer buffer = pack_table(L);
+    lua_pushlstring(L, (const char*)buffer.data, buffer.size);
+    packet_pool_free(buffer.data);
+    return 1;
+}
+
+// schema:unpack(source, [offset], [out]) -> t, next
+// source is a packet, packet view or string; offset is 1-based. Fields are
+// set on out when given (reused record), else on a new table.
+static int l_schema_unpack(lua_State *L) {
+    Schema *schema = (Schema*)luaL_checkudata(L, 1, SCHEMA_MT);
+    size_t length;
+    const unsigned char *data = (lua_type(L, 2) == LUA_TSTRING) ?
+        (const unsigned char*)lua_tolstring(L, 2, &length) : enet_check_packet_bytes(L, 2, &length);
+    lua_Integer offset = luaL_optinteger(L, 3, 1);
+    luaL_argcheck(L, offset >= 1 && (size_t)offset - 1 <= length, 3, "offset out of range");
+    size_t at = (size_t)offset - 1;
+    if (lua_istable(L, 4)) {
+        lua_settop(L, 4);
+    } else {
+        lua_settop(L, 3);
+        lua_createtable(L, 0, schema->count);
+    }
+    if (length - at < schema->fixedSize) return luaL_error(L, "schema unpack: message truncated");
+
+    for (int i = 0; i < schema->count; ++i) {
+        const SchemaField *field = &schema->fields[i];
+        int size = g_field_info[field->type].size;
+        if (size && length - at < (size_t)size) return luaL_error(L, "schema unpack: message truncated");
+        uint64_t bits = size ? packet_load_le(data + at, size) : 0;
+        at += (size_t)size;
+
+        switch (field->type) {
+        case FIELD_U8:
+        case FIELD_U16:
+        case FIELD_U32:     lua_pushinteger(L, (lua_Integer)bits); break;
+        case FIELD_I8:      lua_pushinteger(L, (int8_t)(uint8_t)bits); break;
+        case FIELD_I16:     lua_pushinteger(L, (int16_t)(uint16_t)bits); break;
+        case FIELD_I32:     lua_pushinteger(L, (int32_t)(uint32_t)bits); break;
+        case FIELD_BOOL:    lua_pushboolean(L, bits != 0); break;
+        case FIELD_F32: {
+            uint32_t word = (uint32_t)bits;
+            float value;
+            memcpy(&value, &word, sizeof(value));
+            lua_pushnumber(L, value);
+            break;
+        }
+        case FIELD_F64: {
+            double value;
+            memcpy(&value, &bits, sizeof(value));
+            lua_pushnumber(L, value);
+            break;
+        }
+        case FIELD_VARINT:
+        case FIELD_SVARINT:
+            if (!packet_load_varint(data, length, &at, &bits)) return luaL_error(L, "schema unpack: bad varint in '%s'", field->name);
+            if (field->type == FIELD_SVARINT) lua_pushinteger(L, (lua_Integer)packet_unzigzag(bits));
+            else lua_pushinteger(L, (lua_Integer)bits);
+            break;
+        case FIELD_LSTRING:
+            if (!packet_load_varint(data, length, &at, &bits) || bits > length - at) {
+                return luaL_error(L, "schema unpack: bad string length in '%s'", field->name);
+            }
+            lua_pushlstring(L, (const char*)data + at, (size_t)bits);
+            at += (size_t)bits;
+            break;
+        default:
+            lua_pushnil(L);
+            break;
+        }
+        lua_setfield(L, -2, field->name);
+    }
+    lua_pushinteger(L, (lua_Integer)(at + 1));
+    return 2;
+}
+
+// schema:size() -> fixed size in bytes, variable (true with varint/string fields)
+static int l_schema_size(lua_State *L) {
+    Schema *schema = (Schema*)luaL_checkudata(L, 1, SCHEMA_MT);
+    lua_pushinteger(L, (lua_Integer)schema->fixedSize);
+    lua_pushboolean(L, schema->variable);
+    return 2;
+}
+
+static FieldType check_field_type(lua_State *L, const char *name, int index) {
+    for (int i = 0; i < FIELD_TYPE_COUNT; ++i) {
+        if (strcmp(name, g_field_info[i].name) == 0) return (FieldType)i;
+    }
+    luaL_error(L, "schema.compile: field %d has unknown type '%s'", index, name);
+    return FIELD_U8;
+}
+
+// schema.compile({ {"id", "u16"}, {"x", "f32"}, {"name", "lstring"} }) -> schema
+// Types: u8 i8 u16 i16 u32 i32 f32 f64 bool varint svarint lstring
+static int l_schema_compile(lua_State *L) {
+    luaL_checktype(L, 1, LUA_TTABLE);
+    int count = (int)lua_rawlen(L, 1);
+    luaL_argcheck(L, count > 0 && count <= SCHEMA_MAX_FIELDS, 1, "1 to 64 fields expected");
+
+    Schema *schema = (Schema*)lua_newuserdatauv(L, sizeof(Schema) + (size_t)count*sizeof(SchemaField), 0);
+    memset(schema, 0, sizeof(Schema));
+    luaL_setmetatable(L, SCHEMA_MT);
+    for (int i = 1; i <= count; ++i) {
+        if (lua_rawgeti(L, 1, i) != LUA_TTABLE) return luaL_error(L, "schema.compile: field %d is not a { name, type } pair", i);
+        lua_rawgeti(L, -1, 1);
+        lua_rawgeti(L, -2, 2);
+        size_t nameLength;
+        const char *name = lua_tolstring(L, -2, &nameLength);
+        const char *type = lua_tostring(L, -1);
+        if (!name || !type) return luaL_error(L, "schema.compile: field %d is not a { name, type } pair", i);
+        if (nameLength == 0 || nameLength >= SCHEMA_NAME_MAX) {
+            return luaL_error(L, "schema.compile: field name '%s' must be 1 to %d characters", name, SCHEMA_NAME_MAX - 1);
+        }
+        SchemaField *field = &schema->fields[i - 1];
+        field->type = check_field_type(L, type, i);
+        memcpy(field->name, name, nameLength + 1);
+        int size = g_field_info[field->type].size;
+        schema->fixedSize += (size_t)size;
+        if (!size) schema->variable = true;
+        lua_pop(L, 3);
+    }
+    schema->count = count;
+    return 1;
+}
+
+static const luaL_Reg schema_methods[] = {
+    {"pack", l_schema_pack},
+    {"pack_string", l_schema_pack_string},
+    {"unpack", l_schema_unpack},
+    {"size", l_schema_size},
+    {NULL, NULL}
+};
+
+static const luaL_Reg schema_funcs[] = {
+    {"compile", l_schema_compile},
+    {NULL, NULL}
+};
+
+void schema_init(void) {
+    // Fetch Lua state
+    g_lua_state = lua_get_state();
+    if (!g_lua_state) {
+        printf("Error: No Lua state available in schema_init\n");
+        return;
+    }
+
+    luaL_newmetatable(g_lua_state, SCHEMA_MT);
+    luaL_newlib(g_lua_state, schema_methods);
+    lua_setfield(g_lua_state, -2, "__index");
+    lua_pop(g_lua_state, 1);
+
+    luaL_newlib(g_lua_state, schema_funcs);
+    lua_setglobal(g_lua_state, "schema");
+    lua_settop(g_lua_state, 0);
+
+    printf("Schema module initialized\n");
+}
+
+void schema_cleanup(void) {
+    g_lua_state = NULL;
+    printf("Schema module cleaned up\n");
+}
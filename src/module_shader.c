@@ -0,0 +1,572 @@
+// module_shader.c
+// Shader program cache: programs are deduplicated by source hash and linked
+// programs are persisted with glGetProgramBinary. A cached binary is tried
+// first; when the driver rejects it (driver update, different GPU) the
+// program is compiled from source again and the file is rewritten.
+//
+// Binaries are keyed by source hash + driver string so switching between
+// a GPU and Mesa llvmpipe never feeds one driver the other's blob.
+#include "module_shader.h"
+#include "module_raylib.h"
+#include "module_batch.h"
+#include "module_lua.h"
+#include "gl_ext.h"
+#include "hash.h"
+#include <lua.h>
+#include <lauxlib.h>
+#include <lualib.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "rlgl.h"
+#include "raymath.h"
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>         // glfwGetTime()
+
+#if defined(_WIN32)
+    #include <direct.h>
+    #define shader_mkdir(path) _mkdir(path)
+#else
+    #include <sys/stat.h>
+    #define shader_mkdir(path) mkdir(path, 0755)
+#endif
+
+#define SHADER_MT "rl.Shader"
+#define MATERIAL_MT "rl.Material"
+#define MATERIAL_MAX_UNIFORMS 16
+#define MATERIAL_UNIFORM_MATRIX -1
+
+#define PROGRAM_BINARY_MAGIC 0x42504c52u   // "RLPB"
+#define PROGRAM_BINARY_VERSION 1
+
+typedef struct ProgramBinaryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint32_t format;
+    uint32_t length;
+} ProgramBinaryHeader;
+
+typedef struct ShaderEntry {
+    uint64_t hash;      // Source hash
+    unsigned int id;    // 0 = free slot
+    int refs;
+    bool fromBinary;
+    int locs[RL_MAX_SHADER_LOCATIONS];
+} ShaderEntry;
+
+static ShaderEntry *g_entries = NULL;
+static int g_entry_count = 0;
+static int g_entry_capacity = 0;
+static char g_directory[512] = { 0 };
+static bool g_binary_enabled = false;
+static ShaderCacheStats g_stats = { 0 };
+
+//----------------------------------------------------------------------------------
+// Cache
+//----------------------------------------------------------------------------------
+void shader_cache_setup(const char *directory) {
+    g_binary_enabled = false;
+    g_directory[0] = '\0';
+    if (!directory || directory[0] == '\0') {
+        printf("Shader cache: program binaries disabled\n");
+        return;
+    }
+    if (!gl_ext_has_program_binary()) {
+        printf("Shader cache: driver has no program binary formats, compiling from source\n");
+        return;
+    }
+    snprintf(g_directory, sizeof(g_directory), "%s", directory);
+    g_binary_enabled = true;
+    printf("Shader cache: %s (%s)\n", g_directory, gl_ext_driver_string());
+}
+
+static ShaderEntry *find_entry_by_hash(uint64_t hash) {
+    for (int i = 0; i < g_entry_count; ++i) {
+        if (g_entries[i].id != 0 && g_entries[i].hash == hash) return &g_entries[i];
+    }
+    return NULL;
+}
+
+static ShaderEntry *find_entry_by_id(unsigned int id) {
+    if (id == 0) return NULL;
+    for (int i = 0; i < g_entry_count; ++i) {
+        if (g_entries[i].id == id) return &g_entries[i];
+    }
+    return NULL;
+}
+
+static ShaderEntry *alloc_entry(void) {
+    for (int i = 0; i < g_entry_count; ++i) {
+        if (g_entries[i].id == 0) return &g_entries[i];
+    }
+    if (g_entry_count == g_entry_capacity) {
+        int newCapacity = (g_entry_capacity == 0) ? 16 : g_entry_capacity*2;
+        ShaderEntry *entries = (ShaderEntry*)realloc(g_entries, (size_t)newCapacity*sizeof(ShaderEntry));
+        if (!entries) return NULL;
+        g_entries = entries;
+        g_entry_capacity = newCapacity;
+    }
+    return &g_entries[g_entry_count++];
+}
+
+static void binary_path(uint64_t sourceHash, char *path, size_t size) {
+    const char *driver = gl_ext_driver_string();
+    uint64_t key = hash_fnv1a64(driver, strlen(driver), sourceHash);
+    snprintf(path, size, "%s/%016llx.bin", g_directory, (unsigned long long)key);
+}
+
+static bool link_ok(unsigned int program) {
+    int status = 0;
+    glext.GetProgramiv(program, GL_LINK_STATUS, &status);
+    return status != 0;
+}
+
+// Restore a linked program from disk, 0 when missing or rejected
+static unsigned int load_binary(uint64_t sourceHash) {
+    char path[600];
+    binary_path(sourceHash, path, sizeof(path));
+    FILE *file = fopen(path, "rb");
+    if (!file) return 0;
+
+    ProgramBinaryHeader header;
+    unsigned int program = 0;
+    void *data = NULL;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != PROGRAM_BINARY_MAGIC ||
+        header.version != PROGRAM_BINARY_VERSION || header.sourceHash != sourceHash || header.length == 0) {
+        goto rejected;
+    }
+    data = malloc(header.length);
+    if (!data || fread(data, 1, header.length, file) != header.length) goto rejected;
+
+    program = glext.CreateProgram();
+    glext.ProgramBinary(program, header.format, data, (int)header.length);
+    if (!link_ok(program)) goto rejected;
+
+    free(data);
+    fclose(file);
+    return program;
+
+rejected:
+    if (program) glext.DeleteProgram(program);
+    free(data);
+    fclose(file);
+    remove(path);
+    g_stats.binaryRejected++;
+    printf("Shader cache: rejected %s, recompiling\n", path);
+    return 0;
+}
+
+static void save_binary(unsigned int program, uint64_t sourceHash) {
+    int length = 0;
+    glext.GetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    void *data = malloc((size_t)length);
+    if (!data) return;
+    ProgramBinaryHeader header = { PROGRAM_BINARY_MAGIC, PROGRAM_BINARY_VERSION, sourceHash, 0, 0 };
+    int written = 0;
+    glext.GetProgramBinary(program, length, &written, &header.format, data);
+    header.length = (uint32_t)written;
+
+    char path[600];
+    binary_path(sourceHash, path, sizeof(path));
+    shader_mkdir(g_directory);
+    FILE *file = fopen(path, "wb");
+    if (file) {
+        if (written > 0 && fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(data, 1, (size_t)written, file) == (size_t)written) {
+            g_stats.binarySaved++;
+        }
+        fclose(file);
+    }
+    free(data);
+}
+
+// Compile and link with rlgl's default attribute locations so the program
+// also works with the rlgl render batch through rlSetShader()
+static unsigned int compile_program(const char *vsCode, const char *fsCode) {
+    unsigned int vs = rlCompileShader(vsCode, RL_VERTEX_SHADER);
+    unsigned int fs = rlCompileShader(fsCode, RL_FRAGMENT_SHADER);
+    if (vs == 0 || fs == 0) {
+        if (vs) glext.DeleteShader(vs);
+        if (fs) glext.DeleteShader(fs);
+        return 0;
+    }
+
+    unsigned int program = glext.CreateProgram();
+    glext.AttachShader(program, vs);
+    glext.AttachShader(program, fs);
+    glext.BindAttribLocation(program, RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, RL_DEFAULT_SHADER_ATTRIB_NAME_POSITION);
+    glext.BindAttribLocation(program, RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD);
+    glext.BindAttribLocation(program, RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL, RL_DEFAULT_SHADER_ATTRIB_NAME_NORMAL);
+    glext.BindAttribLocation(program, RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, RL_DEFAULT_SHADER_ATTRIB_NAME_COLOR);
+    glext.BindAttribLocation(program, RL_DEFAULT_SHADER_ATTRIB_LOCATION_TANGENT, RL_DEFAULT_SHADER_ATTRIB_NAME_TANGENT);
+    glext.BindAttribLocation(program, RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD2, RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD2);
+    if (g_binary_enabled) glext.ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, 1);
+    glext.LinkProgram(program);
+
+    glext.DetachShader(program, vs);
+    glext.DetachShader(program, fs);
+    glext.DeleteShader(vs);
+    glext.DeleteShader(fs);
+
+    if (!link_ok(program)) {
+        char log[1024] = { 0 };
+        glext.GetProgramInfoLog(program, (int)sizeof(log), NULL, log);
+        printf("Error: Failed to link shader program: %s\n", log);
+        glext.DeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// Same lookups raylib's LoadShaderFromMemory() does
+static void fill_locs(unsigned int id, int *locs) {
+    for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; ++i) locs[i] = -1;
+    locs[RL_SHADER_LOC_VERTEX_POSITION] = rlGetLocationAttrib(id, RL_DEFAULT_SHADER_ATTRIB_NAME_POSITION);
+    locs[RL_SHADER_LOC_VERTEX_TEXCOORD01] = rlGetLocationAttrib(id, RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD);
+    locs[RL_SHADER_LOC_VERTEX_TEXCOORD02] = rlGetLocationAttrib(id, RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD2);
+    locs[RL_SHADER_LOC_VERTEX_NORMAL] = rlGetLocationAttrib(id, RL_DEFAULT_SHADER_ATTRIB_NAME_NORMAL);
+    locs[RL_SHADER_LOC_VERTEX_TANGENT] = rlGetLocationAttrib(id, RL_DEFAULT_SHADER_ATTRIB_NAME_TANGENT);
+    locs[RL_SHADER_LOC_VERTEX_COLOR] = rlGetLocationAttrib(id, RL_DEFAULT_SHADER_ATTRIB_NAME_COLOR);
+    locs[RL_SHADER_LOC_MATRIX_MVP] = rlGetLocationUniform(id, RL_DEFAULT_SHADER_UNIFORM_NAME_MVP);
+    locs[RL_SHADER_LOC_MATRIX_VIEW] = rlGetLocationUniform(id, RL_DEFAULT_SHADER_UNIFORM_NAME_VIEW);
+    locs[RL_SHADER_LOC_MATRIX_PROJECTION] = rlGetLocationUniform(id, RL_DEFAULT_SHADER_UNIFORM_NAME_PROJECTION);
+    locs[RL_SHADER_LOC_MATRIX_MODEL] = rlGetLocationUniform(id, RL_DEFAULT_SHADER_UNIFORM_NAME_MODEL);
+    locs[RL_SHADER_LOC_MATRIX_NORMAL] = rlGetLocationUniform(id, RL_DEFAULT_SHADER_UNIFORM_NAME_NORMAL);
+    locs[RL_SHADER_LOC_COLOR_DIFFUSE] = rlGetLocationUniform(id, RL_DEFAULT_SHADER_UNIFORM_NAME_COLOR);
+    locs[RL_SHADER_LOC_MAP_DIFFUSE] = rlGetLocationUniform(id, RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE0);
+    locs[RL_SHADER_LOC_MAP_SPECULAR] = rlGetLocationUniform(id, RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE1);
+    locs[RL_SHADER_LOC_MAP_NORMAL] = rlGetLocationUniform(id, RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE2);
+}
+
+unsigned int shader_cache_load(const char *vsCode, const char *fsCode) {
+    if (!vsCode || !fsCode || !glext.CreateProgram) return 0;
+
+    uint64_t hash = hash_fnv1a64(vsCode, strlen(vsCode) + 1, HASH_FNV1A64_BASIS);
+    hash = hash_fnv1a64(fsCode, strlen(fsCode) + 1, hash);
+
+    ShaderEntry *entry = find_entry_by_hash(hash);
+    if (entry) {
+        entry->refs++;
+        g_stats.deduped++;
+        return entry->id;
+    }
+
+    double start = glfwGetTime();
+    bool fromBinary = false;
+    unsigned int id = 0;
+    if (g_binary_enabled) {
+        id = load_binary(hash);
+        fromBinary = (id != 0);
+    }
+    if (fromBinary) {
+        g_stats.binaryHits++;
+        g_stats.binaryMs += (glfwGetTime() - start)*1000.0;
+    } else {
+        id = compile_program(vsCode, fsCode);
+        if (id == 0) return 0;
+        g_stats.compiled++;
+        g_stats.compileMs += (glfwGetTime() - start)*1000.0;
+        if (g_binary_enabled) save_binary(id, hash);
+    }
+
+    entry = alloc_entry();
+    if (!entry) {
+        glext.DeleteProgram(id);
+        return 0;
+    }
+    entry->hash = hash;
+    entry->id = id;
+    entry->refs = 1;
+    entry->fromBinary = fromBinary;
+    fill_locs(id, entry->locs);
+    g_stats.programs++;
+    printf("Shader %016llx: %s in %.2f ms\n", (unsigned long long)hash,
+           fromBinary ? "restored from binary" : "compiled", (glfwGetTime() - start)*1000.0);
+    return id;
+}
+
+void shader_cache_release(unsigned int id) {
+    ShaderEntry *entry = find_entry_by_id(id);
+    if (!entry) return;
+    if (--entry->refs > 0) return;
+    rlUnloadShaderProgram(entry->id);
+    entry->id = 0;
+    g_stats.programs--;
+}
+
+int *shader_cache_get_locs(unsigned int id) {
+    ShaderEntry *entry = find_entry_by_id(id);
+    return entry ? entry->locs : NULL;
+}
+
+ShaderCacheStats shader_cache_get_stats(void) {
+    return g_stats;
+}
+
+//----------------------------------------------------------------------------------
+// Lua bindings
+//----------------------------------------------------------------------------------
+typedef struct ShaderHandle {
+    unsigned int id;
+} ShaderHandle;
+
+typedef struct MaterialUniform {
+    char name[32];
+    int loc;
+    int type;           // RL_SHADER_UNIFORM_FLOAT..VEC4 or MATERIAL_UNIFORM_MATRIX
+    float value[16];
+} MaterialUniform;
+
+// Shader + uniform values applied together, the shader userdata is kept
+// alive as the material's user value
+typedef struct MaterialHandle {
+    unsigned int shaderId;
+    int uniformCount;
+    MaterialUniform uniforms[MATERIAL_MAX_UNIFORMS];
+} MaterialHandle;
+
+static ShaderHandle *check_shader(lua_State *L, int index) {
+    ShaderHandle *handle = (ShaderHandle*)luaL_checkudata(L, index, SHADER_MT);
+    if (handle->id == 0) luaL_error(L, "shader was unloaded");
+    return handle;
+}
+
+static void begin_program(unsigned int id) {
+    batch_flush();
+    rlSetShader(id, shader_cache_get_locs(id));
+    rlEnableShader(id);     // Uniform uploads target the bound program
+}
+
+static void end_program(void) {
+    batch_flush();
+    rlSetShader(rlGetShaderIdDefault(), rlGetShaderLocsDefault());
+}
+
+// rl.LoadShaderCode(vsCode, fsCode) -> shader (nil on failure)
+static int lua_raylib_load_shader_code(lua_State *L) {
+    const char *vs = luaL_checkstring(L, 1);
+    const char *fs = luaL_checkstring(L, 2);
+    unsigned int id = shader_cache_load(vs, fs);
+    if (id == 0) {
+        lua_pushnil(L);
+        return 1;
+    }
+    ShaderHandle *handle = (ShaderHandle*)lua_newuserdatauv(L, sizeof(ShaderHandle), 0);
+    handle->id = id;
+    luaL_getmetatable(L, SHADER_MT);
+    lua_setmetatable(L, -2);
+    return 1;
+}
+
+// shader:Unload() - also done by the garbage collector
+static int shader_method_unload(lua_State *L) {
+    ShaderHandle *handle = (ShaderHandle*)luaL_checkudata(L, 1, SHADER_MT);
+    if (handle->id) {
+        shader_cache_release(handle->id);
+        handle->id = 0;
+    }
+    return 0;
+}
+
+static int shader_method_get_id(lua_State *L) {
+    lua_pushinteger(L, check_shader(L, 1)->id);
+    return 1;
+}
+
+// shader:GetLocation(uniformName) -> location or -1
+static int shader_method_get_location(lua_State *L) {
+    lua_pushinteger(L, rlGetLocationUniform(check_shader(L, 1)->id, luaL_checkstring(L, 2)));
+    return 1;
+}
+
+// shader:IsFromBinary() -> true when restored from the binary cache
+static int shader_method_is_from_binary(lua_State *L) {
+    ShaderEntry *entry = find_entry_by_id(check_shader(L, 1)->id);
+    lua_pushboolean(L, entry && entry->fromBinary);
+    return 1;
+}
+
+// shader:Begin() - rlgl batch draws with this shader until shader:End()
+static int shader_method_begin(lua_State *L) {
+    begin_program(check_shader(L, 1)->id);
+    return 0;
+}
+
+static int shader_method_end(lua_State *L) {
+    end_program();
+    return 0;
+}
+
+// rl.Material(shader) -> material
+static int lua_raylib_material(lua_State *L) {
+    ShaderHandle *shader = check_shader(L, 1);
+    MaterialHandle *material = (MaterialHandle*)lua_newuserdatauv(L, sizeof(MaterialHandle), 1);
+    memset(material, 0, sizeof(MaterialHandle));
+    material->shaderId = shader->id;
+    lua_pushvalue(L, 1);
+    lua_setiuservalue(L, -2, 1);
+    luaL_getmetatable(L, MATERIAL_MT);
+    lua_setmetatable(L, -2);
+    return 1;
+}
+
+static MaterialUniform *material_uniform(lua_State *L, MaterialHandle *material, const char *name) {
+    for (int i = 0; i < material->uniformCount; ++i) {
+        if (strcmp(material->uniforms[i].name, name) == 0) return &material->uniforms[i];
+    }
+    if (material->uniformCount == MATERIAL_MAX_UNIFORMS) {
+        luaL_error(L, "material has too many uniforms (max %d)", MATERIAL_MAX_UNIFORMS);
+        return NULL;
+    }
+    if (strlen(name) >= sizeof(material->uniforms[0].name)) {
+        luaL_error(L, "uniform name too long: %s", name);
+        return NULL;
+    }
+    MaterialUniform *uniform = &material->uniforms[material->uniformCount++];
+    memset(uniform, 0, sizeof(MaterialUniform));
+    strcpy(uniform->name, name);
+    uniform->loc = rlGetLocationUniform(material->shaderId, name);
+    return uniform;
+}
+
+// material:SetFloat(name, x, [y, z, w]) - stored, uploaded by material:Begin()
+static int material_method_set_float(lua_State *L) {
+    MaterialHandle *material = (MaterialHandle*)luaL_checkudata(L, 1, MATERIAL_MT);
+    MaterialUniform *uniform = material_uniform(L, material, luaL_checkstring(L, 2));
+    int count = lua_gettop(L) - 2;
+    if (count < 1 || count > 4) return luaL_error(L, "SetFloat expects 1 to 4 values");
+    for (int i = 0; i < count; ++i) {
+        uniform->value[i] = (float)luaL_checknumber(L, 3 + i);
+    }
+    uniform->type = RL_SHADER_UNIFORM_FLOAT + (count - 1);
+    return 0;
+}
+
+// material:SetMatrix(name, matrix)
+static int material_method_set_matrix(lua_State *L) {
+    MaterialHandle *material = (MaterialHandle*)luaL_checkudata(L, 1, MATERIAL_MT);
+    MaterialUniform *uniform = material_uniform(L, material, luaL_checkstring(L, 2));
+    luaL_checktype(L, 3, LUA_TTABLE);
+    Matrix m = get_matrix(L, 3);
+    memcpy(uniform->value, &m, sizeof(Matrix));
+    uniform->type = MATERIAL_UNIFORM_MATRIX;
+    return 0;
+}
+
+// material:Begin() - bind the shader and upload the stored uniforms
+static int material_method_begin(lua_State *L) {
+    MaterialHandle *material = (MaterialHandle*)luaL_checkudata(L, 1, MATERIAL_MT);
+    if (!find_entry_by_id(material->shaderId)) return luaL_error(L, "material shader was unloaded");
+    begin_program(material->shaderId);
+    for (int i = 0; i < material->uniformCount; ++i) {
+        MaterialUniform *uniform = &material->uniforms[i];
+        if (uniform->loc < 0) continue;
+        if (uniform->type == MATERIAL_UNIFORM_MATRIX) {
+            Matrix m;
+            memcpy(&m, uniform->value, sizeof(Matrix));
+            rlSetUniformMatrix(uniform->loc, m);
+        } else {
+            rlSetUniform(uniform->loc, uniform->value, uniform->type, 1);
+        }
+    }
+    return 0;
+}
+
+// material:GetShader() -> shader
+static int material_method_get_shader(lua_State *L) {
+    luaL_checkudata(L, 1, MATERIAL_MT);
+    lua_getiuservalue(L, 1, 1);
+    return 1;
+}
+
+// rl.GetShaderCacheStats() -> { programs, deduped, compiled, binaryHits, binaryRejected, binarySaved, compileMs, binaryMs }
+static int lua_raylib_get_shader_cache_stats(lua_State *L) {
+    ShaderCacheStats stats = shader_cache_get_stats();
+    lua_createtable(L, 0, 8);
+    lua_pushinteger(L, stats.programs);       lua_setfield(L, -2, "programs");
+    lua_pushinteger(L, stats.deduped);        lua_setfield(L, -2, "deduped");
+    lua_pushinteger(L, stats.compiled);       lua_setfield(L, -2, "compiled");
+    lua_pushinteger(L, stats.binaryHits);     lua_setfield(L, -2, "binaryHits");
+    lua_pushinteger(L, stats.binaryRejected); lua_setfield(L, -2, "binaryRejected");
+    lua_pushinteger(L, stats.binarySaved);    lua_setfield(L, -2, "binarySaved");
+    lua_pushnumber(L, stats.compileMs);       lua_setfield(L, -2, "compileMs");
+    lua_pushnumber(L, stats.binaryMs);        lua_setfield(L, -2, "binaryMs");
+    return 1;
+}
+
+static const struct luaL_Reg shader_methods[] = {
+    {"Unload", shader_method_unload},
+    {"GetId", shader_method_get_id},
+    {"GetLocation", shader_method_get_location},
+    {"IsFromBinary", shader_method_is_from_binary},
+    {"Begin", shader_method_begin},
+    {"End", shader_method_end},
+    {NULL, NULL}
+};
+
+static const struct luaL_Reg material_methods[] = {
+    {"SetFloat", material_method_set_float},
+    {"SetMatrix", material_method_set_matrix},
+    {"Begin", material_method_begin},
+    {"End", shader_method_end},
+    {"GetShader", material_method_get_shader},
+    {NULL, NULL}
+};
+
+static const struct luaL_Reg shader_funcs[] = {
+    {"LoadShaderCode", lua_raylib_load_shader_code},
+    {"Material", lua_raylib_material},
+    {"GetShaderCacheStats", lua_raylib_get_shader_cache_stats},
+    {NULL, NULL}
+};
+
+// Add shader functions to the global 'rl' table (call after raylib_init)
+void shader_init(void) {
+    lua_State *L = lua_get_state();
+    if (!L) {
+        printf("Error: No Lua state available in shader_init\n");
+        return;
+    }
+
+    luaL_newmetatable(L, SHADER_MT);
+    lua_newtable(L);
+    luaL_setfuncs(L, shader_methods, 0);
+    lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, shader_method_unload);
+    lua_setfield(L, -2, "__gc");
+    lua_pop(L, 1);
+
+    luaL_newmetatable(L, MATERIAL_MT);
+    lua_newtable(L);
+    luaL_setfuncs(L, material_methods, 0);
+    lua_setfield(L, -2, "__index");
+    lua_pop(L, 1);
+
+    lua_getglobal(L, "rl");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setglobal(L, "rl");
+    }
+    luaL_setfuncs(L, shader_funcs, 0);
+    lua_settop(L, 0);
+
+    printf("shader module initialized\n");
+}
+
+void shader_cleanup(void) {
+    for (int i = 0; i < g_entry_count; ++i) {
+        if (g_entries[i].id != 0) rlUnloadShaderProgram(g_entries[i].id);
+    }
+    free(g_entries);
+    g_entries = NULL;
+    g_entry_count = 0;
+    g_entry_capacity = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+    printf("shader module cleaned up\n");
+}
@@ -0,0 +1,264 @@
+// net_thread.c
+// One thread per ENet host. Each loop drains the command queue into ENet,
+// services the host for up to intervalMs and pushes every ready event to
+// the event queue. When the event queue is full the event is held back and
+// the thread only flushes outgoing traffic until the main thread catches up,
+// so nothing is dropped and the peers still get their acks.
+#undef ENET_IMPLEMENTATION      // Compiled once, in module_enet.c
+#include <enet.h>
+#include "net_thread.h"
+#include "spsc_queue.h"
+#include "packet_pool.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <pthread.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+typedef enum NetCommandType {
+    NET_COMMAND_SEND,
+    NET_COMMAND_DISCONNECT,
+    NET_COMMAND_BROADCAST,
+    NET_COMMAND_FANOUT,
+} NetCommandType;
+
+typedef struct NetCommand {
+    NetCommandType type;
+    ENetPeer *peer;
+    enet_uint32 connectID;
+    bool checkConnection;   // Drop the send when peer->connectID changed
+    ENetPacket *packet;
+    NetThreadTarget *targets;   // Fan-out targets, pooled
+    int targetCount;
+    enet_uint32 data;
+    enet_uint8 channelID;
+} NetCommand;
+
+typedef struct NetThread {
+    SpscQueue events;           // Network -> main
+    SpscQueue commands;         // Main -> network
+    ENetHost *host;             // NULL = free slot, main thread only
+    pthread_t thread;
+    atomic_bool running;
+    int intervalMs;
+    // Network thread only
+    ENetEvent held;
+    bool holding;
+    // Stats
+    atomic_int eventStalls;
+    atomic_int sendsRejected;
+    atomic_llong loops;
+} NetThread;
+
+static NetThread g_threads[NET_THREAD_MAX_HOSTS];
+
+static void backoff_sleep(void) {
+#if defined(_WIN32)
+    Sleep(1);
+#else
+    struct timespec ts = { 0, 1000000 };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static NetThread *find_thread(ENetHost *host) {
+    if (!host) return NULL;
+    for (int i = 0; i < NET_THREAD_MAX_HOSTS; ++i) {
+        if (g_threads[i].host == host) return &g_threads[i];
+    }
+    return NULL;
+}
+
+static bool same_connection(const ENetPeer *peer, enet_uint32 connectID) {
+    return peer->connectID == connectID;
+}
+
+static void run_commands(NetThread *t) {
+    NetCommand command;
+    while (spsc_pop(&t->commands, &command)) {
+        switch (command.type) {
+        case NET_COMMAND_SEND:
+            if ((command.checkConnection && !same_connection(command.peer, command.connectID)) ||
+                enet_peer_send(command.peer, command.channelID, command.packet) != 0) {
+                enet_packet_destroy(command.packet);    // Peer gone, ENet did not take it
+            }
+            break;
+        case NET_COMMAND_DISCONNECT:
+            enet_peer_disconnect(command.peer, command.data);
+            break;
+        case NET_COMMAND_BROADCAST:
+            enet_host_broadcast(t->host, command.channelID, command.packet);
+            break;
+        case NET_COMMAND_FANOUT:
+            for (int i = 0; i < command.targetCount; ++i) {
+                const NetThreadTarget *target = &command.targets[i];
+                if (!same_connection(target->peer, target->connectID)) continue;   // Slot reused
+                enet_peer_send(target->peer, command.channelID, command.packet);
+            }
+            if (command.packet->referenceCount == 0) enet_packet_destroy(command.packet);
+            packet_pool_free(command.targets);
+            break;
+        }
+    }
+}
+
+// Push event, or hold it back when the queue is full
+static bool deliver(NetThread *t, const ENetEvent *event) {
+    if (spsc_push(&t->events, event)) return true;
+    t->held = *event;
+    t->holding = true;
+    atomic_fetch_add_explicit(&t->eventStalls, 1, memory_order_relaxed);
+    return false;
+}
+
+static void *net_thread_main(void *arg) {
+    NetThread *t = (NetThread *)arg;
+    ENetEvent event;
+    while (atomic_load_explicit(&t->running, memory_order_acquire)) {
+        atomic_fetch_add_explicit(&t->loops, 1, memory_order_relaxed);
+        run_commands(t);
+        if (t->holding) {
+            if (!spsc_push(&t->events, &t->held)) {
+                enet_host_flush(t->host);   // Keep acks going without taking new events
+                backoff_sleep();
+                continue;
+            }
+            t->holding = false;
+        }
+        int result = enet_host_service(t->host, &event, (enet_uint32)t->intervalMs);
+        while (result > 0 && deliver(t, &event)) {
+            result = enet_host_check_events(t->host, &event);
+        }
+        if (result < 0) backoff_sleep();    // Socket error, don't spin on it
+    }
+    run_commands(t);    // Last sends and disconnects still go out
+    enet_host_flush(t->host);
+    return NULL;
+}
+
+bool net_thread_start(ENetHost *host, int intervalMs) {
+    if (!host) return false;
+    if (find_thread(host)) return true;
+    NetThread *t = NULL;
+    for (int i = 0; i < NET_THREAD_MAX_HOSTS && !t; ++i) {
+        if (!g_threads[i].host) t = &g_threads[i];
+    }
+    if (!t) {
+        printf("Error: net thread limit reached (%d hosts)\n", NET_THREAD_MAX_HOSTS);
+        return false;
+    }
+    if (!spsc_init(&t->events, NET_THREAD_EVENTS, sizeof(ENetEvent))) return false;
+    if (!spsc_init(&t->commands, NET_THREAD_COMMANDS, sizeof(NetCommand))) {
+        spsc_free(&t->events);
+        return false;
+    }
+    t->host = host;
+    t->intervalMs = (intervalMs >= 0) ? intervalMs : NET_THREAD_INTERVAL_MS;
+    t->holding = false;
+    atomic_store(&t->eventStalls, 0);
+    atomic_store(&t->sendsRejected, 0);
+    atomic_store(&t->loops, 0);
+    atomic_store(&t->running, true);
+    if (pthread_create(&t->thread, NULL, net_thread_main, t) != 0) {
+        printf("Error: failed to start net thread\n");
+        atomic_store(&t->running, false);
+        spsc_free(&t->events);
+        spsc_free(&t->commands);
+        t->host = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool net_thread_is_running(ENetHost *host) {
+    return find_thread(host) != NULL;
+}
+
+bool net_thread_poll(ENetHost *host, ENetEvent *event) {
+    NetThread *t = find_thread(host);
+    return t && spsc_pop(&t->events, event);
+}
+
+static bool push_command(NetThread *t, const NetCommand *command) {
+    if (spsc_push(&t->commands, command)) return true;
+    atomic_fetch_add_explicit(&t->sendsRejected, 1, memory_order_relaxed);
+    return false;
+}
+
+bool net_thread_send(ENetPeer *peer, uint8_t channelID, ENetPacket *packet) {
+    NetThread *t = peer ? find_thread(peer->host) : NULL;
+    if (!t || !packet) return false;
+    NetCommand command = { .type = NET_COMMAND_SEND, .peer = peer, .packet = packet, .channelID = channelID };
+    return push_command(t, &command);
+}
+
+bool net_thread_send_to(NetThreadTarget target, uint8_t channelID, ENetPacket *packet) {
+    NetThread *t = target.peer ? find_thread(target.peer->host) : NULL;
+    if (!t || !packet) return false;
+    NetCommand command = { .type = NET_COMMAND_SEND, .peer = target.peer, .connectID = target.connectID,
+                           .checkConnection = true, .packet = packet, .channelID = channelID };
+    return push_command(t, &command);
+}
+
+bool net_thread_disconnect(ENetPeer *peer, uint32_t data) {
+    NetThread *t = peer ? find_thread(peer->host) : NULL;
+    if (!t) return false;
+    NetCommand command = { .type = NET_COMMAND_DISCONNECT, .peer = peer, .data = data };
+    return push_command(t, &command);
+}
+
+bool net_thread_broadcast(ENetHost *host, uint8_t channelID, ENetPacket *packet) {
+    NetThread *t = find_thread(host);
+    if (!t || !packet) return false;
+    NetCommand command = { .type = NET_COMMAND_BROADCAST, .packet = packet, .channelID = channelID };
+    return push_command(t, &command);
+}
+
+bool net_thread_fanout(ENetHost *host, uint8_t channelID, ENetPacket *packet, NetThreadTarget *targets, int count) {
+    NetThread *t = find_thread(host);
+    if (!t || !packet || !targets) return false;
+    NetCommand command = { .type = NET_COMMAND_FANOUT, .packet = packet, .targets = targets,
+                           .targetCount = count, .channelID = channelID };
+    return push_command(t, &command);
+}
+
+void net_thread_stop(ENetHost *host) {
+    NetThread *t = find_thread(host);
+    if (!t) return;
+    atomic_store_explicit(&t->running, false, memory_order_release);
+    pthread_join(t->thread, NULL);
+
+    ENetEvent event;
+    while (spsc_pop(&t->events, &event)) {
+        if (event.packet) enet_packet_destroy(event.packet);
+    }
+    if (t->holding && t->held.packet) enet_packet_destroy(t->held.packet);
+    t->holding = false;
+    spsc_free(&t->events);
+    spsc_free(&t->commands);
+    t->host = NULL;
+}
+
+NetThreadStats net_thread_get_stats(ENetHost *host) {
+    NetThreadStats stats = { 0 };
+    NetThread *t = find_thread(host);
+    if (!t) return stats;
+    stats.running = true;
+    stats.queuedEvents = (int)spsc_size(&t->events);
+    stats.queuedCommands = (int)spsc_size(&t->commands);
+    stats.eventStalls = atomic_load_explicit(&t->eventStalls, memory_order_relaxed);
+    stats.sendsRejected = atomic_load_explicit(&t->sendsRejected, memory_order_relaxed);
+    stats.loops = atomic_load_explicit(&t->loops, memory_order_relaxed);
+    return stats;
+}
+
+void net_thread_stop_all(void) {
+    for (int i = 0; i < NET_THREAD_MAX_HOSTS; ++i) {
+        if (g_threads[i].host) net_thread_stop(g_threads[i].host);
+    }
+}
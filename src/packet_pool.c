@@ -0,0 +1,149 @@
+// packet_pool.c
+#undef ENET_IMPLEMENTATION      // Compiled once, in module_enet.c
+#include <enet.h>
+#include "packet_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <pthread.h>
+
+// Header in front of every buffer, keeps the payload max aligned
+typedef union PoolBlock {
+    struct {
+        union PoolBlock *next;      // Free list link
+        int sizeClass;              // -1 = oversize, plain malloc
+    };
+    max_align_t align;
+} PoolBlock;
+
+static PoolBlock *g_free[PACKET_POOL_CLASSES];
+static int g_free_count[PACKET_POOL_CLASSES];
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static PacketPoolStats g_stats;
+
+static size_t class_size(int sizeClass) {
+    return (size_t)PACKET_POOL_MIN_BLOCK << sizeClass;
+}
+
+static int size_class(size_t size) {
+    for (int i = 0; i < PACKET_POOL_CLASSES; ++i) {
+        if (size <= class_size(i)) return i;
+    }
+    return -1;
+}
+
+void *packet_pool_alloc(size_t size, size_t *capacity) {
+    int sizeClass = size_class(size);
+    PoolBlock *block = NULL;
+
+    pthread_mutex_lock(&g_mutex);
+    g_stats.allocs++;
+    g_stats.outstanding++;
+    if (sizeClass < 0) g_stats.oversize++;
+    if (sizeClass >= 0 && g_free[sizeClass]) {
+        block = g_free[sizeClass];
+        g_free[sizeClass] = block->next;
+        g_free_count[sizeClass]--;
+        g_stats.reused++;
+        g_stats.cachedBytes -= class_size(sizeClass);
+    }
+    pthread_mutex_unlock(&g_mutex);
+
+    size_t blockSize = (sizeClass >= 0) ? class_size(sizeClass) : size;
+    if (!block) {
+        block = (PoolBlock *)malloc(sizeof(PoolBlock) + blockSize);
+        if (!block) {
+            pthread_mutex_lock(&g_mutex);
+            g_stats.outstanding--;
+            pthread_mutex_unlock(&g_mutex);
+            return NULL;
+        }
+        block->sizeClass = sizeClass;
+    }
+    block->next = NULL;
+    if (capacity) *capacity = blockSize;
+    return block + 1;
+}
+
+void *packet_pool_grow(void *data, size_t used, size_t size, size_t *capacity) {
+    size_t newCapacity = 0;
+    void *grown = packet_pool_alloc(size, &newCapacity);
+    if (!grown) return NULL;
+    if (data) {
+        memcpy(grown, data, used);
+        packet_pool_free(data);
+    }
+    if (capacity) *capacity = newCapacity;
+    return grown;
+}
+
+void packet_pool_free(void *data) {
+    if (!data) return;
+    PoolBlock *block = (PoolBlock *)data - 1;
+    int sizeClass = block->sizeClass;
+
+    pthread_mutex_lock(&g_mutex);
+    g_stats.frees++;
+    g_stats.outstanding--;
+    if (sizeClass >= 0 && g_free_count[sizeClass] < PACKET_POOL_MAX_FREE) {
+        block->next = g_free[sizeClass];
+        g_free[sizeClass] = block;
+        g_free_count[sizeClass]++;
+        g_stats.cachedBytes += class_size(sizeClass);
+        block = NULL;
+    }
+    pthread_mutex_unlock(&g_mutex);
+    free(block);
+}
+
+static void *ENET_CALLBACK pool_enet_malloc(size_t size) {
+    return packet_pool_alloc(size, NULL);
+}
+
+static void ENET_CALLBACK pool_enet_free(void *memory) {
+    packet_pool_free(memory);
+}
+
+static void ENET_CALLBACK pool_enet_no_memory(void) {
+    fprintf(stderr, "Error: ENet out of memory\n");
+    abort();
+}
+
+bool packet_pool_install(void) {
+    ENetCallbacks callbacks = { pool_enet_malloc, pool_enet_free, pool_enet_no_memory };
+    return enet_initialize_with_callbacks(ENET_VERSION, &callbacks) == 0;
+}
+
+static void ENET_CALLBACK pool_packet_free(ENetPacket *packet) {
+    packet_pool_free(packet->data);
+    packet->data = NULL;
+}
+
+ENetPacket *packet_pool_packet(void *data, size_t length, uint32_t flags) {
+    ENetPacket *packet = enet_packet_create(data, length, flags | ENET_PACKET_FLAG_NO_ALLOCATE);
+    if (!packet) return NULL;
+    packet->freeCallback = pool_packet_free;
+    return packet;
+}
+
+PacketPoolStats packet_pool_get_stats(void) {
+    pthread_mutex_lock(&g_mutex);
+    PacketPoolStats stats = g_stats;
+    pthread_mutex_unlock(&g_mutex);
+    return stats;
+}
+
+void packet_pool_cleanup(void) {
+    pthread_mutex_lock(&g_mutex);
+    for (int i = 0; i < PACKET_POOL_CLASSES; ++i) {
+        while (g_free[i]) {
+            PoolBlock *block = g_free[i];
+            g_free[i] = block->next;
+            free(block);
+        }
+        g_free_count[i] = 0;
+    }
+    g_stats.cachedBytes = 0;
+    pthread_mutex_unlock(&g_mutex);
+}
@@ -0,0 +1,149 @@
+// peer_group.c
+#undef ENET_IMPLEMENTATION      // Compiled once, in module_enet.c
+#include <enet.h>
+#include "peer_group.h"
+#include "net_thread.h"
+#include "packet_pool.h"
+#include <stdlib.h>
+
+static PeerGroup *g_groups = NULL;     // Live groups, main thread only
+
+void peer_group_init(PeerGroup *group) {
+    group->members = NULL;
+    group->count = 0;
+    group->capacity = 0;
+    group->prev = NULL;
+    group->next = g_groups;
+    if (g_groups) g_groups->prev = group;
+    g_groups = group;
+}
+
+void peer_group_free(PeerGroup *group) {
+    if (group->prev) group->prev->next = group->next;
+    else if (g_groups == group) g_groups = group->next;
+    if (group->next) group->next->prev = group->prev;
+    group->prev = group->next = NULL;
+    free(group->members);
+    group->members = NULL;
+    group->count = group->capacity = 0;
+}
+
+static int find_member(const PeerGroup *group, const ENetPeer *peer) {
+    for (int i = 0; i < group->count; ++i) {
+        if (group->members[i].peer == peer) return i;
+    }
+    return -1;
+}
+
+bool peer_group_add(PeerGroup *group, ENetPeer *peer, uint32_t channels) {
+    int index = find_member(group, peer);
+    if (index >= 0) {
+        group->members[index].channels = channels;
+        group->members[index].connectID = peer->connectID;
+        return true;
+    }
+    if (group->count == group->capacity) {
+        int capacity = group->capacity ? group->capacity*2 : 16;
+        PeerGroupMember *members = (PeerGroupMember *)realloc(group->members, (size_t)capacity*sizeof(PeerGroupMember));
+        if (!members) return false;
+        group->members = members;
+        group->capacity = capacity;
+    }
+    group->members[group->count++] = (PeerGroupMember){ peer, channels, peer->connectID };
+    return true;
+}
+
+bool peer_group_remove(PeerGroup *group, ENetPeer *peer) {
+    int index = find_member(group, peer);
+    if (index < 0) return false;
+    group->members[index] = group->members[--group->count];    // Order doesn't matter
+    return true;
+}
+
+void peer_group_clear(PeerGroup *group) {
+    group->count = 0;
+}
+
+static bool wants(const PeerGroupMember *member, uint8_t channelID, const ENetPeer *except) {
+    if (member->peer == except) return false;
+    return channelID >= 32 || (member->channels & (1u << channelID));
+}
+
+int peer_group_send(PeerGroup *group, uint8_t channelID, ENetPacket *packet, ENetPeer *except) {
+    // Domains: peers serviced on the main thread, then one per threaded host
+    ENetHost *threaded[NET_THREAD_MAX_HOSTS];
+    int threadedCounts[NET_THREAD_MAX_HOSTS] = { 0 };
+    int threadedCount = 0;
+    bool local = false;
+    for (int i = 0; i < group->count; ++i) {
+        const PeerGroupMember *member = &group->members[i];
+        if (!wants(member, channelID, except)) continue;
+        ENetHost *host = member->peer->host;
+        if (!net_thread_is_running(host)) {
+            local = true;
+            continue;
+        }
+        int slot = 0;
+        while (slot < threadedCount && threaded[slot] != host) slot++;
+        if (slot == threadedCount) threaded[threadedCount++] = host;
+        threadedCounts[slot]++;
+    }
+
+    // The original goes to the first domain, copies are made before any
+    // thread can touch it
+    ENetPacket *packets[NET_THREAD_MAX_HOSTS + 1] = { 0 };
+    int domains = (local ? 1 : 0) + threadedCount;
+    if (domains == 0) {
+        enet_packet_destroy(packet);
+        return 0;
+    }
+    packets[0] = packet;
+    for (int d = 1; d < domains; ++d) {
+        packets[d] = enet_packet_create(packet->data, packet->dataLength, packet->flags & ~ENET_PACKET_FLAG_NO_ALLOCATE);
+    }
+
+    int sent = 0;
+    int domain = 0;
+    if (local) {
+        ENetPacket *shared = packets[domain++];
+        for (int i = 0; i < group->count; ++i) {
+            const PeerGroupMember *member = &group->members[i];
+            if (!wants(member, channelID, except) || net_thread_is_running(member->peer->host)) continue;
+            if (enet_peer_send(member->peer, channelID, shared) == 0) sent++;
+        }
+        if (shared->referenceCount == 0) enet_packet_destroy(shared);
+    }
+    for (int slot = 0; slot < threadedCount; ++slot) {
+        ENetPacket *shared = packets[domain++];
+        if (!shared) continue;      // Copy failed
+        NetThreadTarget *targets = (NetThreadTarget *)packet_pool_alloc((size_t)threadedCounts[slot]*sizeof(NetThreadTarget), NULL);
+        int count = 0;
+        for (int i = 0; targets && i < group->count; ++i) {
+            const PeerGroupMember *member = &group->members[i];
+            if (wants(member, channelID, except) && member->peer->host == threaded[slot]) {
+                targets[count++] = (NetThreadTarget){ member->peer, member->connectID };
+            }
+        }
+        if (targets && net_thread_fanout(threaded[slot], channelID, shared, targets, count)) {
+            sent += count;
+        } else {
+            packet_pool_free(targets);
+            enet_packet_destroy(shared);
+        }
+    }
+    return sent;
+}
+
+void peer_group_forget_peer(ENetPeer *peer) {
+    for (PeerGroup *group = g_groups; group; group = group->next) {
+        peer_group_remove(group, peer);
+    }
+}
+
+void peer_group_forget_host(ENetHost *host) {
+    for (PeerGroup *group = g_groups; group; group = group->next) {
+        for (int i = group->count - 1; i >= 0; --i) {
+            if (group->members[i].peer->host == host) group->members[i] = group->members[--group->count];
+        }
+    }
+}
@@ -0,0 +1,132 @@
+// perf_overlay.c
+// Small ImGui window with frame and render batch counters (F3 toggles).
+#include "perf_overlay.h"
+#include "module_batch.h"
+#include "frame_pacing.h"
+#include "ui_layer.h"
+#include "render_pipeline.h"
+#include "gpu_timer.h"
+#include "profiler.h"
+#include "imgui_rlgl.h"
+#include "scene_scale.h"
+#include "cimgui.h"
+#include <stdio.h>
+
+#define igGetIO igGetIO_Nil
+
+static bool g_visible = false;
+
+void perf_overlay_set_visible(bool visible) {
+    g_visible = visible;
+}
+
+void perf_overlay_toggle(void) {
+    g_visible = !g_visible;
+}
+
+bool perf_overlay_is_visible(void) {
+    return g_visible;
+}
+
+// Phase table + frame time graph, shown while the profiler runs (F4)
+static void draw_profiler(void) {
+    igSetNextWindowPos((ImVec2){ 10.0f, 300.0f }, ImGuiCond_FirstUseEver, (ImVec2){ 0.0f, 0.0f });
+    if (!igBegin("Profiler", NULL, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing)) {
+        igEnd();
+        return;
+    }
+    int count = 0, offset = 0;
+    const float *frames = profiler_get_frame_history(&count, &offset);
+    igPlotLines_FloatPtr("##frames", frames, count, offset, "frame ms", 0.0f, 40.0f, (ImVec2){ 360.0f, 60.0f }, sizeof(float));
+
+    if (igBeginTable("phases", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit, (ImVec2){ 0.0f, 0.0f }, 0.0f)) {
+        igTableSetupColumn("scope", 0, 0.0f, 0);
+        igTableSetupColumn("last", 0, 0.0f, 0);
+        igTableSetupColumn("p50", 0, 0.0f, 0);
+        igTableSetupColumn("p95", 0, 0.0f, 0);
+        igTableSetupColumn("p99", 0, 0.0f, 0);
+        igTableSetupColumn("max", 0, 0.0f, 0);
+        igTableHeadersRow();
+        for (int i = 0; i < profiler_get_scope_count(); ++i) {
+            ProfilerStats stats = profiler_get_stats(i);
+            if (stats.samples == 0) continue;
+            igTableNextRow(0, 0.0f);
+            igTableNextColumn(); igText("%s", stats.name);
+            igTableNextColumn(); igText("%.3f", stats.lastMs);
+            igTableNextColumn(); igText("%.3f", stats.p50Ms);
+            igTableNextColumn(); igText("%.3f", stats.p95Ms);
+            igTableNextColumn(); igText("%.3f", stats.p99Ms);
+            igTableNextColumn(); igText("%.3f", stats.maxMs);
+        }
+        igEndTable();
+    }
+    igEnd();
+}
+
+void perf_overlay_draw(void) {
+    if (profiler_enabled) draw_profiler();
+    if (!g_visible) return;
+
+    ImGuiIO *io = igGetIO();
+    ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                             ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+                             ImGuiWindowFlags_NoNav;
+    igSetNextWindowPos((ImVec2){ 10.0f, 10.0f }, ImGuiCond_Always, (ImVec2){ 0.0f, 0.0f });
+    igSetNextWindowBgAlpha(0.6f);
+    if (igBegin("Perf Overlay", NULL, flags)) {
+        igText("%.1f FPS (%.2f ms)", io->Framerate, 1000.0f/io->Framerate);
+        PacingStats pacing = pacing_get_stats();
+        igText("Pacing: %s", pacing_mode_name(pacing_get_mode()));
+        igText("Jitter: %.2f ms  p99: %.2f ms", pacing.jitterMs, pacing.p99Ms);
+        igText("Latch to swap: %.2f ms", pacing.latchMs);
+        PipelineStats pipeline = pipeline_get_stats();
+        igText("Latency: %.2f ms  p99: %.2f ms", pipeline.latencyMs, pipeline.latencyP99Ms);
+        if (pipeline.active) {
+            igText("Pipeline: %d in flight", pipeline.depth);
+            igText("Build %.2f  stall %.2f  present %.2f ms", pipeline.buildMs, pipeline.stallMs, pipeline.presentMs);
+        }
+        SceneScaleStats dynres = scene_scale_get_stats();
+        if (dynres.enabled) {
+            igText("3D: %dx%d (%.0f%%, %dx MSAA)", dynres.width, dynres.height, dynres.scale*100.0f, dynres.samples);
+            igText("3D time: %.2f / %.2f ms", dynres.measuredMs, dynres.targetMs);
+        }
+        igSeparator();
+
+        if (gpu_timer_is_enabled()) {
+            double total = 0.0;
+            for (int p = 0; p < GPU_PASS_COUNT; ++p) {
+                GpuPassStats stats = gpu_timer_get_stats((GpuPass)p);
+                int count = 0, offset = 0;
+                const float *ms = gpu_timer_get_history((GpuPass)p, &count, &offset);
+                char overlay[64];
+                snprintf(overlay, sizeof(overlay), "%s %.2f ms (p95 %.2f)", gpu_timer_pass_name((GpuPass)p), stats.avgMs, stats.p95Ms);
+                igPlotHistogram_FloatPtr(gpu_timer_pass_name((GpuPass)p), ms, count, offset, overlay,
+                                         0.0f, (float)(stats.maxMs > 0.0 ? stats.maxMs : 1.0), (ImVec2){ 220.0f, 32.0f }, sizeof(float));
+                total += stats.avgMs;
+            }
+            igText("GPU total: %.2f ms (%d untimed)", total, gpu_timer_get_skipped());
+            igSeparator();
+        }
+
+        BatchStats batch = batch_get_stats();
+        igText("Batch: %d x %d", batch_get_buffer_count(), batch_get_buffer_elements());
+        igText("Flushes: %d (internal %d)", batch.flushes, batch.internalFlushes);
+        igText("Vertices: %d", batch.vertices);
+        igText("Draw calls: %d", batch.drawCalls);
+        igSeparator();
+
+        UiLayerStats ui = ui_layer_get_stats();
+        if (ui_layer_is_enabled()) {
+            igText("UI: %s (%d / %d redrawn)", ui.cached ? "cached" : "redrawn", ui.redraws, ui.frames);
+            if (ui_layer_get_rate() > 0.0) igText("UI rate: %.0f Hz (%d deferred)", ui_layer_get_rate(), ui.deferred);
+            igText("UI hash: %.3f ms", ui.hashMs);
+        } else {
+            igText("UI: direct");
+        }
+        if (imgui_rlgl_is_active()) {
+            ImguiRlglStats imgui = imgui_rlgl_get_stats();
+            igText("ImGui: %d draws, %d binds, %d orphans", imgui.drawCalls, imgui.textureBinds, imgui.orphans);
+        }
+    }
+    igEnd();
+}
@@ -0,0 +1,141 @@
+// profiler.c
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>         // glfwGetTime()
+
+typedef struct ProfilerScope {
+    char name[32];
+    double start;           // Open section, < 0 when closed
+    double frameSeconds;    // Accumulated this frame
+    bool hit;
+    float ms[PROFILER_HISTORY];
+    int count;
+    int next;
+} ProfilerScope;
+
+bool profiler_enabled = false;
+
+static ProfilerScope g_scopes[PROFILER_MAX_SCOPES];
+static int g_scope_count = 0;
+static float g_frame_ms[PROFILER_HISTORY];
+static int g_frame_count = 0;
+static int g_frame_next = 0;
+static double g_frame_start = 0.0;
+
+static const char *g_phase_names[PROF_BUILTIN_COUNT] = {
+    "events", "new frame", "draw", "igRender", "scene", "flush", "ui render", "swap"
+};
+
+void profiler_setup(void) {
+    memset(g_scopes, 0, sizeof(g_scopes));
+    g_scope_count = 0;
+    for (int i = 0; i < PROF_BUILTIN_COUNT; ++i) profiler_register(g_phase_names[i]);
+}
+
+void profiler_set_enabled(bool enabled) {
+    if (enabled && !profiler_enabled) {
+        // Samples from before a pause would distort the percentiles
+        for (int i = 0; i < g_scope_count; ++i) {
+            g_scopes[i].count = g_scopes[i].next = 0;
+            g_scopes[i].start = -1.0;
+            g_scopes[i].frameSeconds = 0.0;
+            g_scopes[i].hit = false;
+        }
+        g_frame_count = g_frame_next = 0;
+        g_frame_start = glfwGetTime();
+    }
+    profiler_enabled = enabled;
+}
+
+int profiler_find(const char *name) {
+    for (int i = 0; i < g_scope_count; ++i) {
+        if (strcmp(g_scopes[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+int profiler_register(const char *name) {
+    int id = profiler_find(name);
+    if (id >= 0) return id;
+    if (g_scope_count >= PROFILER_MAX_SCOPES) return -1;
+    id = g_scope_count++;
+    snprintf(g_scopes[id].name, sizeof(g_scopes[id].name), "%s", name);
+    g_scopes[id].start = -1.0;
+    return id;
+}
+
+int profiler_get_scope_count(void) {
+    return g_scope_count;
+}
+
+void profiler_begin(int id) {
+    if (id < 0 || id >= g_scope_count) return;
+    g_scopes[id].start = glfwGetTime();
+}
+
+void profiler_end(int id) {
+    if (id < 0 || id >= g_scope_count) return;
+    ProfilerScope *scope = &g_scopes[id];
+    if (scope->start < 0.0) return;
+    scope->frameSeconds += glfwGetTime() - scope->start;
+    scope->start = -1.0;
+    scope->hit = true;
+}
+
+void profiler_frame(void) {
+    if (!profiler_enabled) return;
+    for (int i = 0; i < g_scope_count; ++i) {
+        ProfilerScope *scope = &g_scopes[i];
+        if (!scope->hit) continue;
+        scope->ms[scope->next] = (float)(scope->frameSeconds*1000.0);
+        scope->next = (scope->next + 1) % PROFILER_HISTORY;
+        if (scope->count < PROFILER_HISTORY) scope->count++;
+        scope->frameSeconds = 0.0;
+        scope->hit = false;
+    }
+
+    double now = glfwGetTime();
+    g_frame_ms[g_frame_next] = (float)((now - g_frame_start)*1000.0);
+    g_frame_next = (g_frame_next + 1) % PROFILER_HISTORY;
+    if (g_frame_count < PROFILER_HISTORY) g_frame_count++;
+    g_frame_start = now;
+}
+
+static int compare_float(const void *a, const void *b) {
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+ProfilerStats profiler_get_stats(int id) {
+    ProfilerStats stats = { 0 };
+    if (id < 0 || id >= g_scope_count) return stats;
+    const ProfilerScope *scope = &g_scopes[id];
+    stats.name = scope->name;
+    if (scope->count == 0) return stats;
+
+    float sorted[PROFILER_HISTORY];
+    double sum = 0.0;
+    for (int i = 0; i < scope->count; ++i) {
+        sorted[i] = scope->ms[i];
+        sum += scope->ms[i];
+    }
+    qsort(sorted, (size_t)scope->count, sizeof(float), compare_float);
+    int last = (scope->next + PROFILER_HISTORY - 1) % PROFILER_HISTORY;
+    stats.samples = scope->count;
+    stats.lastMs = scope->ms[last];
+    stats.avgMs = sum/scope->count;
+    stats.p50Ms = sorted[(scope->count - 1)*50/100];
+    stats.p95Ms = sorted[(scope->count - 1)*95/100];
+    stats.p99Ms = sorted[(scope->count - 1)*99/100];
+    stats.maxMs = sorted[scope->count - 1];
+    return stats;
+}
+
+const float *profiler_get_frame_history(int *count, int *offset) {
+    *count = g_frame_count;
+    *offset = (g_frame_count == PROFILER_HISTORY) ? g_frame_next : 0;
+    return g_frame_ms;
+}
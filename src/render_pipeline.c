@@ -0,0 +1,391 @@
+// render_pipeline.c
+// Slots cycle FREE -> BUILDING (main) -> READY -> PRESENTING (render) -> FREE.
+// Hand-off goes through one mutex, the GPU side through a fence: the build
+// context fences after the 3D pass and texture uploads, the render context
+// waits on it (server side) before sampling the slot.
+//
+// Everything ImGui owns stays on the main thread. Font/texture updates are
+// uploaded there (textures are shared), the render thread only gets a deep
+// copy of the draw lists with Textures = NULL and every TexRef resolved to
+// its GL name. Texture destruction waits until no frame in flight uses it.
+#include "render_pipeline.h"
+#include "frame_pacing.h"
+#include "gl_ext.h"
+#include "cimgui_impl.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rlgl.h"
+
+typedef enum {
+    SLOT_FREE = 0,
+    SLOT_BUILDING,
+    SLOT_READY,
+    SLOT_PRESENTING
+} SlotState;
+
+typedef struct PipelineSlot {
+    SlotState state;
+
+    // Build context
+    unsigned int fbo;
+    unsigned int colorTexture;      // Shared with the render context
+    unsigned int depthBuffer;
+    int width;
+    int height;
+    int generation;                 // Bumped when the texture is reallocated
+
+    // Render context
+    unsigned int presentFbo;        // Wraps colorTexture, FBOs are not shared
+    int presentGeneration;
+
+    void *fence;
+    int swapInterval;
+    double inputTime;
+    double buildStart;
+
+    ImDrawData drawData;            // Deep copy, owned by the slot
+    ImDrawList **lists;
+    int listCapacity;
+} PipelineSlot;
+
+static GLFWwindow *g_window = NULL;         // Presented by the render thread
+static GLFWwindow *g_build = NULL;          // Hidden, shares objects with g_window
+static PipelineSlot g_slots[PIPELINE_MAX_DEPTH];
+static int g_depth = 0;
+static int g_write = 0;
+static int g_read = 0;
+static bool g_active = false;
+static bool g_quit = false;
+static bool g_thread_running = false;
+
+static pthread_t g_thread;
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_ready = PTHREAD_COND_INITIALIZER;   // Slot became READY (or quit)
+static pthread_cond_t g_free = PTHREAD_COND_INITIALIZER;    // Slot became FREE
+
+static double g_inputTime = 0.0;
+static double g_latency[PIPELINE_HISTORY];  // Seconds, guarded by g_mutex
+static int g_latency_count = 0;
+static int g_latency_next = 0;
+static double g_buildMs = 0.0;
+static double g_stallMs = 0.0;
+static double g_presentMs = 0.0;
+
+static double smooth(double average, double sample) {
+    return average*0.9 + sample*0.1;
+}
+
+// Caller holds g_mutex (or there is no render thread)
+static void record_latency(double seconds) {
+    g_latency[g_latency_next] = seconds;
+    g_latency_next = (g_latency_next + 1) % PIPELINE_HISTORY;
+    if (g_latency_count < PIPELINE_HISTORY) g_latency_count++;
+}
+
+static void *render_thread(void *arg);
+
+bool pipeline_setup(GLFWwindow *window, int depth) {
+    if (depth <= 0) return false;
+    if (depth < 2) depth = 2;
+    if (depth > PIPELINE_MAX_DEPTH) depth = PIPELINE_MAX_DEPTH;
+
+    // Checked on the window context, before anything is created on the build one
+    gl_ext_load((GlExtLoadProc)glfwGetProcAddress);
+    if (!glext.FenceSync || !glext.WaitSync || !glext.DeleteSync || !glext.BlitFramebuffer) {
+        printf("Pipeline: sync objects or framebuffer blit missing, rendering on the main thread\n");
+        return false;
+    }
+
+    // Same context hints as the window, still set from CreateAppWindow()
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    g_build = glfwCreateWindow(1, 1, "build", NULL, window);
+    glfwDefaultWindowHints();
+    if (!g_build) {
+        printf("Pipeline: shared context failed, rendering on the main thread\n");
+        glfwMakeContextCurrent(window);
+        return false;
+    }
+
+    memset(g_slots, 0, sizeof(g_slots));
+    g_window = window;
+    g_depth = depth;
+    g_write = g_read = 0;
+    g_quit = false;
+    glfwMakeContextCurrent(g_build);    // rlgl and ImGui objects are created here
+
+    // Started now so a failure still leaves the window context usable; it
+    // idles until pipeline_start() lets frames through
+    if (pthread_create(&g_thread, NULL, render_thread, NULL) != 0) {
+        printf("Pipeline: failed to start the render thread, rendering on the main thread\n");
+        glfwMakeContextCurrent(window);
+        glfwDestroyWindow(g_build);
+        g_build = NULL;
+        g_window = NULL;
+        g_depth = 0;
+        return false;
+    }
+    g_thread_running = true;
+    return true;
+}
+
+// ImVector_T layout: { int Size; int Capacity; T *Data; }
+#define COPY_VECTOR(dst, src) \
+    copy_vector(&(dst).Size, &(dst).Capacity, (void **)&(dst).Data, (src).Data, (src).Size, sizeof(*(src).Data))
+
+static void copy_vector(int *size, int *capacity, void **data, const void *src, int count, size_t elemSize) {
+    if (count > *capacity) {
+        void *grown = igMemAlloc((size_t)count*elemSize);  // ImDrawList_destroy frees with IM_FREE
+        if (*data) igMemFree(*data);
+        *data = grown;
+        *capacity = count;
+    }
+    if (count > 0) memcpy(*data, src, (size_t)count*elemSize);
+    *size = count;
+}
+
+static void copy_draw_data(PipelineSlot *slot, ImDrawData *src) {
+    int count = src->CmdListsCount;
+    if (count > slot->listCapacity) {
+        slot->lists = (ImDrawList **)realloc(slot->lists, (size_t)count*sizeof(ImDrawList *));
+        for (int i = slot->listCapacity; i < count; ++i) slot->lists[i] = ImDrawList_ImDrawList(NULL);
+        slot->listCapacity = count;
+    }
+    for (int n = 0; n < count; ++n) {
+        const ImDrawList *from = src->CmdLists.Data[n];
+        ImDrawList *to = slot->lists[n];
+        COPY_VECTOR(to->CmdBuffer, from->CmdBuffer);
+        // ImTextureData stays on the main thread, the render thread only sees GL names
+        for (int c = 0; c < to->CmdBuffer.Size; ++c) {
+            ImTextureRef *ref = &to->CmdBuffer.Data[c].TexRef;
+            if (ref->_TexData) ref->_TexID = ref->_TexData->TexID;
+            ref->_TexData = NULL;
+        }
+        COPY_VECTOR(to->IdxBuffer, from->IdxBuffer);
+        COPY_VECTOR(to->VtxBuffer, from->VtxBuffer);
+        to->Flags = from->Flags;
+    }
+
+    ImDrawData *dst = &slot->drawData;
+    dst->Valid = src->Valid;
+    dst->CmdListsCount = count;
+    dst->TotalIdxCount = src->TotalIdxCount;
+    dst->TotalVtxCount = src->TotalVtxCount;
+    dst->CmdLists.Size = count;
+    dst->CmdLists.Capacity = slot->listCapacity;
+    dst->CmdLists.Data = slot->lists;
+    dst->DisplayPos = src->DisplayPos;
+    dst->DisplaySize = src->DisplaySize;
+    dst->FramebufferScale = src->FramebufferScale;
+    dst->OwnerViewport = src->OwnerViewport;
+    dst->Textures = NULL;       // Updated on the main thread
+}
+
+static void free_slot(PipelineSlot *slot) {
+    if (slot->fbo) rlUnloadFramebuffer(slot->fbo);     // Also deletes the depth attachment
+    if (slot->colorTexture) rlUnloadTexture(slot->colorTexture);
+    for (int i = 0; i < slot->listCapacity; ++i) ImDrawList_destroy(slot->lists[i]);
+    free(slot->lists);
+    memset(slot, 0, sizeof(PipelineSlot));
+}
+
+static void ensure_target(PipelineSlot *slot, int width, int height) {
+    if (slot->fbo && slot->width == width && slot->height == height) return;
+    if (slot->fbo) rlUnloadFramebuffer(slot->fbo);
+    if (slot->colorTexture) rlUnloadTexture(slot->colorTexture);
+
+    slot->fbo = rlLoadFramebuffer();
+    slot->colorTexture = rlLoadTexture(NULL, width, height, RL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+    slot->depthBuffer = rlLoadTextureDepth(width, height, true);
+    rlFramebufferAttach(slot->fbo, slot->colorTexture, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+    rlFramebufferAttach(slot->fbo, slot->depthBuffer, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
+    if (!rlFramebufferComplete(slot->fbo)) printf("Error: pipeline framebuffer incomplete\n");
+    slot->width = width;
+    slot->height = height;
+    slot->generation++;
+}
+
+// Render thread, window context current
+static void present(PipelineSlot *slot) {
+    if (!slot->presentFbo || slot->presentGeneration != slot->generation) {
+        if (!slot->presentFbo) glext.GenFramebuffers(1, &slot->presentFbo);
+        glext.BindFramebuffer(GL_READ_FRAMEBUFFER, slot->presentFbo);
+        glext.FramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slot->colorTexture, 0);
+        slot->presentGeneration = slot->generation;
+    }
+
+    glext.WaitSync(slot->fence, 0, GL_TIMEOUT_IGNORED);
+    glext.DeleteSync(slot->fence);
+    slot->fence = NULL;
+
+    glext.BindFramebuffer(GL_READ_FRAMEBUFFER, slot->presentFbo);
+    glext.BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glext.BlitFramebuffer(0, 0, slot->width, slot->height, 0, 0, slot->width, slot->height,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glext.BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    ImGui_ImplOpenGL3_RenderDrawData(&slot->drawData);
+}
+
+static void *render_thread(void *arg) {
+    (void)arg;
+    glfwMakeContextCurrent(g_window);
+    int interval = -1;
+
+    pthread_mutex_lock(&g_mutex);
+    for (;;) {
+        PipelineSlot *slot = &g_slots[g_read];
+        while (slot->state != SLOT_READY && !g_quit) pthread_cond_wait(&g_ready, &g_mutex);
+        if (slot->state != SLOT_READY) break;   // Quit with nothing left to present
+        slot->state = SLOT_PRESENTING;
+        pthread_mutex_unlock(&g_mutex);
+
+        double start = glfwGetTime();
+        if (slot->swapInterval != interval) {
+            interval = slot->swapInterval;
+            glfwSwapInterval(interval);     // Applies to the current (window) context
+        }
+        present(slot);
+        glfwSwapBuffers(g_window);
+        double now = glfwGetTime();
+
+        pthread_mutex_lock(&g_mutex);
+        record_latency(now - slot->inputTime);
+        g_presentMs = smooth(g_presentMs, (now - start)*1000.0);
+        slot->state = SLOT_FREE;
+        g_read = (g_read + 1) % g_depth;
+        pthread_cond_signal(&g_free);
+    }
+    pthread_mutex_unlock(&g_mutex);
+
+    for (int i = 0; i < g_depth; ++i) {
+        if (g_slots[i].presentFbo) glext.DeleteFramebuffers(1, &g_slots[i].presentFbo);
+        g_slots[i].presentFbo = 0;
+    }
+    glfwMakeContextCurrent(NULL);
+    return NULL;
+}
+
+void pipeline_start(void) {
+    if (!g_thread_running || g_active) return;
+    g_active = true;
+    printf("Pipeline: render thread started, %d frames in flight\n", g_depth);
+}
+
+bool pipeline_is_active(void) {
+    return g_active;
+}
+
+void pipeline_acquire(void) {
+    if (!g_active) return;
+    double start = glfwGetTime();
+    PipelineSlot *slot = &g_slots[g_write];
+    pthread_mutex_lock(&g_mutex);
+    while (slot->state != SLOT_FREE) pthread_cond_wait(&g_free, &g_mutex);
+    slot->state = SLOT_BUILDING;
+    g_stallMs = smooth(g_stallMs, (glfwGetTime() - start)*1000.0);
+    pthread_mutex_unlock(&g_mutex);
+}
+
+void pipeline_mark_input(void) {
+    g_inputTime = glfwGetTime();
+}
+
+void pipeline_begin_frame(int width, int height) {
+    if (!g_active) return;
+    PipelineSlot *slot = &g_slots[g_write];
+    ensure_target(slot, width, height);
+    slot->inputTime = g_inputTime;
+    slot->buildStart = glfwGetTime();
+    rlEnableFramebuffer(slot->fbo);
+    rlViewport(0, 0, width, height);
+}
+
+void pipeline_submit(ImDrawData *drawData) {
+    if (!g_active) return;
+    PipelineSlot *slot = &g_slots[g_write];
+
+    if (drawData && drawData->Textures) {
+        for (int i = 0; i < drawData->Textures->Size; ++i) {
+            ImTextureData *tex = drawData->Textures->Data[i];
+            if (tex->Status == ImTextureStatus_OK) continue;
+            // Frames still in flight may sample it, destroy once they are presented
+            if (tex->Status == ImTextureStatus_WantDestroy && tex->UnusedFrames <= g_depth) continue;
+            ImGui_ImplOpenGL3_UpdateTexture(tex);
+        }
+    }
+    if (drawData) {
+        copy_draw_data(slot, drawData);
+    } else {
+        slot->drawData.CmdListsCount = 0;
+        slot->drawData.CmdLists.Size = 0;
+    }
+
+    rlDisableFramebuffer();
+    slot->fence = glext.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glext.Flush();      // The fence must reach the GPU before the other context waits on it
+    slot->swapInterval = pacing_get_swap_interval();
+
+    pthread_mutex_lock(&g_mutex);
+    g_buildMs = smooth(g_buildMs, (glfwGetTime() - slot->buildStart)*1000.0);
+    slot->state = SLOT_READY;
+    g_write = (g_write + 1) % g_depth;
+    pthread_cond_signal(&g_ready);
+    pthread_mutex_unlock(&g_mutex);
+}
+
+void pipeline_mark_presented(void) {
+    record_latency(glfwGetTime() - g_inputTime);
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+PipelineStats pipeline_get_stats(void) {
+    PipelineStats stats = { 0 };
+    double sorted[PIPELINE_HISTORY];
+
+    pthread_mutex_lock(&g_mutex);
+    int count = g_latency_count;
+    memcpy(sorted, g_latency, (size_t)count*sizeof(double));
+    stats.buildMs = g_buildMs;
+    stats.stallMs = g_stallMs;
+    stats.presentMs = g_presentMs;
+    pthread_mutex_unlock(&g_mutex);
+
+    stats.active = g_active;
+    stats.depth = g_active ? g_depth : 0;
+    stats.samples = count;
+    if (count == 0) return stats;
+
+    double sum = 0.0;
+    for (int i = 0; i < count; ++i) sum += sorted[i];
+    qsort(sorted, (size_t)count, sizeof(double), compare_double);
+    stats.latencyMs = sum/count*1000.0;
+    stats.latencyP99Ms = sorted[(count - 1)*99/100]*1000.0;
+    stats.latencyMaxMs = sorted[count - 1]*1000.0;
+    return stats;
+}
+
+void pipeline_stop(void) {
+    if (g_thread_running) {
+        pthread_mutex_lock(&g_mutex);
+        g_quit = true;
+        pthread_cond_broadcast(&g_ready);
+        pthread_mutex_unlock(&g_mutex);
+        pthread_join(g_thread, NULL);
+        g_thread_running = false;
+        g_active = false;
+    }
+    for (int i = 0; i < g_depth; ++i) free_slot(&g_slots[i]);
+}
+
+void pipeline_cleanup(void) {
+    if (g_build) glfwDestroyWindow(g_build);
+    g_build = NULL;
+    g_window = NULL;
+    g_depth = 0;
+}
@@ -0,0 +1,252 @@
+// scene_scale.c
+#include "scene_scale.h"
+#include "module_batch.h"
+#include "gpu_timer.h"
+#include "app_clock.h"
+#include "gl_ext.h"
+#include <stdio.h>
+#include "rlgl.h"
+#include "raymath.h"
+
+typedef struct ScaleLevel {
+    float scale;
+    int samples;
+} ScaleLevel;
+
+static ScaleLevel g_levels[SCENE_SCALE_MAX_LEVELS];
+static int g_level_count = 0;
+static int g_level = 0;
+static double g_target = 0.0;
+static double g_measured = 0.0;     // Smoothed, 0 = restart after a change
+static int g_cooldown = 0;
+static int g_changes = 0;
+static double g_workStart = 0.0;
+static double g_workMs = 0.0;       // CPU time of the last 3D pass, scene_scale_pass_begin..end
+
+// Multisampled target (samples > 1), resolved into g_fbo
+static unsigned int g_msFbo = 0;
+static unsigned int g_msColor = 0;
+static unsigned int g_msDepth = 0;
+// Single sample target: g_texture, plus a depth buffer when not multisampled
+static unsigned int g_fbo = 0;
+static unsigned int g_texture = 0;
+static int g_width = 0;
+static int g_height = 0;
+static int g_samples = 0;
+
+// This frame
+static bool g_active = false;
+static unsigned int g_output = 0;
+static int g_outWidth = 0;
+static int g_outHeight = 0;
+
+void scene_scale_setup(int maxSamples, float minScale) {
+    int limit = 1;
+    if (glext.RenderbufferStorageMultisample && glext.GenRenderbuffers) glext.GetIntegerv(GL_MAX_SAMPLES, &limit);
+    if (maxSamples > limit) maxSamples = limit;
+    if (minScale < 0.25f) minScale = 0.25f;
+    if (minScale > 1.0f) minScale = 1.0f;
+
+    g_level_count = 0;
+    int samples = 1;
+    while (samples*2 <= maxSamples) samples *= 2;
+    for (; samples > 1 && g_level_count < SCENE_SCALE_MAX_LEVELS; samples /= 2) {
+        g_levels[g_level_count++] = (ScaleLevel){ 1.0f, samples };
+    }
+    g_levels[g_level_count++] = (ScaleLevel){ 1.0f, 1 };
+    for (int step = 9; step > 0 && g_level_count < SCENE_SCALE_MAX_LEVELS; --step) {
+        float scale = step*0.1f;
+        if (scale < minScale - 0.001f) break;
+        g_levels[g_level_count++] = (ScaleLevel){ scale, 1 };
+    }
+    g_level = 0;
+}
+
+void scene_scale_set_target(double targetMs) {
+    if (targetMs > 0.0 && !glext.BlitFramebuffer) {
+        printf("Dynamic resolution: framebuffer blit not supported\n");
+        targetMs = 0.0;
+    }
+    g_target = (targetMs > 0.0) ? targetMs : 0.0;
+    g_measured = 0.0;
+    g_cooldown = 0;
+}
+
+double scene_scale_get_target(void) {
+    return g_target;
+}
+
+static void unload_targets(void) {
+    if (g_msFbo) glext.DeleteFramebuffers(1, &g_msFbo);
+    if (g_msColor) glext.DeleteRenderbuffers(1, &g_msColor);
+    if (g_msDepth) glext.DeleteRenderbuffers(1, &g_msDepth);
+    if (g_fbo) rlUnloadFramebuffer(g_fbo);     // Also deletes a depth attachment
+    if (g_texture) rlUnloadTexture(g_texture);
+    g_msFbo = g_msColor = g_msDepth = 0;
+    g_fbo = g_texture = 0;
+    g_width = g_height = g_samples = 0;
+}
+
+static bool load_multisampled(int width, int height, int samples) {
+    glext.GenRenderbuffers(1, &g_msColor);
+    glext.BindRenderbuffer(GL_RENDERBUFFER, g_msColor);
+    glext.RenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, width, height);
+    glext.GenRenderbuffers(1, &g_msDepth);
+    glext.BindRenderbuffer(GL_RENDERBUFFER, g_msDepth);
+    glext.RenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH_COMPONENT24, width, height);
+    glext.BindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glext.GenFramebuffers(1, &g_msFbo);
+    glext.BindFramebuffer(GL_FRAMEBUFFER, g_msFbo);
+    glext.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, g_msColor);
+    glext.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, g_msDepth);
+    return rlFramebufferComplete(g_msFbo);
+}
+
+static bool ensure_targets(int width, int height, int samples) {
+    if (g_fbo && g_width == width && g_height == height && g_samples == samples) return true;
+    unload_targets();
+
+    g_texture = rlLoadTexture(NULL, width, height, RL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+    rlTextureParameters(g_texture, RL_TEXTURE_MIN_FILTER, RL_TEXTURE_FILTER_LINEAR);
+    rlTextureParameters(g_texture, RL_TEXTURE_MAG_FILTER, RL_TEXTURE_FILTER_LINEAR);
+    g_fbo = rlLoadFramebuffer();
+    rlFramebufferAttach(g_fbo, g_texture, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+    bool ok;
+    if (samples > 1) {
+        ok = rlFramebufferComplete(g_fbo) && load_multisampled(width, height, samples);
+    } else {
+        unsigned int depth = rlLoadTextureDepth(width, height, true);
+        rlFramebufferAttach(g_fbo, depth, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
+        ok = rlFramebufferComplete(g_fbo);
+    }
+    if (!ok) {
+        printf("Error: dynamic resolution target incomplete (%dx%d, %dx MSAA), rendering at full size\n",
+               width, height, samples);
+        unload_targets();
+        g_target = 0.0;
+        return false;
+    }
+    g_width = width;
+    g_height = height;
+    g_samples = samples;
+    return true;
+}
+
+static void update_level(void) {
+    double ms = g_workMs;
+    GpuPassStats gpu = gpu_timer_get_stats(GPU_PASS_SCENE);
+    if (gpu_timer_is_enabled() && gpu.samples > 0) ms = gpu.lastMs;
+    if (ms <= 0.0) return;
+
+    g_measured = (g_measured <= 0.0) ? ms : g_measured + (ms - g_measured)*0.1;
+    if (g_cooldown > 0) {
+        g_cooldown--;
+        return;
+    }
+    int level = g_level;
+    if (g_measured > g_target && g_level < g_level_count - 1) level++;
+    else if (g_measured < g_target*SCENE_SCALE_HEADROOM && g_level > 0) level--;
+    if (level == g_level) return;
+
+    g_level = level;
+    g_measured = 0.0;   // Samples from the old level would drag the average
+    g_cooldown = SCENE_SCALE_COOLDOWN;
+    g_changes++;
+}
+
+void scene_scale_begin(int width, int height) {
+    g_active = false;
+    if (g_target <= 0.0 || g_level_count == 0 || width <= 0 || height <= 0) {
+        g_workMs = 0.0;
+        return;
+    }
+    update_level();
+
+    ScaleLevel level = g_levels[g_level];
+    int scaledWidth = (int)(width*level.scale + 0.5f);
+    int scaledHeight = (int)(height*level.scale + 0.5f);
+    if (scaledWidth < 1) scaledWidth = 1;
+    if (scaledHeight < 1) scaledHeight = 1;
+
+    int previous = 0;
+    glext.GetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);  // Window, pipeline slot or headless target
+    if (!ensure_targets(scaledWidth, scaledHeight, level.samples)) {
+        rlEnableFramebuffer((unsigned int)previous);
+        g_workMs = 0.0;
+        return;
+    }
+    g_output = (unsigned int)previous;
+    g_outWidth = width;
+    g_outHeight = height;
+    rlEnableFramebuffer(g_samples > 1 ? g_msFbo : g_fbo);
+    rlViewport(0, 0, scaledWidth, scaledHeight);
+    g_active = true;
+}
+
+// Full screen quad, opaque, the texture is stored bottom-up
+static void composite(void) {
+    Matrix projection = rlGetMatrixProjection();
+    Matrix modelview = rlGetMatrixModelview();
+
+    rlSetMatrixProjection(MatrixOrtho(0.0, (double)g_outWidth, (double)g_outHeight, 0.0, -1.0, 1.0));
+    rlSetMatrixModelview(MatrixIdentity());
+    rlDisableDepthTest();
+    rlDisableColorBlend();
+
+    rlSetTexture(g_texture);
+    rlBegin(RL_QUADS);
+        rlColor4ub(255, 255, 255, 255);
+        rlTexCoord2f(0.0f, 1.0f); rlVertex2f(0.0f, 0.0f);
+        rlTexCoord2f(0.0f, 0.0f); rlVertex2f(0.0f, (float)g_outHeight);
+        rlTexCoord2f(1.0f, 0.0f); rlVertex2f((float)g_outWidth, (float)g_outHeight);
+        rlTexCoord2f(1.0f, 1.0f); rlVertex2f((float)g_outWidth, 0.0f);
+    rlEnd();
+    rlSetTexture(0);
+    batch_flush();
+
+    rlEnableColorBlend();
+    rlEnableDepthTest();
+    rlSetMatrixProjection(projection);
+    rlSetMatrixModelview(modelview);
+}
+
+void scene_scale_pass_begin(void) {
+    g_workStart = app_clock_real();
+}
+
+void scene_scale_end(void) {
+    if (!g_active) return;
+    g_active = false;
+    batch_flush();      // Pending 3D draws belong to the scaled target
+    g_workMs = (app_clock_real() - g_workStart)*1000.0;
+
+    if (g_samples > 1) {
+        glext.BindFramebuffer(GL_READ_FRAMEBUFFER, g_msFbo);
+        glext.BindFramebuffer(GL_DRAW_FRAMEBUFFER, g_fbo);
+        glext.BlitFramebuffer(0, 0, g_width, g_height, 0, 0, g_width, g_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+    rlEnableFramebuffer(g_output);
+    rlViewport(0, 0, g_outWidth, g_outHeight);
+    composite();
+}
+
+SceneScaleStats scene_scale_get_stats(void) {
+    SceneScaleStats stats = { 0 };
+    stats.enabled = g_target > 0.0;
+    stats.level = g_level;
+    stats.levels = g_level_count;
+    stats.scale = g_level_count ? g_levels[g_level].scale : 1.0f;
+    stats.samples = g_level_count ? g_levels[g_level].samples : 1;
+    stats.width = g_width;
+    stats.height = g_height;
+    stats.targetMs = g_target;
+    stats.measuredMs = g_measured;
+    stats.changes = g_changes;
+    return stats;
+}
+
+void scene_scale_cleanup(void) {
+    unload_targets();
+    g_target = 0.0;
+}
@@ -0,0 +1,206 @@
+// ui_layer.c
+// Both ImGui renderers blend with (SRC_ALPHA, ONE_MINUS_SRC_ALPHA)
+// for color and (ONE, ONE_MINUS_SRC_ALPHA) for alpha, so rendering into a
+// cleared transparent target leaves premultiplied color with correct
+// coverage. The cache is composited with premultiplied alpha blending.
+#include "ui_layer.h"
+#include "module_batch.h"
+#include "app_clock.h"
+#include "idle_mode.h"
+#include "imgui_rlgl.h"
+#include "gl_ext.h"
+#include "hash.h"
+#include "cimgui.h"
+#include <stdio.h>
+#include <string.h>
+#include "rlgl.h"
+#include "raymath.h"
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>         // glfwGetTime()
+
+static bool g_enabled = true;
+static bool g_invalid = true;
+static bool g_pending = false;      // Changed since the last redraw, held back by the rate
+static double g_rate = 0.0;
+static double g_lastRedraw = -1.0;
+static uint64_t g_fingerprint = 0;
+static unsigned int g_fbo = 0;
+static unsigned int g_texture = 0;
+static int g_width = 0;
+static int g_height = 0;
+static UiLayerStats g_stats = { 0 };
+
+void ui_layer_set_enabled(bool enabled) {
+    g_enabled = enabled;
+    g_invalid = true;
+}
+
+bool ui_layer_is_enabled(void) {
+    return g_enabled;
+}
+
+void ui_layer_set_rate(double hz) {
+    g_rate = hz > 0.0 ? hz : 0.0;
+}
+
+double ui_layer_get_rate(void) {
+    return g_rate;
+}
+
+void ui_layer_invalidate(void) {
+    g_invalid = true;
+}
+
+// Everything that changes pixels: geometry, clip rects, textures, callbacks
+uint64_t ui_layer_fingerprint(ImDrawData *drawData) {
+    uint64_t hash = HASH_FNV1A64_BASIS;
+    hash = hash_mix64(&drawData->DisplayPos, sizeof(ImVec2), hash);
+    hash = hash_mix64(&drawData->DisplaySize, sizeof(ImVec2), hash);
+    hash = hash_mix64(&drawData->FramebufferScale, sizeof(ImVec2), hash);
+    for (int n = 0; n < drawData->CmdListsCount; ++n) {
+        const ImDrawList *list = drawData->CmdLists.Data[n];
+        hash = hash_mix64(list->VtxBuffer.Data, (size_t)list->VtxBuffer.Size*sizeof(ImDrawVert), hash);
+        hash = hash_mix64(list->IdxBuffer.Data, (size_t)list->IdxBuffer.Size*sizeof(ImDrawIdx), hash);
+        for (int i = 0; i < list->CmdBuffer.Size; ++i) {
+            const ImDrawCmd *cmd = &list->CmdBuffer.Data[i];
+            struct {
+                ImVec4 clip;
+                const void *texData;
+                ImTextureID texId;
+                const void *callback;
+                unsigned int vtxOffset, idxOffset, elemCount;
+            } key;
+            memset(&key, 0, sizeof(key));   // Padding must hash the same every frame
+            key.clip = cmd->ClipRect;
+            key.texData = cmd->TexRef._TexData;
+            key.texId = cmd->TexRef._TexID;
+            key.callback = (const void *)cmd->UserCallback;
+            key.vtxOffset = cmd->VtxOffset;
+            key.idxOffset = cmd->IdxOffset;
+            key.elemCount = cmd->ElemCount;
+            hash = hash_mix64(&key, sizeof(key), hash);
+        }
+    }
+    return hash;
+}
+
+// Font atlas uploads are handled inside RenderDrawData, they can't be skipped
+static bool textures_pending(ImDrawData *drawData) {
+    if (!drawData->Textures) return false;
+    for (int i = 0; i < drawData->Textures->Size; ++i) {
+        if (drawData->Textures->Data[i]->Status != ImTextureStatus_OK) return true;
+    }
+    return false;
+}
+
+static void unload_target(void) {
+    if (g_fbo) rlUnloadFramebuffer(g_fbo);
+    if (g_texture) rlUnloadTexture(g_texture);
+    g_fbo = 0;
+    g_texture = 0;
+    g_width = 0;
+    g_height = 0;
+}
+
+static bool ensure_target(int width, int height) {
+    if (g_fbo && g_width == width && g_height == height) return true;
+    unload_target();
+    g_texture = rlLoadTexture(NULL, width, height, RL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+    g_fbo = rlLoadFramebuffer();
+    rlFramebufferAttach(g_fbo, g_texture, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+    if (!rlFramebufferComplete(g_fbo)) {
+        printf("Error: UI layer framebuffer incomplete, drawing ImGui directly\n");
+        unload_target();
+        g_enabled = false;
+        return false;
+    }
+    g_width = width;
+    g_height = height;
+    g_invalid = true;
+    return true;
+}
+
+static void redraw_cache(ImDrawData *drawData) {
+    int previous = 0;
+    glext.GetIntegerv(GL_FRAMEBUFFER_BINDING, &previous);  // Headless renders into its own FBO
+
+    static const float transparent[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    rlEnableFramebuffer(g_fbo);
+    glext.ClearBufferfv(GL_COLOR, 0, transparent);
+    imgui_renderer_render(drawData);    // Restores rlgl/GL state itself
+    rlEnableFramebuffer((unsigned int)previous);
+}
+
+// Full screen quad, the texture is stored bottom-up
+static void composite(int width, int height) {
+    Matrix projection = rlGetMatrixProjection();
+    Matrix modelview = rlGetMatrixModelview();
+    batch_flush();
+
+    rlSetMatrixProjection(MatrixOrtho(0.0, (double)width, (double)height, 0.0, -1.0, 1.0));
+    rlSetMatrixModelview(MatrixIdentity());
+    rlDisableDepthTest();
+    rlSetBlendMode(RL_BLEND_ALPHA_PREMULTIPLY);
+
+    rlSetTexture(g_texture);
+    rlBegin(RL_QUADS);
+        rlColor4ub(255, 255, 255, 255);
+        rlTexCoord2f(0.0f, 1.0f); rlVertex2f(0.0f, 0.0f);
+        rlTexCoord2f(0.0f, 0.0f); rlVertex2f(0.0f, (float)height);
+        rlTexCoord2f(1.0f, 0.0f); rlVertex2f((float)width, (float)height);
+        rlTexCoord2f(1.0f, 1.0f); rlVertex2f((float)width, 0.0f);
+    rlEnd();
+    rlSetTexture(0);
+    batch_flush();
+
+    rlSetBlendMode(RL_BLEND_ALPHA);
+    rlEnableDepthTest();
+    rlSetMatrixProjection(projection);
+    rlSetMatrixModelview(modelview);
+}
+
+void ui_layer_render(ImDrawData *drawData, int width, int height) {
+    if (!drawData) return;
+    if (!g_enabled || width <= 0 || height <= 0 || !glext.ClearBufferfv || !ensure_target(width, height)) {
+        imgui_renderer_render(drawData);
+        return;
+    }
+
+    double start = glfwGetTime();
+    uint64_t fingerprint = ui_layer_fingerprint(drawData);
+    g_stats.hashMs = (glfwGetTime() - start)*1000.0;
+
+    if (fingerprint != g_fingerprint) g_pending = true;
+    g_fingerprint = fingerprint;
+
+    // Texture uploads happen inside RenderDrawData and can't wait for the next slot
+    bool redraw = g_invalid || textures_pending(drawData);
+    if (!redraw && g_pending) {
+        double now = app_clock_now();
+        double next = g_lastRedraw + (g_rate > 0.0 ? 1.0/g_rate : 0.0);
+        if (g_lastRedraw < 0.0 || now >= next) {
+            redraw = true;
+        } else {
+            g_stats.deferred++;
+            idle_animate_for(next - now);   // Idle loop must wake up for the held back change
+        }
+    }
+    if (redraw) {
+        redraw_cache(drawData);
+        g_invalid = false;
+        g_pending = false;
+        g_lastRedraw = app_clock_now();
+        g_stats.redraws++;
+    }
+    g_stats.cached = !redraw;
+    g_stats.frames++;
+    composite(width, height);
+}
+
+UiLayerStats ui_layer_get_stats(void) {
+    return g_stats;
+}
+
+void ui_layer_cleanup(void) {
+    unload_target();
+}